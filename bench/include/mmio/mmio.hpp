@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only subset of mmio::mapped_file_source used by ConfigReader and the config cache, built on mmap
+namespace mmio {
+	class mapped_file_source {
+	public:
+		mapped_file_source() noexcept = default;
+		mapped_file_source(const mapped_file_source&) = delete;
+		mapped_file_source& operator=(const mapped_file_source&) = delete;
+		~mapped_file_source() { close(); }
+
+		bool open(const std::filesystem::path& a_path) {
+			close();
+
+			int fd = ::open(a_path.c_str(), O_RDONLY);
+			if (fd == -1) {
+				return false;
+			}
+
+			struct stat st{};
+			if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+				void* mapping = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+				if (mapping != MAP_FAILED) {
+					_data = static_cast<const std::byte*>(mapping);
+					_size = static_cast<std::size_t>(st.st_size);
+				}
+			}
+
+			::close(fd);
+			return is_open();
+		}
+
+		void close() noexcept {
+			if (_data) {
+				::munmap(const_cast<std::byte*>(_data), _size);
+				_data = nullptr;
+				_size = 0;
+			}
+		}
+
+		bool is_open() const noexcept { return _data != nullptr; }
+		const std::byte* data() const noexcept { return _data; }
+		std::size_t size() const noexcept { return _size; }
+
+	private:
+		const std::byte* _data = nullptr;
+		std::size_t _size = 0;
+	};
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+#include "Parsers.h"
+
+namespace Bench {
+	// Every record type shares the statement shape Filter(Form).Element = Values; or Filter(Form).Element.Op(Args)...;
+	// so one stand-in parser covers the corpora of all of them. It measures what every record type shares: the reader,
+	// the Parsers::Parser base with its conditions, the arena and the statement echo. The record type parsers themselves,
+	// such as NPCParser or LeveledListParser, are not built here and their grammars are not measured. Values are kept in
+	// std::any like most of them; NPC and ObjectModification use std::variant.
+	struct ConfigData {
+		struct Operation {
+			std::string Name;
+			std::vector<std::any> Args;
+		};
+
+		std::string Filter;
+		Utils::FormReference FilterForm;
+		std::string Element;
+		std::vector<std::any> AssignValues;
+		Arenas::Vector<Operation> Operations;
+	};
+
+	class BenchParser : public Parsers::Parser<ConfigData> {
+	public:
+		BenchParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		BenchParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
+
+	protected:
+		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
+			if (reader.EndOfFile() || reader.Peek().empty()) {
+				return std::nullopt;
+			}
+
+			ConfigData configData{};
+
+			auto token = reader.GetToken();
+			if (reader.GetLastSymbol() != Symbol::kFilterByFormID && reader.GetLastSymbol() != Symbol::kFilterByCategoryKeyword) {
+				logger::warn("Line {}, Col {}: Invalid FilterName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
+				return std::nullopt;
+			}
+
+			configData.Filter = token;
+
+			token = reader.GetToken();
+			if (token != "(") {
+				logger::warn("Line {}, Col {}: Syntax error. Expected '('.", reader.GetLastLine(), reader.GetLastLineIndex());
+				return std::nullopt;
+			}
+
+			auto filterForm = ParseForm();
+			if (!filterForm.has_value()) {
+				return std::nullopt;
+			}
+
+			configData.FilterForm = filterForm.value();
+
+			token = reader.GetToken();
+			if (token != ")") {
+				logger::warn("Line {}, Col {}: Syntax error. Expected ')'.", reader.GetLastLine(), reader.GetLastLineIndex());
+				return std::nullopt;
+			}
+
+			token = reader.GetToken();
+			if (token != ".") {
+				logger::warn("Line {}, Col {}: Syntax error. Expected '.'.", reader.GetLastLine(), reader.GetLastLineIndex());
+				return std::nullopt;
+			}
+
+			token = reader.GetToken();
+			if (reader.GetLastSymbol() == Symbol::kUnknown) {
+				logger::warn("Line {}, Col {}: Invalid ElementName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
+				return std::nullopt;
+			}
+
+			configData.Element = token;
+
+			if (reader.Peek() == "=") {
+				reader.GetToken();
+
+				if (!ParseValues(configData.AssignValues, "|")) {
+					return std::nullopt;
+				}
+			}
+			else {
+				while (true) {
+					token = reader.GetToken();
+					if (token != ".") {
+						logger::warn("Line {}, Col {}: Syntax error. Expected '.'.", reader.GetLastLine(), reader.GetLastLineIndex());
+						return std::nullopt;
+					}
+
+					if (!ParseOperation(configData)) {
+						return std::nullopt;
+					}
+
+					if (reader.Peek() == ";") {
+						break;
+					}
+				}
+			}
+
+			token = reader.GetToken();
+			if (token != ";") {
+				logger::warn("Line {}, Col {}: Syntax error. Expected ';'.", reader.GetLastLine(), reader.GetLastLineIndex());
+				return std::nullopt;
+			}
+
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
+		}
+
+		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
+			std::string indent = std::string(a_indent * 4, ' ');
+
+			if (a_configData.Operations.empty()) {
+				logger::info("{}{}({}).{} = {};", indent, a_configData.Filter, a_configData.FilterForm, a_configData.Element, ValuesToString(a_configData.AssignValues));
+				return;
+			}
+
+			logger::info("{}{}({}).{}", indent, a_configData.Filter, a_configData.FilterForm, a_configData.Element);
+			for (std::size_t ii = 0; ii < a_configData.Operations.size(); ii++) {
+				std::string opLog = fmt::format(".{}({})", a_configData.Operations[ii].Name, ValuesToString(a_configData.Operations[ii].Args));
+
+				if (ii == a_configData.Operations.size() - 1) {
+					opLog += ";";
+				}
+
+				logger::info("{}    {}", indent, opLog);
+			}
+		}
+
+		bool ParseOperation(ConfigData& a_configData) {
+			ConfigData::Operation newOp;
+
+			auto token = reader.GetToken();
+			if (reader.GetLastSymbol() == Symbol::kUnknown) {
+				logger::warn("Line {}, Col {}: Invalid OperationName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
+				return false;
+			}
+
+			newOp.Name = token;
+
+			token = reader.GetToken();
+			if (token != "(") {
+				logger::warn("Line {}, Col {}: Syntax error. Expected '('.", reader.GetLastLine(), reader.GetLastLineIndex());
+				return false;
+			}
+
+			if (reader.Peek() != ")" && !ParseValues(newOp.Args, ",")) {
+				return false;
+			}
+
+			token = reader.GetToken();
+			if (token != ")") {
+				logger::warn("Line {}, Col {}: Syntax error. Expected ')'.", reader.GetLastLine(), reader.GetLastLineIndex());
+				return false;
+			}
+
+			a_configData.Operations.push_back(std::move(newOp));
+
+			return true;
+		}
+
+		// Parses a_separator separated forms, strings, numbers and names
+		bool ParseValues(std::vector<std::any>& a_values, std::string_view a_separator) {
+			while (true) {
+				auto token = reader.Peek();
+				if (token.empty()) {
+					logger::warn("Line {}, Col {}: Expected value.", reader.GetLastLine(), reader.GetLastLineIndex());
+					return false;
+				}
+
+				if (token.starts_with('\"')) {
+					token = reader.GetToken();
+					if (!token.ends_with('\"')) {
+						logger::warn("Line {}, Col {}: String must end with '\"'.", reader.GetLastLine(), reader.GetLastLineIndex());
+						return false;
+					}
+
+					std::string_view value = token.substr(1, token.length() - 2);
+
+					// A string followed by '|' is the plugin name of a form
+					if (reader.Peek() == "|") {
+						auto separator = reader.GetToken();
+
+						token = reader.GetToken();
+						if (!IsHexString(token)) {
+							logger::warn("Line {}, Col {}: Expected FormID '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
+							return false;
+						}
+
+						value = Arenas::StoreString({ value, separator, token });
+					}
+
+					a_values.push_back(std::any(value));
+				}
+				else if (std::isdigit(static_cast<unsigned char>(token[0])) || token[0] == '-') {
+					auto value = ParseNumber();
+					if (!value.has_value()) {
+						return false;
+					}
+
+					a_values.push_back(std::any(value.value()));
+				}
+				else {
+					a_values.push_back(std::any(reader.GetToken()));
+				}
+
+				if (reader.Peek() != a_separator) {
+					return true;
+				}
+
+				reader.GetToken();
+			}
+		}
+
+		static std::string ValuesToString(const std::vector<std::any>& a_values) {
+			std::string retStr;
+
+			for (const auto& value : a_values) {
+				if (!retStr.empty()) {
+					retStr += ", ";
+				}
+
+				if (const auto* number = std::any_cast<float>(&value)) {
+					retStr += fmt::format("{}", *number);
+				}
+				else {
+					retStr += std::any_cast<std::string_view>(value);
+				}
+			}
+
+			return retStr;
+		}
+	};
+}
@@ -0,0 +1,263 @@
+#include "Corpus.h"
+
+#include <fstream>
+
+namespace Corpus {
+	namespace {
+		constexpr std::array Plugins{ "Fallout4.esm"sv, "DLCRobot.esm"sv, "DLCCoast.esm"sv, "BenchPatch.esl"sv, "NotLoaded.esp"sv };
+
+		// Statements are grouped into blocks of this size, each wrapped in conditionals when nesting is enabled
+		constexpr std::size_t BlockSize = 12;
+
+		class Generator {
+		public:
+			Generator(const Grammar& a_grammar, const Options& a_options) :
+				_grammar(a_grammar), _options(a_options), _random(a_options.Seed) {}
+
+			std::string Generate() {
+				_output += fmt::format("# Synthetic {} config: {} statements, nesting depth {}, seed {}\n\n",
+					_grammar.TypeName, _options.Statements, _options.NestingDepth, _options.Seed);
+
+				std::size_t remaining = _options.Statements;
+				while (remaining > 0) {
+					std::size_t count = std::min(remaining, BlockSize);
+					WriteBlock(count, _options.NestingDepth, 0);
+					remaining -= count;
+
+					_output += '\n';
+				}
+
+				return std::move(_output);
+			}
+
+		private:
+			// Writes a_count statements, split across the branches of an if / else if / else chain while a_depth allows
+			void WriteBlock(std::size_t a_count, std::size_t a_depth, std::size_t a_indent) {
+				if (a_depth == 0 || a_count < 3) {
+					for (std::size_t ii = 0; ii < a_count; ii++) {
+						WriteStatement(a_indent);
+					}
+					return;
+				}
+
+				std::string indent(a_indent, '\t');
+
+				std::size_t branchCount = a_count / 3;
+				std::size_t elseCount = a_count - branchCount * 2;
+
+				_output += fmt::format("{}if ({}) {{\n", indent, MakeCondition());
+				WriteBlock(branchCount, a_depth - 1, a_indent + 1);
+				_output += fmt::format("{}}}\n{}else if ({}) {{\n", indent, indent, MakeCondition());
+				WriteBlock(branchCount, a_depth - 1, a_indent + 1);
+				_output += fmt::format("{}}}\n{}else {{\n", indent, indent);
+				WriteBlock(elseCount, a_depth - 1, a_indent + 1);
+				_output += fmt::format("{}}}\n", indent);
+			}
+
+			void WriteStatement(std::size_t a_indent) {
+				_output.append(a_indent, '\t');
+
+				std::string_view statement = _grammar.Templates[Next(_grammar.Templates.size())];
+				while (!statement.empty()) {
+					auto open = statement.find('{');
+					if (open == std::string_view::npos) {
+						_output += statement;
+						break;
+					}
+
+					auto close = statement.find('}', open);
+					_output += statement.substr(0, open);
+					_output += MakeValue(statement.substr(open + 1, close - open - 1));
+					statement.remove_prefix(close + 1);
+				}
+
+				// An occasional trailing comment keeps the comment path of the lexer warm
+				if (Next(8) == 0) {
+					_output += "  # generated";
+				}
+
+				_output += '\n';
+			}
+
+			std::string MakeValue(std::string_view a_placeholder) {
+				if (a_placeholder == "form") {
+					return MakeForm();
+				}
+				else if (a_placeholder == "string") {
+					return fmt::format("\"Bench Name {}\"", Next(100000));
+				}
+				else if (a_placeholder == "int") {
+					return fmt::format("{}", Next(1000));
+				}
+				else if (a_placeholder == "float") {
+					return fmt::format("{}.{}", Next(100), Next(100));
+				}
+				else if (a_placeholder == "slot") {
+					return fmt::format("{}", 30 + Next(32));
+				}
+
+				return std::string(a_placeholder);
+			}
+
+			std::string MakeForm() {
+				return fmt::format("\"{}\"|0x{:X}", Plugins[Next(Plugins.size())], 0x800 + Next(0x100000));
+			}
+
+			std::string MakeCondition() {
+				std::string condition;
+
+				std::size_t termCount = 1 + Next(3);
+				for (std::size_t ii = 0; ii < termCount; ii++) {
+					if (ii > 0) {
+						condition += Next(2) == 0 ? " && " : " || ";
+					}
+
+					if (Next(4) == 0) {
+						condition += '!';
+					}
+
+					if (Next(2) == 0) {
+						condition += fmt::format("IsPluginExists(\"{}\")", Plugins[Next(Plugins.size())]);
+					}
+					else {
+						condition += fmt::format("IsFormExists({})", MakeForm());
+					}
+				}
+
+				return condition;
+			}
+
+			std::size_t Next(std::size_t a_bound) {
+				return std::uniform_int_distribution<std::size_t>(0, a_bound - 1)(_random);
+			}
+
+			const Grammar& _grammar;
+			const Options& _options;
+			std::mt19937 _random;
+			std::string _output;
+		};
+	}
+
+	const std::vector<Grammar>& GetGrammars() {
+		static const std::vector<Grammar> grammars{
+			{ "ArmorAddon", {
+				"FilterByFormID({form}).BipedObjectSlots = {slot} | {slot} | {slot};",
+			} },
+			{ "Armor", {
+				"FilterByFormID({form}).ArmorRating = {int};",
+				"FilterByFormID({form}).FullName = {string};",
+				"FilterByFormID({form}).ObjectEffect = null;",
+				"FilterByFormID({form}).Keywords.Clear().Add({form}).Delete({form});",
+				"FilterByFormID({form}).Resistances.Add({form}, {int}).Delete({form});",
+			} },
+			{ "Cell", {
+				"FilterByFormID({form}).FullName = {string};",
+			} },
+			{ "ConstructibleObject", {
+				"FilterByFormID({form}).Components.Clear().Add({form}, {int}).Add({form}, {int});",
+				"FilterByFormID({form}).CreatedObject = {form};",
+				"FilterByFormID({form}).CreatedObjectCount = {int};",
+				"FilterByCategoryKeyword({form}).Categories.Add({form}).Delete({form});",
+				"FilterByCategoryKeyword({form}).WorkbenchKeyword = null;",
+			} },
+			{ "DefaultObjectManager", {
+				"FilterByFormID({form}).Objects.Set(ActionActivate, {form}).Set(ActionIdle, null);",
+			} },
+			{ "FormList", {
+				"FilterByFormID({form}).List.Clear().Add({form}).AddIfNotExists({form}).Delete({form});",
+			} },
+			{ "Ingestible", {
+				"FilterByFormID({form}).Effects.Clear().Add({form}, {float}, {int}, {int}).Delete({form});",
+			} },
+			{ "Keyword", {
+				"FilterByFormID({form}).FullName = {string};",
+			} },
+			{ "LeveledList", {
+				"FilterByFormID({form}).ChanceNone = {int};",
+				"FilterByFormID({form}).MaxCount = {int};",
+				"FilterByFormID({form}).Entries.Clear().Add({int}, {form}, {int}, {int}).DeleteAll({form});",
+			} },
+			{ "Location", {
+				"FilterByFormID({form}).FullName = {string};",
+				"FilterByFormID({form}).Keywords.Add({form}).AddIfNotExists({form}).Delete({form});",
+			} },
+			{ "MusicType", {
+				"FilterByFormID({form}).Ducking = {float};",
+				"FilterByFormID({form}).FadeDuration = {float};",
+				"FilterByFormID({form}).Flags = PlaysOneSelection | CycleTracks | DoesNotQueue;",
+				"FilterByFormID({form}).Priority = {int};",
+				"FilterByFormID({form}).MusicTracks.Clear().Add({form}).Delete({form});",
+			} },
+			{ "NPC", {
+				"FilterByFormID({form}).Class = {form};",
+				"FilterByFormID({form}).FullName = {string};",
+				"FilterByFormID({form}).HeightMin = {float};",
+				"FilterByFormID({form}).IsChargenFacePreset = true;",
+				"FilterByFormID({form}).Race = null;",
+				"FilterByFormID({form}).Sex = 1;",
+				"FilterByFormID({form}).HeadParts.Clear().Add({form}).Delete({form});",
+				"FilterByFormID({form}).Morphs.Clear().Set({int}, {float}).Delete({int});",
+				"FilterByFormID({form}).Tints.Set({int}, {int}, {int}, {int}, {int}).Delete({int});",
+			} },
+			{ "ObjectModification", {
+				"FilterByFormID({form}).Properties.Clear().Add(Float, MULADD, Speed, {float}, {float});",
+				"FilterByFormID({form}).Properties.Add(Int, SET, AmmoCapacity, {int}, 0).Add(Bool, OR, IsAutomatic, true, false);",
+				"FilterByFormID({form}).Properties.Add(FormIDInt, ADD, Keywords, {form}).Add(FormIDFloat, SET, DamageTypeValues, {form}, {float});",
+			} },
+			{ "Outfit", {
+				"FilterByFormID({form}).Items.Clear().Add({form}).Delete({form});",
+			} },
+			{ "Quest", {
+				"FilterByFormID({form}).FullName = {string};",
+			} },
+			{ "Race", {
+				"FilterByFormID({form}).MaleSkeletalModel = {string};",
+				"FilterByFormID({form}).BodyPartData = {form};",
+				"FilterByFormID({form}).BipedObjectSlots = {slot} | {slot};",
+				"FilterByFormID({form}).Properties.Set({form}, {float}).Add({form}, {float}).Delete({form});",
+				"FilterByFormID({form}).MalePresets.Clear().AddIfNotExists({form});",
+			} },
+			{ "Weapon", {
+				"FilterByFormID({form}).Ammo = {form};",
+				"FilterByFormID({form}).Speed = {float};",
+				"FilterByFormID({form}).Reach = {float};",
+				"FilterByFormID({form}).ObjectEffect = null;",
+			} },
+			{ "Worldspace", {
+				"FilterByFormID({form}).FullName = {string};",
+			} },
+		};
+
+		return grammars;
+	}
+
+	std::string Generate(const Grammar& a_grammar, const Options& a_options) {
+		return Generator(a_grammar, a_options).Generate();
+	}
+
+	bool Write(const std::filesystem::path& a_root, const Options& a_options) {
+		for (const auto& grammar : GetGrammars()) {
+			std::error_code ec;
+			auto directory = a_root / grammar.TypeName;
+			std::filesystem::create_directories(directory, ec);
+			if (ec) {
+				logger::error("Cannot create the directory: {}", directory.string());
+				return false;
+			}
+
+			auto path = directory / "Bench.cfg";
+			std::ofstream configFile(path, std::ios::binary | std::ios::trunc);
+			if (!configFile.is_open()) {
+				logger::error("Cannot write the config file: {}", path.string());
+				return false;
+			}
+
+			std::string contents = Generate(grammar, a_options);
+			configFile.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+			logger::info("Wrote {} ({:.2f} MB)", path.string(), static_cast<double>(contents.size()) / (1024.0 * 1024.0));
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+namespace Corpus {
+	struct Options {
+		std::size_t Statements = 10000;   // Expression statements written per record type
+		std::size_t NestingDepth = 2;     // Deepest if / else if / else nesting; 0 writes no conditional blocks
+		std::uint32_t Seed = 1;
+	};
+
+	// Statement templates of one record type. Placeholders: {form}, {string}, {int}, {float}, {slot}
+	struct Grammar {
+		std::string_view TypeName;
+		std::vector<std::string_view> Templates;
+	};
+
+	const std::vector<Grammar>& GetGrammars();
+
+	// Returns the contents of a config file of a_grammar holding exactly a_options.Statements expression statements
+	std::string Generate(const Grammar& a_grammar, const Options& a_options);
+
+	// Writes one config per record type into a_root\<TypeName>\Bench.cfg, the layout of Data\TullPatcherF4
+	bool Write(const std::filesystem::path& a_root, const Options& a_options);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+// Just enough of CommonLibF4 for src/Utils.cpp to build unchanged. The data handler answers from a fixed load order,
+// so condition evaluation and form lookups do the same work on every run.
+namespace RE {
+	class TESFile {
+	public:
+		bool IsActive() const { return true; }
+		bool IsLight() const { return light; }
+
+		const char* filename = "";
+		bool light = false;
+		std::uint8_t compileIndex = 0xFF;
+		std::uint16_t smallFileCompileIndex = 0;
+	};
+
+	class TESForm {
+	public:
+		struct SourceFiles {
+			std::vector<TESFile*>* array = nullptr;
+		};
+
+		// Every fourth form ID is treated as missing, so that IsFormExists takes both branches
+		static TESForm* GetFormByID(std::uint32_t a_formID);
+
+		static TESForm* GetFormByEditorID(std::string_view a_editorID);
+
+		const char* GetFormEditorID() const { return editorID; }
+
+		SourceFiles sourceFiles;
+		std::uint32_t formID = 0;
+		const char* editorID = "";
+	};
+
+	struct TESFileCollection {
+		std::vector<TESFile*> files;
+		std::vector<TESFile*> smallFiles;
+	};
+
+	class TESDataHandler {
+	public:
+		static TESDataHandler* GetSingleton() {
+			static TESDataHandler singleton;
+			return &singleton;
+		}
+
+		const TESFile* LookupModByName(std::string_view a_name) const {
+			for (const auto& file : _files) {
+				if (a_name == file.filename) {
+					return &file;
+				}
+			}
+
+			return nullptr;
+		}
+
+		TESForm* LookupForm(std::uint32_t a_formID, std::string_view a_name) const {
+			const TESFile* file = LookupModByName(a_name);
+			if (!file) {
+				return nullptr;
+			}
+
+			if (file->light) {
+				return TESForm::GetFormByID(0xFE000000 | (file->smallFileCompileIndex << 12) | (a_formID & 0xFFF));
+			}
+
+			return TESForm::GetFormByID((file->compileIndex << 24) | (a_formID & 0xFFFFFF));
+		}
+
+		TESFileCollection compiledFileCollection;
+		std::array<std::vector<TESForm*>, 1> formArrays;
+
+	private:
+		TESDataHandler() {
+			for (auto& file : _files) {
+				(file.light ? compiledFileCollection.smallFiles : compiledFileCollection.files).push_back(&file);
+			}
+
+			for (auto& form : _forms) {
+				formArrays[0].push_back(&form);
+			}
+		}
+
+		std::array<TESFile, 4> _files{ {
+			{ "Fallout4.esm", false, 0x00 },
+			{ "DLCRobot.esm", false, 0x01 },
+			{ "DLCCoast.esm", false, 0x02 },
+			{ "BenchPatch.esl", true, 0xFE, 0x000 },
+		} };
+		std::array<TESForm, 2> _forms{ {
+			{ {}, 0x00000801, "BenchArmor" },
+			{ {}, 0xFE000802, "BenchPatchArmor" },
+		} };
+	};
+
+	inline TESForm* TESForm::GetFormByID(std::uint32_t a_formID) {
+		for (TESForm* form : TESDataHandler::GetSingleton()->formArrays[0]) {
+			if (form->formID == a_formID) {
+				return form;
+			}
+		}
+
+		static TESForm form;
+		return a_formID % 4 == 0 ? nullptr : &form;
+	}
+
+	inline TESForm* TESForm::GetFormByEditorID(std::string_view a_editorID) {
+		for (TESForm* form : TESDataHandler::GetSingleton()->formArrays[0]) {
+			if (a_editorID == form->editorID) {
+				return form;
+			}
+		}
+
+		return nullptr;
+	}
+}
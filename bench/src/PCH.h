@@ -0,0 +1,36 @@
+#pragma once
+
+// Stands in for src/PCH.h: the standard library and logging the parsing sources expect, without CommonLibF4
+
+#include <algorithm>
+#include <any>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <stack>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <mmio/mmio.hpp>
+
+#include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/sinks/sink.h>
+#include <spdlog/spdlog.h>
+
+#include "FakeRE.h"
+
+namespace logger = spdlog;
+
+using namespace std::literals;
@@ -0,0 +1,365 @@
+#include "BenchParser.h"
+#include "Corpus.h"
+
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/null_sink.h>
+
+namespace {
+	std::atomic<std::size_t> g_allocationCount = 0;
+}
+
+// Counts every heap allocation so the parse phase can report allocations per statement
+void* operator new(std::size_t a_size) {
+	g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* ptr = std::malloc(a_size == 0 ? 1 : a_size)) {
+		return ptr;
+	}
+
+	throw std::bad_alloc();
+}
+
+// GCC sees std::free called on memory it tracked from operator new once the replacements are inlined, though both ends
+// of the pair are replaced here
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* a_ptr) noexcept {
+	std::free(a_ptr);
+}
+
+void operator delete(void* a_ptr, std::size_t) noexcept {
+	std::free(a_ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	struct Result {
+		std::string TypeName;
+		std::size_t Bytes = 0;
+		std::size_t Tokens = 0;
+		std::size_t Statements = 0;
+		std::size_t Allocations = 0;
+		double LexSeconds = std::numeric_limits<double>::max();
+		double ParseSeconds = std::numeric_limits<double>::max();
+		double EvaluateSeconds = std::numeric_limits<double>::max();
+	};
+
+	double SecondsSince(Clock::time_point a_start) {
+		return std::chrono::duration<double>(Clock::now() - a_start).count();
+	}
+
+	template <typename StatementsT>
+	std::size_t CountExpressionStatements(const StatementsT& a_statements) {
+		std::size_t count = 0;
+
+		for (const auto& statement : a_statements) {
+			if (statement.Type == Parsers::StatementType::kExpression) {
+				count++;
+			}
+			else if (statement.Type == Parsers::StatementType::kConditional) {
+				const auto& conditionalStatement = statement.ConditionalStatement.value();
+
+				count += CountExpressionStatements(conditionalStatement.IfStatements.second);
+				for (const auto& elseIfStatement : conditionalStatement.ElseIfStatements) {
+					count += CountExpressionStatements(elseIfStatement.second);
+				}
+				count += CountExpressionStatements(conditionalStatement.ElseStatements);
+			}
+		}
+
+		return count;
+	}
+
+	// Walks the taken branches, as ConfigUtils::Prepare does, and returns the number of statements reached
+	template <typename StatementsT>
+	std::size_t EvaluateStatements(const StatementsT& a_statements) {
+		std::size_t count = 0;
+
+		for (const auto& statement : a_statements) {
+			if (statement.Type == Parsers::StatementType::kExpression) {
+				count++;
+			}
+			else if (statement.Type == Parsers::StatementType::kConditional) {
+				count += EvaluateStatements(statement.ConditionalStatement->Evaluates());
+			}
+		}
+
+		return count;
+	}
+
+	std::optional<Result> RunFile(std::string_view a_typeName, const std::filesystem::path& a_path, std::size_t a_iterations) {
+		Result result;
+		result.TypeName = a_typeName;
+		result.Bytes = std::filesystem::file_size(a_path);
+
+		std::string path = a_path.string();
+
+		for (std::size_t ii = 0; ii < a_iterations; ii++) {
+			auto start = Clock::now();
+
+			Configs::ConfigReader reader(path);
+			std::size_t tokens = 0;
+			while (!reader.EndOfFile()) {
+				if (reader.GetToken().empty()) {
+					break;
+				}
+				tokens++;
+			}
+
+			result.LexSeconds = std::min(result.LexSeconds, SecondsSince(start));
+			result.Tokens = tokens;
+		}
+
+		// The arena is released only after the statements parsed from it are destroyed, as the record types do after Patch()
+		Arenas::Arena arena;
+		std::vector<Parsers::Statement<Bench::ConfigData>> statements;
+
+		for (std::size_t ii = 0; ii < a_iterations; ii++) {
+			statements.clear();
+			statements.shrink_to_fit();
+			arena.Release();
+
+			std::size_t allocationsBefore = g_allocationCount.load(std::memory_order_relaxed);
+			auto start = Clock::now();
+
+			{
+				Arenas::ScopedArena arenaScope(arena);
+
+				Bench::BenchParser parser(path);
+				statements = parser.Parse();
+			}
+
+			result.ParseSeconds = std::min(result.ParseSeconds, SecondsSince(start));
+			result.Allocations = g_allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+		}
+
+		result.Statements = CountExpressionStatements(statements);
+		if (result.Statements == 0) {
+			logger::error("No statement was parsed from {}", path);
+			return std::nullopt;
+		}
+
+		for (std::size_t ii = 0; ii < a_iterations; ii++) {
+			auto start = Clock::now();
+
+			volatile std::size_t reached = EvaluateStatements(statements);
+			(void)reached;
+
+			result.EvaluateSeconds = std::min(result.EvaluateSeconds, SecondsSince(start));
+		}
+
+		return result;
+	}
+
+	void PrintResults(const std::vector<Result>& a_results) {
+		constexpr double MB = 1024.0 * 1024.0;
+
+		std::printf("%-22s %10s %10s %10s %12s %12s %10s %12s\n",
+			"Type", "MB", "Statements", "Lex MB/s", "Parse MB/s", "Parse st/s", "Alloc/st", "Eval ns/st");
+
+		Result total;
+		total.TypeName = "Total";
+		total.LexSeconds = 0.0;
+		total.ParseSeconds = 0.0;
+		total.EvaluateSeconds = 0.0;
+
+		auto printRow = [MB](const Result& a_result) {
+			auto statements = static_cast<double>(a_result.Statements);
+			auto megabytes = static_cast<double>(a_result.Bytes) / MB;
+
+			std::printf("%-22s %10.2f %10zu %10.1f %12.1f %12.0f %10.2f %12.1f\n",
+				a_result.TypeName.c_str(),
+				megabytes,
+				a_result.Statements,
+				megabytes / a_result.LexSeconds,
+				megabytes / a_result.ParseSeconds,
+				statements / a_result.ParseSeconds,
+				static_cast<double>(a_result.Allocations) / statements,
+				a_result.EvaluateSeconds * 1e9 / statements);
+		};
+
+		for (const auto& result : a_results) {
+			printRow(result);
+
+			total.Bytes += result.Bytes;
+			total.Tokens += result.Tokens;
+			total.Statements += result.Statements;
+			total.Allocations += result.Allocations;
+			total.LexSeconds += result.LexSeconds;
+			total.ParseSeconds += result.ParseSeconds;
+			total.EvaluateSeconds += result.EvaluateSeconds;
+		}
+
+		if (a_results.size() > 1) {
+			printRow(total);
+		}
+	}
+
+	bool Run(const std::filesystem::path& a_root, std::size_t a_iterations) {
+		std::error_code ec;
+		if (!std::filesystem::is_directory(a_root, ec)) {
+			logger::error("Cannot find the corpus directory: {}", a_root.string());
+			return false;
+		}
+
+		std::vector<std::pair<std::string, std::filesystem::path>> configPaths;
+		for (const auto& typeEntry : std::filesystem::directory_iterator(a_root, ec)) {
+			if (!typeEntry.is_directory()) {
+				continue;
+			}
+
+			for (const auto& fileEntry : std::filesystem::directory_iterator(typeEntry.path(), ec)) {
+				if (fileEntry.is_regular_file() && fileEntry.path().extension() == ".cfg") {
+					configPaths.emplace_back(typeEntry.path().filename().string(), fileEntry.path());
+				}
+			}
+		}
+
+		if (configPaths.empty()) {
+			logger::error("No config file was found under {}", a_root.string());
+			return false;
+		}
+
+		std::sort(configPaths.begin(), configPaths.end());
+
+		std::vector<Result> results;
+		for (const auto& [typeName, path] : configPaths) {
+			auto result = RunFile(typeName, path, a_iterations);
+			if (!result.has_value()) {
+				return false;
+			}
+
+			results.push_back(std::move(result.value()));
+		}
+
+		PrintResults(results);
+
+		return true;
+	}
+
+	void PrintUsage() {
+		std::printf(
+			"Usage:\n"
+			"  TullPatcherF4Bench generate <dir> [--statements N] [--nesting D] [--seed S]\n"
+			"  TullPatcherF4Bench run <dir> [--iterations N] [--log <file>] [--echo log|none]\n"
+			"\n"
+			"generate writes one config per record type into <dir>\\<Type>\\Bench.cfg.\n"
+			"run lexes, parses and evaluates every config under <dir> and reports the best of N iterations.\n"
+			"Every type is parsed by one generic stand-in parser, so the record type parsers are not measured.\n"
+			"Parse output goes to a null sink unless --log is given, so formatting is measured but file I/O is not.\n"
+			"--echo none skips echoing parsed statements, as the Statements = None setting does.\n");
+	}
+
+	std::optional<std::size_t> ParseCount(std::string_view a_arg) {
+		std::size_t value = 0;
+		auto [ptr, ec] = std::from_chars(a_arg.data(), a_arg.data() + a_arg.size(), value);
+		if (ec != std::errc() || ptr != a_arg.data() + a_arg.size()) {
+			logger::error("Invalid number: {}", a_arg);
+			return std::nullopt;
+		}
+
+		return value;
+	}
+}
+
+int main(int a_argc, char* a_argv[]) {
+	std::vector<std::string_view> args(a_argv + 1, a_argv + a_argc);
+	if (args.size() < 2) {
+		PrintUsage();
+		return 1;
+	}
+
+	std::string_view command = args[0];
+	std::filesystem::path root(args[1]);
+
+	Corpus::Options options;
+	std::size_t iterations = 5;
+	std::string logPath;
+
+	for (std::size_t ii = 2; ii < args.size(); ii++) {
+		std::string_view arg = args[ii];
+		if (ii + 1 >= args.size()) {
+			PrintUsage();
+			return 1;
+		}
+
+		std::string_view value = args[++ii];
+
+		if (arg == "--log") {
+			logPath = value;
+			continue;
+		}
+		else if (arg == "--echo") {
+			if (value == "none") {
+				Logs::SetStatementLog(Logs::StatementLog::kNone);
+			}
+			else if (value != "log") {
+				PrintUsage();
+				return 1;
+			}
+			continue;
+		}
+
+		auto count = ParseCount(value);
+		if (!count.has_value()) {
+			return 1;
+		}
+
+		if (arg == "--statements") {
+			options.Statements = count.value();
+		}
+		else if (arg == "--nesting") {
+			options.NestingDepth = count.value();
+		}
+		else if (arg == "--seed") {
+			options.Seed = static_cast<std::uint32_t>(count.value());
+		}
+		else if (arg == "--iterations") {
+			iterations = std::max<std::size_t>(count.value(), 1);
+		}
+		else {
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (command == "generate") {
+		return Corpus::Write(root, options) ? 0 : 1;
+	}
+	else if (command == "run") {
+		// The fake load order is fixed from the start, so plugins are mapped before any config is parsed
+		Utils::BindPlugins();
+
+		auto console = spdlog::default_logger();
+
+		std::shared_ptr<spdlog::sinks::sink> sink;
+		if (logPath.empty()) {
+			sink = std::make_shared<spdlog::sinks::null_sink_mt>();
+		}
+		else {
+			sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(logPath, true);
+		}
+
+		auto log = std::make_shared<spdlog::logger>("bench", std::move(sink));
+		log->set_level(spdlog::level::info);
+		log->set_pattern("%v");
+		spdlog::set_default_logger(std::move(log));
+
+		bool succeeded = Run(root, iterations);
+
+		spdlog::set_default_logger(std::move(console));
+
+		return succeeded ? 0 : 1;
+	}
+
+	PrintUsage();
+	return 1;
+}
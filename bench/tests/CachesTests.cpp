@@ -0,0 +1,132 @@
+#include "Tests.h"
+
+#include <fstream>
+
+#include <spdlog/sinks/base_sink.h>
+
+#include "Caches.h"
+
+namespace {
+	// Keeps the payload of every message that reaches the main log
+	class RecordingSink : public spdlog::sinks::base_sink<std::mutex> {
+	public:
+		std::vector<std::string> Messages;
+
+	protected:
+		void sink_it_(const spdlog::details::log_msg& a_msg) override {
+			Messages.emplace_back(a_msg.payload.data(), a_msg.payload.size());
+		}
+
+		void flush_() override {}
+	};
+
+	// Logs through Logs::CaptureSink, as the plugin does, for the lifetime of the object
+	class ScopedTestLogger {
+	public:
+		ScopedTestLogger() : _previous(spdlog::default_logger()) {
+			spdlog::set_default_logger(std::make_shared<spdlog::logger>("Tests", std::make_shared<Logs::CaptureSink>(Sink)));
+		}
+
+		~ScopedTestLogger() {
+			spdlog::set_default_logger(_previous);
+		}
+
+		std::shared_ptr<RecordingSink> Sink = std::make_shared<RecordingSink>();
+
+	private:
+		std::shared_ptr<spdlog::logger> _previous;
+	};
+
+	// Logs one statement and one warning into a buffer, as a config parser does, and sends the buffer through the cache
+	Logs::Buffer CaptureAndRoundTrip() {
+		Logs::Buffer log;
+		{
+			Logs::ScopedCapture capture(log);
+			{
+				Logs::ScopedStatementLog statementLog;
+				logger::info("FilterByFormID(\"Fallout4.esm\"|0x000801).FullName = \"Statement\";");
+			}
+			logger::warn("Line 1, Col 1: Warning");
+		}
+
+		Caches::Writer writer;
+		writer(log);
+
+		Logs::Buffer cachedLog;
+		Caches::Reader reader(writer.Data());
+		reader(cachedLog);
+		CHECK(!writer.Failed());
+		CHECK(!reader.Failed());
+
+		return cachedLog;
+	}
+
+	std::string ReadFile(const std::filesystem::path& a_path) {
+		std::ifstream file(a_path);
+		return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	struct ReplayResult {
+		std::vector<std::string> LogMessages;
+		std::string DumpContents;
+	};
+
+	// Replays a cached buffer under a_statementLog and returns what reached the main log and the statement dump
+	ReplayResult Replay(Logs::StatementLog a_statementLog) {
+		auto dumpPath = std::filesystem::temp_directory_path() / "TullPatcherF4Tests_Statements.log";
+		std::error_code ec;
+		std::filesystem::remove(dumpPath, ec);
+
+		ReplayResult result;
+		{
+			ScopedTestLogger testLogger;
+			Logs::SetStatementLog(a_statementLog, dumpPath);
+
+			Logs::Replay(CaptureAndRoundTrip());
+			spdlog::default_logger()->flush();
+
+			result = { testLogger.Sink->Messages, ReadFile(dumpPath) };
+			Logs::SetStatementLog(Logs::StatementLog::kLog);
+		}
+
+		std::filesystem::remove(dumpPath, ec);
+
+		return result;
+	}
+}
+
+TEST_CASE(CachedStatementsKeepTheirLogger) {
+	ScopedTestLogger testLogger;
+
+	auto cachedLog = CaptureAndRoundTrip();
+	CHECK(cachedLog.size() == 2);
+	if (cachedLog.size() != 2) {
+		return;
+	}
+
+	CHECK(std::string_view(cachedLog[0].logger_name.data(), cachedLog[0].logger_name.size()) == "Statements");
+	CHECK(cachedLog[0].level == spdlog::level::info);
+	CHECK(std::string_view(cachedLog[1].logger_name.data(), cachedLog[1].logger_name.size()) != "Statements");
+	CHECK(cachedLog[1].level == spdlog::level::warn);
+	CHECK(std::string_view(cachedLog[1].payload.data(), cachedLog[1].payload.size()) == "Line 1, Col 1: Warning");
+}
+
+TEST_CASE(CachedStatementsReplayToTheLog) {
+	auto result = Replay(Logs::StatementLog::kLog);
+	CHECK(result.LogMessages.size() == 2);
+	CHECK(result.DumpContents.empty());
+}
+
+TEST_CASE(CachedStatementsReplayToTheDumpFile) {
+	auto result = Replay(Logs::StatementLog::kFile);
+	CHECK(result.LogMessages.size() == 1);
+	CHECK(result.LogMessages.size() == 1 && result.LogMessages[0] == "Line 1, Col 1: Warning");
+	CHECK(result.DumpContents.find("\"Statement\";") != std::string::npos);
+}
+
+TEST_CASE(CachedStatementsAreDroppedWithStatementsOff) {
+	auto result = Replay(Logs::StatementLog::kNone);
+	CHECK(result.LogMessages.size() == 1);
+	CHECK(result.LogMessages.size() == 1 && result.LogMessages[0] == "Line 1, Col 1: Warning");
+	CHECK(result.DumpContents.empty());
+}
@@ -0,0 +1,102 @@
+#include "Tests.h"
+
+#include "Parsers.h"
+
+namespace {
+	// Builds condition tokens from a_expression, where T and F stand for IsPluginExists of a loaded and a missing plugin.
+	// Tokens are separated by spaces, except for '!', '(' and ')'.
+	std::optional<Parsers::Conditions> Compile(std::string_view a_expression) {
+		using TokenType = Parsers::ConditionToken::TokenType;
+
+		Arenas::Vector<Parsers::ConditionToken> tokens;
+
+		std::size_t ii = 0;
+		while (ii < a_expression.size()) {
+			char ch = a_expression[ii];
+			if (ch == ' ') {
+				ii++;
+			}
+			else if (ch == 'T' || ch == 'F') {
+				Parsers::Condition condition{ Parsers::Condition::ConditionType::kFunction, Parsers::PluginExistsConditionName, ch == 'T' ? "Fallout4.esm" : "Missing.esm", {} };
+				tokens.push_back({ TokenType::kCondition, condition, std::nullopt });
+				ii++;
+			}
+			else if (ch == '(' || ch == ')') {
+				tokens.push_back({ TokenType::kParenthesis, std::nullopt, a_expression.substr(ii, 1) });
+				ii++;
+			}
+			else if (ch == '!') {
+				tokens.push_back({ TokenType::kOperator, std::nullopt, a_expression.substr(ii, 1) });
+				ii++;
+			}
+			else {
+				tokens.push_back({ TokenType::kOperator, std::nullopt, a_expression.substr(ii, 2) });
+				ii += 2;
+			}
+		}
+
+		return Parsers::CompileConditions(std::move(tokens));
+	}
+
+	std::optional<bool> Evaluate(std::string_view a_expression) {
+		auto conditions = Compile(a_expression);
+		if (!conditions.has_value()) {
+			return std::nullopt;
+		}
+
+		return Parsers::EvaluateConditions(conditions.value());
+	}
+
+	// Returns how many conditions evaluating a_expression tested
+	std::uint64_t CountTested(std::string_view a_expression) {
+		auto conditions = Compile(a_expression);
+		CHECK(conditions.has_value());
+		if (!conditions.has_value()) {
+			return 0;
+		}
+
+		auto misses = Parsers::GetConditionCacheStats().Misses;
+		Parsers::EvaluateConditions(conditions.value());
+		return Parsers::GetConditionCacheStats().Misses - misses;
+	}
+}
+
+TEST_CASE(ConditionsEvaluateSingleOperators) {
+	CHECK(Evaluate("T") == true);
+	CHECK(Evaluate("F") == false);
+	CHECK(Evaluate("!F") == true);
+	CHECK(Evaluate("!!T") == true);
+	CHECK(Evaluate("T && F") == false);
+	CHECK(Evaluate("T && T && T") == true);
+	CHECK(Evaluate("F || T") == true);
+	CHECK(Evaluate("F || F || F") == false);
+}
+
+// ! binds tightest, then &&, then ||. Before conditions were compiled, a && !b || c was grouped as a && (!b || c).
+TEST_CASE(ConditionsUseStandardPrecedence) {
+	CHECK(Evaluate("F && !T || T") == true);
+	CHECK(Evaluate("F && (!T || T)") == false);
+	CHECK(Evaluate("T || F && F") == true);
+	CHECK(Evaluate("(T || F) && F") == false);
+	CHECK(Evaluate("F && F || T && T") == true);
+	CHECK(Evaluate("F && (F || T) && T") == false);
+	CHECK(Evaluate("!T || T && !F") == true);
+	CHECK(Evaluate("!(T || T) && T") == false);
+	CHECK(Evaluate("!F && F || !T") == false);
+	CHECK(Evaluate("T && !(F && T) || F") == true);
+}
+
+TEST_CASE(ConditionsShortCircuit) {
+	CHECK(CountTested("T || F || F") == 1);
+	CHECK(CountTested("F && T && T") == 1);
+	CHECK(CountTested("F && T || T") == 2);
+	CHECK(CountTested("T && T || F") == 2);
+	CHECK(CountTested("!(T || F) && T") == 1);
+}
+
+TEST_CASE(ConditionsRejectIncompleteExpressions) {
+	CHECK(!Compile("T &&").has_value());
+	CHECK(!Compile("(T || F").has_value());
+	CHECK(!Compile("T F").has_value());
+	CHECK(!Compile("!").has_value());
+}
@@ -0,0 +1,193 @@
+#include "Tests.h"
+
+#include <fstream>
+
+#include <spdlog/sinks/null_sink.h>
+
+#include "BenchParser.h"
+
+namespace {
+	constexpr std::string_view Statement1 = "FilterByFormID(\"Fallout4.esm\"|0x801).ArmorRating = 1;\n";
+	constexpr std::string_view Statement2 = "FilterByFormID(\"Fallout4.esm\"|0x802).ArmorRating = 2;\n";
+	constexpr std::string_view Statement3 = "FilterByFormID(\"Fallout4.esm\"|0x803).ArmorRating = 3;\n";
+
+	// Writes a_contents to a temporary config file, removed again with the object
+	class TempConfig {
+	public:
+		TempConfig(std::string_view a_contents) :
+			_path(std::filesystem::temp_directory_path() / "TullPatcherF4Tests_Split.cfg") {
+			std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+			file.write(a_contents.data(), static_cast<std::streamsize>(a_contents.size()));
+		}
+
+		~TempConfig() {
+			std::error_code ec;
+			std::filesystem::remove(_path, ec);
+		}
+
+		std::string Path() const { return _path.string(); }
+
+	private:
+		std::filesystem::path _path;
+	};
+
+	struct ParseResult {
+		std::vector<std::string> Log;
+		std::size_t Statements = 0;
+	};
+
+	void AppendLog(const Logs::Buffer& a_log, ParseResult& a_result) {
+		for (const auto& msg : a_log) {
+			a_result.Log.emplace_back(msg.payload.data(), msg.payload.size());
+		}
+	}
+
+	// Parses the whole file with one parser
+	ParseResult ParseWhole(const std::string& a_path) {
+		ParseResult result;
+
+		Arenas::Arena arena;
+		Logs::Buffer log;
+		{
+			Arenas::ScopedArena arenaScope(arena);
+			Logs::ScopedCapture capture(log);
+
+			Bench::BenchParser parser(a_path);
+			result.Statements = parser.Parse().size();
+		}
+
+		AppendLog(log, result);
+		return result;
+	}
+
+	// Parses each chunk with its own parser and merges them as ConfigUtils::ParseConfig does
+	ParseResult ParseChunks(const std::vector<Configs::ConfigChunk>& a_chunks) {
+		ParseResult result;
+
+		Arenas::Arena arena;
+		for (const auto& chunk : a_chunks) {
+			Logs::Buffer log;
+			bool failed = false;
+			{
+				Arenas::ScopedArena arenaScope(arena);
+				Logs::ScopedCapture capture(log);
+
+				Bench::BenchParser parser(chunk);
+				result.Statements += parser.Parse().size();
+				failed = parser.Failed();
+			}
+
+			AppendLog(log, result);
+			if (failed) {
+				break;
+			}
+		}
+
+		return result;
+	}
+
+	std::vector<Configs::ConfigChunk> Split(const std::string& a_path, std::size_t a_chunkSize) {
+		Bench::BenchParser parser(a_path);
+		return parser.Split(a_chunkSize);
+	}
+
+	// Returns the size that makes Split consider its first cut right after the a_occurrence-th '}' of a_contents
+	std::size_t SizeThroughBrace(std::string_view a_contents, std::size_t a_occurrence) {
+		std::size_t index = std::string_view::npos;
+		for (std::size_t ii = 0; ii < a_occurrence; ii++) {
+			index = a_contents.find('}', index + 1);
+		}
+
+		return index + 1;
+	}
+
+	// Checks that the chunks cover the contents in order and parse to the same statements and log as the whole file
+	void CheckSplit(std::string_view a_contents, std::size_t a_chunkSize, std::size_t a_expectedChunks) {
+		TempConfig config(a_contents);
+
+		auto chunks = Split(config.Path(), a_chunkSize);
+		CHECK(chunks.size() == a_expectedChunks);
+
+		std::string joined;
+		for (const auto& chunk : chunks) {
+			CHECK(!chunk.Contents.empty());
+			joined += chunk.Contents;
+		}
+		CHECK(joined == a_contents);
+
+		auto whole = ParseWhole(config.Path());
+		auto chunked = ParseChunks(chunks);
+		CHECK(whole.Statements == chunked.Statements);
+		CHECK(whole.Log == chunked.Log);
+	}
+
+	// Sends log output through Logs::CaptureSink, so that parsers can be captured, for the lifetime of the object
+	class ScopedCaptureLogger {
+	public:
+		ScopedCaptureLogger() : _previous(spdlog::default_logger()) {
+			auto sink = std::make_shared<Logs::CaptureSink>(std::make_shared<spdlog::sinks::null_sink_mt>());
+			spdlog::set_default_logger(std::make_shared<spdlog::logger>("Tests", std::move(sink)));
+		}
+
+		~ScopedCaptureLogger() {
+			spdlog::set_default_logger(_previous);
+		}
+
+	private:
+		std::shared_ptr<spdlog::logger> _previous;
+	};
+}
+
+// "}else" is a single token to the lexer, so it neither closes the block nor may end a chunk
+TEST_CASE(SplitAtBraceGluedToElse) {
+	ScopedCaptureLogger captureLogger;
+
+	std::string contents = fmt::format("{}if (IsPluginExists(\"Fallout4.esm\")) {{\n{}}}else {{\n{}}}\n{}", Statement1, Statement2, Statement3, Statement1);
+	CheckSplit(contents, SizeThroughBrace(contents, 1), 1);
+}
+
+TEST_CASE(SplitAtBraceBeforeCommentAndElse) {
+	ScopedCaptureLogger captureLogger;
+
+	std::string contents = fmt::format("{}if (IsPluginExists(\"Fallout4.esm\")) {{\n{}}} # c\nelse {{\n{}}}\n{}", Statement1, Statement2, Statement3, Statement1);
+	CheckSplit(contents, SizeThroughBrace(contents, 1), 2);
+
+	// The chain is kept whole, and the first chunk ends with the brace that closes its else block
+	TempConfig config(contents);
+	auto chunks = Split(config.Path(), SizeThroughBrace(contents, 1));
+	CHECK(!chunks.empty() && chunks[0].Contents == std::string_view(contents).substr(0, SizeThroughBrace(contents, 2)));
+}
+
+// "//" is not a comment to the lexer, so the if chain ends at the brace and both parses fail on the same token
+TEST_CASE(SplitAtBraceBeforeSlashComment) {
+	ScopedCaptureLogger captureLogger;
+
+	std::string contents = fmt::format("{}if (IsPluginExists(\"Fallout4.esm\")) {{\n{}}} // c\nelse {{\n{}}}\n{}", Statement1, Statement2, Statement3, Statement1);
+	CheckSplit(contents, SizeThroughBrace(contents, 1), 2);
+}
+
+TEST_CASE(SplitAtBraceAtEndOfFile) {
+	ScopedCaptureLogger captureLogger;
+
+	std::string contents = fmt::format("{}{}if (IsFormExists(\"Fallout4.esm\"|0x801)) {{\n{}}}\nelse if (!IsPluginExists(\"Missing.esp\")) {{\n{}}}", Statement1, Statement2, Statement3, Statement1);
+	CheckSplit(contents, 1, 3);
+	CheckSplit(contents, contents.size() - 1, 1);
+}
+
+TEST_CASE(SplitNestedChains) {
+	ScopedCaptureLogger captureLogger;
+
+	std::string block = fmt::format("if (IsPluginExists(\"Fallout4.esm\") && !IsPluginExists(\"Missing.esp\")) {{\n\tif (IsPluginExists(\"DLCRobot.esm\")) {{\n\t{}\t}}\n\telse {{\n\t{}\t}}\n}}\nelse if (IsPluginExists(\"DLCCoast.esm\")) {{\n{}}}\n", Statement1, Statement2, Statement3);
+
+	std::string contents;
+	for (std::size_t ii = 0; ii < 20; ii++) {
+		contents += ii % 3 == 0 ? std::string(Statement1) : block;
+	}
+
+	for (std::size_t chunkSize : { std::size_t{ 1 }, std::size_t{ 64 }, std::size_t{ 500 } }) {
+		TempConfig config(contents);
+		auto chunks = Split(config.Path(), chunkSize);
+		CHECK(chunks.size() > 1);
+		CheckSplit(contents, chunkSize, chunks.size());
+	}
+}
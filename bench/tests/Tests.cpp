@@ -0,0 +1,54 @@
+#include "Tests.h"
+
+namespace Tests {
+	namespace {
+		struct TestCase {
+			std::string_view Name;
+			TestFunc Func;
+		};
+
+		std::vector<TestCase>& GetTestCases() {
+			static std::vector<TestCase> testCases;
+			return testCases;
+		}
+
+		std::size_t g_failureCount = 0;
+	}
+
+	Registrar::Registrar(std::string_view a_name, TestFunc a_func) {
+		GetTestCases().push_back({ a_name, a_func });
+	}
+
+	void Fail(std::string_view a_expression, std::string_view a_file, int a_line) {
+		g_failureCount++;
+		fmt::print(stderr, "{}({}): CHECK({}) failed\n", a_file, a_line, a_expression);
+	}
+}
+
+// Runs every test, or only those whose name contains the first argument
+int main(int a_argc, char* a_argv[]) {
+	std::string_view filter = a_argc > 1 ? a_argv[1] : "";
+
+	std::size_t runCount = 0;
+	std::size_t failedCount = 0;
+
+	for (const auto& testCase : Tests::GetTestCases()) {
+		if (testCase.Name.find(filter) == std::string_view::npos) {
+			continue;
+		}
+
+		std::size_t failuresBefore = Tests::g_failureCount;
+		testCase.Func();
+		runCount++;
+
+		bool failed = Tests::g_failureCount != failuresBefore;
+		if (failed) {
+			failedCount++;
+		}
+
+		fmt::print("[{}] {}\n", failed ? "FAIL" : " OK ", testCase.Name);
+	}
+
+	fmt::print("{} of {} tests passed\n", runCount - failedCount, runCount);
+	return failedCount == 0 && runCount > 0 ? 0 : 1;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+// A minimal test runner, so that the tests need nothing beyond what the benchmark already builds with
+
+namespace Tests {
+	using TestFunc = void (*)();
+
+	struct Registrar {
+		Registrar(std::string_view a_name, TestFunc a_func);
+	};
+
+	void Fail(std::string_view a_expression, std::string_view a_file, int a_line);
+}
+
+#define TEST_CASE(a_name)                                                 \
+	static void a_name();                                                 \
+	static const Tests::Registrar a_name##Registrar{ #a_name, &a_name }; \
+	static void a_name()
+
+#define CHECK(a_expression)                                       \
+	do {                                                          \
+		if (!(a_expression)) {                                    \
+			Tests::Fail(#a_expression, __FILE__, __LINE__);       \
+		}                                                         \
+	} while (false)
@@ -35,11 +35,26 @@ set(SOURCES
 	src/Weapons.cpp
 	src/Worldspaces.h
 	src/Worldspaces.cpp
+	src/Arenas.h
+	src/Arenas.cpp
+	src/Caches.h
+	src/Caches.cpp
 	src/Configs.h
 	src/Configs.cpp
 	src/ConfigUtils.h
+	src/ConfigUtils.cpp
+	src/Logs.h
+	src/Logs.cpp
 	src/Parsers.h
 	src/Parsers.cpp
+	src/PerfectHash.h
+	src/Reloads.h
+	src/Reloads.cpp
+	src/Schedulers.h
+	src/Schedulers.cpp
+	src/Settings.h
+	src/Settings.cpp
+	src/Symbols.h
 	src/Utils.h
 	src/Utils.cpp
 	src/PCH.h
@@ -0,0 +1,109 @@
+#include "Arenas.h"
+
+namespace Arenas {
+	namespace {
+		constexpr std::size_t ChunkSize = 16 * 1024;
+
+		thread_local ScopedArena* t_currentScope = nullptr;
+
+		Arena g_globalArena;
+
+		std::byte* AlignUp(std::byte* a_ptr, std::size_t a_alignment) {
+			auto address = reinterpret_cast<std::uintptr_t>(a_ptr);
+			return a_ptr + ((a_alignment - (address & (a_alignment - 1))) & (a_alignment - 1));
+		}
+	}
+
+	Arena::~Arena() {
+		Release();
+	}
+
+	void* Arena::Allocate(std::size_t a_size, std::size_t a_alignment) {
+		if (t_currentScope && &t_currentScope->_arena == this) {
+			return t_currentScope->Allocate(a_size, a_alignment);
+		}
+
+		// Outside of a scope every allocation gets a chunk of its own; this only happens when a tree is modified after parsing
+		return AlignUp(AllocateChunk(a_size + a_alignment), a_alignment);
+	}
+
+	void Arena::Retain(std::shared_ptr<const void> a_owner) {
+		std::lock_guard<std::mutex> lock(_lock);
+		_owners.push_back(std::move(a_owner));
+	}
+
+	void Arena::Release() {
+		std::lock_guard<std::mutex> lock(_lock);
+		_chunks.clear();
+		_chunks.shrink_to_fit();
+		_owners.clear();
+		_owners.shrink_to_fit();
+	}
+
+	std::byte* Arena::AllocateChunk(std::size_t a_size) {
+		auto chunk = std::make_unique_for_overwrite<std::byte[]>(a_size);
+		std::byte* retPtr = chunk.get();
+
+		std::lock_guard<std::mutex> lock(_lock);
+		_chunks.push_back(std::move(chunk));
+
+		return retPtr;
+	}
+
+	ScopedArena::ScopedArena(Arena& a_arena) : _arena(a_arena), _previous(t_currentScope) {
+		t_currentScope = this;
+	}
+
+	ScopedArena::~ScopedArena() {
+		t_currentScope = _previous;
+	}
+
+	Arena* ScopedArena::Current() {
+		return t_currentScope ? &t_currentScope->_arena : nullptr;
+	}
+
+	void* ScopedArena::Allocate(std::size_t a_size, std::size_t a_alignment) {
+		std::byte* ptr = _current ? AlignUp(_current, a_alignment) : nullptr;
+		if (ptr && static_cast<std::size_t>(_end - ptr) >= a_size) {
+			_current = ptr + a_size;
+			return ptr;
+		}
+
+		// Large blocks get a chunk of their own so that the rest of the current chunk is not thrown away
+		if (a_size + a_alignment > ChunkSize / 4) {
+			return AlignUp(_arena.AllocateChunk(a_size + a_alignment), a_alignment);
+		}
+
+		_current = _arena.AllocateChunk(ChunkSize);
+		_end = _current + ChunkSize;
+
+		ptr = AlignUp(_current, a_alignment);
+		_current = ptr + a_size;
+		return ptr;
+	}
+
+	std::string_view StoreString(std::initializer_list<std::string_view> a_parts) {
+		std::size_t length = 0;
+		for (auto part : a_parts) {
+			length += part.length();
+		}
+
+		if (length == 0) {
+			return std::string_view{};
+		}
+
+		Arena* arena = ScopedArena::Current();
+		if (!arena) {
+			arena = &g_globalArena;
+		}
+
+		char* retPtr = static_cast<char*>(arena->Allocate(length, alignof(char)));
+
+		char* ptr = retPtr;
+		for (auto part : a_parts) {
+			ptr = std::copy(part.begin(), part.end(), ptr);
+		}
+
+		return std::string_view(retPtr, length);
+	}
+}
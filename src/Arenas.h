@@ -0,0 +1,103 @@
+#pragma once
+
+namespace Arenas {
+	// Bump allocator owning the parsed statements of one record type. Memory is never handed back piece by piece;
+	// Release frees every chunk at once, after all containers allocated from the arena have been destroyed.
+	class Arena {
+	public:
+		Arena() = default;
+		~Arena();
+
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		void* Allocate(std::size_t a_size, std::size_t a_alignment);
+
+		// Keeps a_owner, such as the buffer of a parsed file, alive until Release
+		void Retain(std::shared_ptr<const void> a_owner);
+
+		void Release();
+
+	private:
+		friend class ScopedArena;
+
+		std::byte* AllocateChunk(std::size_t a_size);
+
+		std::mutex _lock;
+		std::vector<std::unique_ptr<std::byte[]>> _chunks;
+		std::vector<std::shared_ptr<const void>> _owners;
+	};
+
+	// Makes a_arena the allocation target of every container default constructed on the current thread for the lifetime
+	// of the object. Allocations bump through a chunk owned by this scope, so threads parsing different files never contend.
+	class ScopedArena {
+	public:
+		ScopedArena(Arena& a_arena);
+		~ScopedArena();
+
+		ScopedArena(const ScopedArena&) = delete;
+		ScopedArena& operator=(const ScopedArena&) = delete;
+
+		static Arena* Current();
+
+	private:
+		friend class Arena;
+
+		void* Allocate(std::size_t a_size, std::size_t a_alignment);
+
+		Arena& _arena;
+		ScopedArena* _previous;
+		std::byte* _current = nullptr;
+		std::byte* _end = nullptr;
+	};
+
+	// Allocates from the arena that was current when the container was created, or from the heap outside of any arena
+	template <typename T>
+	class Allocator {
+	public:
+		using value_type = T;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		Allocator() noexcept : _arena(ScopedArena::Current()) {}
+
+		template <typename U>
+		Allocator(const Allocator<U>& a_other) noexcept : _arena(a_other._arena) {}
+
+		T* allocate(std::size_t a_count) {
+			if (!_arena) {
+				return std::allocator<T>{}.allocate(a_count);
+			}
+
+			return static_cast<T*>(_arena->Allocate(a_count * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* a_ptr, std::size_t a_count) noexcept {
+			if (!_arena) {
+				std::allocator<T>{}.deallocate(a_ptr, a_count);
+			}
+		}
+
+		// Copies belong to whichever arena is current where they are made, not to the arena of the source
+		Allocator select_on_container_copy_construction() const noexcept {
+			return Allocator();
+		}
+
+		template <typename U>
+		bool operator==(const Allocator<U>& a_other) const noexcept {
+			return _arena == a_other._arena;
+		}
+
+	private:
+		template <typename U>
+		friend class Allocator;
+
+		Arena* _arena;
+	};
+
+	template <typename T>
+	using Vector = std::vector<T, Allocator<T>>;
+
+	// Copies the concatenation of a_parts into the current arena. Text stored outside of any arena lives until exit.
+	std::string_view StoreString(std::initializer_list<std::string_view> a_parts);
+}
@@ -1,7 +1,5 @@
 #include "ArmorAddons.h"
 
-#include <regex>
-
 #include "ConfigUtils.h"
 #include "Parsers.h"
 #include "Utils.h"
@@ -33,21 +31,32 @@ namespace ArmorAddons {
 
 	struct ConfigData {
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
 		std::optional<std::uint32_t> AssignValue;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.AssignValue);
+	}
+
 	struct PatchData {
 		std::optional<std::uint32_t> BipedObjectSlots;
+
+		bool operator==(const PatchData&) const = default;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::TESObjectARMA*, PatchData> g_patchMap;
+	std::unordered_map<RE::TESObjectARMA*, PatchData> g_appliedPatchMap;
+	std::unordered_map<RE::TESObjectARMA*, PatchData> g_originalDataMap;
 
 	class ArmorAddonParser : public Parsers::Parser<ConfigData> {
 	public:
 		ArmorAddonParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		ArmorAddonParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -81,7 +90,7 @@ namespace ArmorAddons {
 				return std::nullopt;
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -97,7 +106,7 @@ namespace ArmorAddons {
 
 		bool ParseFilter(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_config.Filter = FilterType::kFormID;
 			}
 			else {
@@ -129,7 +138,7 @@ namespace ArmorAddons {
 
 		bool ParseElement(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "BipedObjectSlots") {
+			if (reader.GetLastSymbol() == Symbol::kBipedObjectSlots) {
 				a_config.Element = ElementType::kBipedObjectSlots;
 			}
 			else {
@@ -193,12 +202,16 @@ namespace ArmorAddons {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<ArmorAddonParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<ArmorAddonParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+	}
+
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::TESObjectARMA*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -211,31 +224,62 @@ namespace ArmorAddons {
 			}
 
 			if (a_configData.Element == ElementType::kBipedObjectSlots) {
-				g_patchMap[arma].BipedObjectSlots = a_configData.AssignValue.value();
+				a_patchMap[arma].BipedObjectSlots = a_configData.AssignValue.value();
 			}
 		}
 	}
 
+	void Capture(RE::TESObjectARMA* a_arma, const PatchData& a_patchData, PatchData& a_originalData) {
+		if (a_patchData.BipedObjectSlots.has_value() && !a_originalData.BipedObjectSlots.has_value()) {
+			a_originalData.BipedObjectSlots = a_arma->bipedModelData.bipedObjectSlots;
+		}
+	}
+
+	void Patch(RE::TESObjectARMA* a_arma, const PatchData& a_patchData) {
+		if (a_patchData.BipedObjectSlots.has_value()) {
+			a_arma->bipedModelData.bipedObjectSlots = a_patchData.BipedObjectSlots.value();
+		}
+	}
+
+	void ApplyPatches() {
+		ConfigUtils::ApplyPatches(g_appliedPatchMap, g_originalDataMap, std::move(g_patchMap), Capture, [](RE::TESObjectARMA* a_arma, const PatchData& a_patchData) {
+			Patch(a_arma, a_patchData);
+		});
+	}
+
 	void Patch() {
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
 
 		logger::info("======================== Start patching for {} ========================", TypeName);
 
-		for (const auto& patchData : g_patchMap) {
-			if (patchData.second.BipedObjectSlots.has_value()) {
-				patchData.first->bipedModelData.bipedObjectSlots = patchData.second.BipedObjectSlots.value();
-			}
-		}
+		ApplyPatches();
 
 		logger::info("======================== Finished patching for {} ========================", TypeName);
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
+		g_patchMap.clear();
+	}
+
+	void Reload() {
+		logger::info("======================== Start reloading {} ========================", TypeName);
+
+		ReadConfigs();
+		ConfigUtils::ResolveForms(g_configVec);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
+		ApplyPatches();
+
+		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
+
+		logger::info("======================== Finished reloading {} ========================", TypeName);
+		logger::info("");
 	}
 }
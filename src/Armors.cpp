@@ -1,6 +1,5 @@
 #include "Armors.h"
 
-#include <regex>
 #include <any>
 
 #include "ConfigUtils.h"
@@ -60,7 +59,7 @@ namespace Armors {
 	struct ConfigData {
 		struct Operation {
 			struct ResistanceData {
-				std::string Form;
+				Utils::FormReference Form;
 				std::uint32_t Value;
 			};
 
@@ -69,28 +68,51 @@ namespace Armors {
 		};
 
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
-		std::vector<Operation> Operations;
+		Arenas::Vector<Operation> Operations;
 		std::optional<std::any> AssignValue;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation::ResistanceData& a_resistanceData) {
+		a_ar(a_resistanceData.Form, a_resistanceData.Value);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation& a_operation) {
+		a_ar(a_operation.OpType);
+		a_ar.template Any<Utils::FormReference, ConfigData::Operation::ResistanceData>(a_operation.OpData);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.Operations);
+		a_ar.template Any<std::string_view, std::uint16_t, std::uint32_t, Utils::FormReference>(a_configData.AssignValue);
+	}
+
 	struct PatchData {
 		struct KeywordsData {
 			bool Clear;
 			std::vector<RE::BGSKeyword*> AddKeywordVec;
 			std::vector<RE::BGSKeyword*> DeleteKeywordVec;
+
+			bool operator==(const KeywordsData&) const = default;
 		};
 
 		struct ResistancesData {
 			struct Resistance {
 				RE::BGSDamageType* DamageType;
 				std::uint32_t Value;
+
+				bool operator==(const Resistance&) const = default;
 			};
 
 			bool Clear;
 			std::vector<Resistance> AddResistanceVec;
 			std::vector<Resistance> DeleteResistanceVec;
+
+			bool operator==(const ResistancesData&) const = default;
 		};
 
 		std::optional<std::uint16_t> ArmorRating;
@@ -99,14 +121,20 @@ namespace Armors {
 		std::optional<KeywordsData> Keywords;
 		std::optional<RE::EnchantmentItem*> ObjectEffect;
 		std::optional<ResistancesData> Resistances;
+
+		bool operator==(const PatchData&) const = default;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::TESObjectARMO*, PatchData> g_patchMap;
+	std::unordered_map<RE::TESObjectARMO*, PatchData> g_appliedPatchMap;
+	std::unordered_map<RE::TESObjectARMO*, PatchData> g_originalDataMap;
 
 	class ArmorParser : public Parsers::Parser<ConfigData> {
 	public:
 		ArmorParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		ArmorParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -171,7 +199,7 @@ namespace Armors {
 				return std::nullopt;
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -190,7 +218,7 @@ namespace Armors {
 
 			case ElementType::kFullName:
 				logger::info("{}{}({}).{} = \"{}\";", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm,
-					ElementTypeToString(a_configData.Element), std::any_cast<std::string>(a_configData.AssignValue.value()));
+					ElementTypeToString(a_configData.Element), std::any_cast<std::string_view>(a_configData.AssignValue.value()));
 				break;
 
 			case ElementType::kKeywords:
@@ -206,7 +234,7 @@ namespace Armors {
 					case OperationType::kAdd:
 					case OperationType::kDelete:
 						opLog = fmt::format(".{}({})", OperationTypeToString(a_configData.Operations[ii].OpType),
-							std::any_cast<std::string>(a_configData.Operations[ii].OpData.value()));
+							std::any_cast<Utils::FormReference>(a_configData.Operations[ii].OpData.value()));
 						break;
 					}
 
@@ -220,7 +248,7 @@ namespace Armors {
 
 			case ElementType::kObjectEffect:
 				logger::info("{}{}({}).{} = {};", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm,
-					ElementTypeToString(a_configData.Element), std::any_cast<std::string>(a_configData.AssignValue.value()));
+					ElementTypeToString(a_configData.Element), std::any_cast<Utils::FormReference>(a_configData.AssignValue.value()));
 				break;
 
 			case ElementType::kResistances:
@@ -256,7 +284,7 @@ namespace Armors {
 
 		bool ParseFilter(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_config.Filter = FilterType::kFormID;
 			}
 			else {
@@ -288,25 +316,32 @@ namespace Armors {
 
 		bool ParseElement(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "ArmorRating") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kArmorRating:
 				a_config.Element = ElementType::kArmorRating;
-			}
-			else if (token == "BipedObjectSlots") {
+				break;
+
+			case Symbol::kBipedObjectSlots:
 				a_config.Element = ElementType::kBipedObjectSlots;
-			}
-			else if (token == "FullName") {
+				break;
+
+			case Symbol::kFullName:
 				a_config.Element = ElementType::kFullName;
-			}
-			else if (token == "Keywords") {
+				break;
+
+			case Symbol::kKeywords:
 				a_config.Element = ElementType::kKeywords;
-			}
-			else if (token == "ObjectEffect") {
+				break;
+
+			case Symbol::kObjectEffect:
 				a_config.Element = ElementType::kObjectEffect;
-			}
-			else if (token == "Resistances") {
+				break;
+
+			case Symbol::kResistances:
 				a_config.Element = ElementType::kResistances;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid ElementName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -384,20 +419,19 @@ namespace Armors {
 					return false;
 				}
 
-				std::string value = std::string(token.substr(1, token.length() - 2));
+				std::string_view value = token.substr(1, token.length() - 2);
 				a_config.AssignValue = std::any(value);
 			}
 			else if (a_config.Element == ElementType::kObjectEffect) {
-				token = reader.Peek();
-				if (token == "null") {
-					a_config.AssignValue = std::any(std::string(reader.GetToken()));
+				if (reader.PeekSymbol() == Symbol::kNull) {
+					a_config.AssignValue = std::any(Utils::FormReference{ reader.GetToken() });
 				} else {
 					auto effectForm = ParseForm();
 					if (!effectForm.has_value()) {
 						return false;
 					}
 
-					a_config.AssignValue = std::any(std::string(effectForm.value()));
+					a_config.AssignValue = std::any(effectForm.value());
 				}
 			}
 			else {
@@ -412,16 +446,20 @@ namespace Armors {
 			ConfigData::Operation newOp;
 
 			auto token = reader.GetToken();
-			if (token == "Clear") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kClear:
 				newOp.OpType = OperationType::kClear;
-			}
-			else if (token == "Add") {
+				break;
+
+			case Symbol::kAdd:
 				newOp.OpType = OperationType::kAdd;
-			}
-			else if (token == "Delete") {
+				break;
+
+			case Symbol::kDelete:
 				newOp.OpType = OperationType::kDelete;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid OperationName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -513,12 +551,16 @@ namespace Armors {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<ArmorParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<ArmorParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+	}
+
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::TESObjectARMO*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -531,82 +573,82 @@ namespace Armors {
 			}
 
 			if (a_configData.Element == ElementType::kArmorRating) {
-				g_patchMap[armo].ArmorRating = std::any_cast<std::uint16_t>(a_configData.AssignValue.value());
+				a_patchMap[armo].ArmorRating = std::any_cast<std::uint16_t>(a_configData.AssignValue.value());
 			} 
 			else if (a_configData.Element == ElementType::kBipedObjectSlots) {
-				g_patchMap[armo].BipedObjectSlots = std::any_cast<std::uint32_t>(a_configData.AssignValue.value());
+				a_patchMap[armo].BipedObjectSlots = std::any_cast<std::uint32_t>(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kFullName) {
-				g_patchMap[armo].FullName = std::any_cast<std::string>(a_configData.AssignValue.value());
+				a_patchMap[armo].FullName = std::string(std::any_cast<std::string_view>(a_configData.AssignValue.value()));
 			}
 			else if (a_configData.Element == ElementType::kKeywords) {
-				if (!g_patchMap[armo].Keywords.has_value()) {
-					g_patchMap[armo].Keywords = PatchData::KeywordsData{};
+				if (!a_patchMap[armo].Keywords.has_value()) {
+					a_patchMap[armo].Keywords = PatchData::KeywordsData{};
 				}
 
 				for (const auto& operation : a_configData.Operations) {
 					if (operation.OpType == OperationType::kClear) {
-						g_patchMap[armo].Keywords->Clear = true;
+						a_patchMap[armo].Keywords->Clear = true;
 					}
 					else if (operation.OpType == OperationType::kAdd || operation.OpType == OperationType::kDelete) {
-						std::string keywordFormStr = std::any_cast<std::string>(operation.OpData.value());
+						const Utils::FormReference& keywordFormRef = std::any_cast<const Utils::FormReference&>(operation.OpData.value());
 
-						RE::TESForm* keywordForm = Utils::GetFormFromString(keywordFormStr);
+						RE::TESForm* keywordForm = keywordFormRef.Form;
 						if (!keywordForm) {
-							logger::warn("Invalid Form: '{}'.", keywordFormStr);
+							logger::warn("Invalid Form: '{}'.", keywordFormRef);
 							return;
 						}
 
 						RE::BGSKeyword* keyword = keywordForm->As<RE::BGSKeyword>();
 						if (!keyword) {
-							logger::warn("'{}' is not a Keyword.", keywordFormStr);
+							logger::warn("'{}' is not a Keyword.", keywordFormRef);
 							return;
 						}
 
 						if (operation.OpType == OperationType::kAdd) {
-							g_patchMap[armo].Keywords->AddKeywordVec.push_back(keyword);
+							a_patchMap[armo].Keywords->AddKeywordVec.push_back(keyword);
 						}
 						else {
-							g_patchMap[armo].Keywords->DeleteKeywordVec.push_back(keyword);
+							a_patchMap[armo].Keywords->DeleteKeywordVec.push_back(keyword);
 						}
 					}
 				}
 			}
 			else if (a_configData.Element == ElementType::kObjectEffect) {
-				std::string effectFormStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+				const Utils::FormReference& effectFormRef = std::any_cast<const Utils::FormReference&>(a_configData.AssignValue.value());
 
-				if (effectFormStr == "null") {
-					g_patchMap[armo].ObjectEffect = nullptr;
+				if (effectFormRef.IsNull()) {
+					a_patchMap[armo].ObjectEffect = nullptr;
 				}
 				else {
-					RE::TESForm* effectForm = Utils::GetFormFromString(effectFormStr);
+					RE::TESForm* effectForm = effectFormRef.Form;
 					if (!effectForm) {
-						logger::warn("Invalid Form: '{}'.", effectFormStr);
+						logger::warn("Invalid Form: '{}'.", effectFormRef);
 						return;
 					}
 
 					RE::EnchantmentItem* objectEffect = effectForm->As<RE::EnchantmentItem>();
 					if (!objectEffect) {
-						logger::warn("'{}' is not an Object Effect.", effectFormStr);
+						logger::warn("'{}' is not an Object Effect.", effectFormRef);
 						return;
 					}
 
-					g_patchMap[armo].ObjectEffect = objectEffect;
+					a_patchMap[armo].ObjectEffect = objectEffect;
 				}
 			}
 			else if (a_configData.Element == ElementType::kResistances) {
-				if (!g_patchMap[armo].Resistances.has_value()) {
-					g_patchMap[armo].Resistances = PatchData::ResistancesData{};
+				if (!a_patchMap[armo].Resistances.has_value()) {
+					a_patchMap[armo].Resistances = PatchData::ResistancesData{};
 				}
 
 				for (const auto& operation : a_configData.Operations) {
 					if (operation.OpType == OperationType::kClear) {
-						g_patchMap[armo].Resistances->Clear = true;
+						a_patchMap[armo].Resistances->Clear = true;
 					}
 					else if (operation.OpType == OperationType::kAdd || operation.OpType == OperationType::kDelete) {
 						ConfigData::Operation::ResistanceData resistanceData = std::any_cast<ConfigData::Operation::ResistanceData>(operation.OpData.value());
 
-						RE::TESForm* form = Utils::GetFormFromString(resistanceData.Form);
+						RE::TESForm* form = resistanceData.Form.Form;
 						if (!form) {
 							logger::warn("Invalid Form: '{}'.", resistanceData.Form);
 							continue;
@@ -621,10 +663,10 @@ namespace Armors {
 						PatchData::ResistancesData::Resistance resistance{ damageType, resistanceData.Value };
 
 						if (operation.OpType == OperationType::kAdd) {
-							g_patchMap[armo].Resistances->AddResistanceVec.push_back(resistance);
+							a_patchMap[armo].Resistances->AddResistanceVec.push_back(resistance);
 						}
 						else {
-							g_patchMap[armo].Resistances->DeleteResistanceVec.push_back(resistance);
+							a_patchMap[armo].Resistances->DeleteResistanceVec.push_back(resistance);
 						}
 					}
 				}
@@ -692,41 +734,92 @@ namespace Armors {
 		}
 	}
 
+	// Lists are captured as a Clear followed by an Add of every entry, so applying the original puts the list back as it
+	// was, in its order
+	void Capture(RE::TESObjectARMO* a_armo, const PatchData& a_patchData, PatchData& a_originalData) {
+		if (a_patchData.ArmorRating.has_value() && !a_originalData.ArmorRating.has_value()) {
+			a_originalData.ArmorRating = a_armo->armorData.rating;
+		}
+		if (a_patchData.BipedObjectSlots.has_value() && !a_originalData.BipedObjectSlots.has_value()) {
+			a_originalData.BipedObjectSlots = a_armo->bipedModelData.bipedObjectSlots;
+		}
+		if (a_patchData.FullName.has_value() && !a_originalData.FullName.has_value()) {
+			a_originalData.FullName = std::string(a_armo->fullName.c_str());
+		}
+		if (a_patchData.Keywords.has_value() && !a_originalData.Keywords.has_value()) {
+			a_originalData.Keywords = PatchData::KeywordsData{ true, std::vector<RE::BGSKeyword*>(a_armo->keywords, a_armo->keywords + a_armo->numKeywords), {} };
+		}
+		if (a_patchData.ObjectEffect.has_value() && !a_originalData.ObjectEffect.has_value()) {
+			a_originalData.ObjectEffect = a_armo->formEnchanting;
+		}
+		if (a_patchData.Resistances.has_value() && !a_originalData.Resistances.has_value()) {
+			a_originalData.Resistances = PatchData::ResistancesData{ true, {}, {} };
+			for (const auto& damageType : *a_armo->armorData.damageTypes) {
+				a_originalData.Resistances->AddResistanceVec.push_back({ damageType.first->As<RE::BGSDamageType>(), static_cast<std::uint32_t>(damageType.second.i) });
+			}
+		}
+	}
+
+	void Patch(RE::TESObjectARMO* a_armo, const PatchData& a_patchData) {
+		if (a_patchData.ArmorRating.has_value()) {
+			a_armo->armorData.rating = a_patchData.ArmorRating.value();
+		}
+		if (a_patchData.BipedObjectSlots.has_value()) {
+			a_armo->bipedModelData.bipedObjectSlots = a_patchData.BipedObjectSlots.value();
+		}
+		if (a_patchData.FullName.has_value()) {
+			a_armo->fullName = a_patchData.FullName.value();
+		}
+		if (a_patchData.Keywords.has_value()) {
+			PatchKeywords(a_armo, a_patchData.Keywords.value());
+		}
+		if (a_patchData.ObjectEffect.has_value()) {
+			a_armo->formEnchanting = a_patchData.ObjectEffect.value();
+		}
+		if (a_patchData.Resistances.has_value()) {
+			PatchResistances(a_armo, a_patchData.Resistances.value());
+		}
+	}
+
+	void ApplyPatches() {
+		ConfigUtils::ApplyPatches(g_appliedPatchMap, g_originalDataMap, std::move(g_patchMap), Capture, [](RE::TESObjectARMO* a_armo, const PatchData& a_patchData) {
+			Patch(a_armo, a_patchData);
+		});
+	}
+
 	void Patch() {
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
 
 		logger::info("======================== Start patching for {} ========================", TypeName);
 
-		for (const auto& patchData : g_patchMap) {
-			if (patchData.second.ArmorRating.has_value()) {
-				patchData.first->armorData.rating = patchData.second.ArmorRating.value();
-			}
-			if (patchData.second.BipedObjectSlots.has_value()) {
-				patchData.first->bipedModelData.bipedObjectSlots = patchData.second.BipedObjectSlots.value();
-			}
-			if (patchData.second.FullName.has_value()) {
-				patchData.first->fullName = patchData.second.FullName.value();
-			}
-			if (patchData.second.Keywords.has_value()) {
-				PatchKeywords(patchData.first, patchData.second.Keywords.value());
-			}
-			if (patchData.second.ObjectEffect.has_value()) {
-				patchData.first->formEnchanting = patchData.second.ObjectEffect.value();
-			}
-			if (patchData.second.Resistances.has_value()) {
-				PatchResistances(patchData.first, patchData.second.Resistances.value());
-			}
-		}
+		ApplyPatches();
 
 		logger::info("======================== Finished patching for {} ========================", TypeName);
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
 	}
+
+	void Reload() {
+		logger::info("======================== Start reloading {} ========================", TypeName);
+
+		ReadConfigs();
+		ConfigUtils::ResolveForms(g_configVec);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
+		ApplyPatches();
+
+		g_configVec.clear();
+		g_arena.Release();
+		g_patchMap.clear();
+
+		logger::info("======================== Finished reloading {} ========================", TypeName);
+		logger::info("");
+	}
 }
@@ -1,7 +1,6 @@
 #include "CObjs.h"
 
 #include <unordered_set>
-#include <regex>
 #include <any>
 
 #include "ConfigUtils.h"
@@ -61,7 +60,7 @@ namespace CObjs {
 	struct ConfigData {
 		struct Operation {
 			struct ComponentData {
-				std::string Form;
+				Utils::FormReference Form;
 				std::uint32_t Count;
 			};
 
@@ -70,12 +69,29 @@ namespace CObjs {
 		};
 
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
-		std::vector<Operation> Operations;
+		Arenas::Vector<Operation> Operations;
 		std::optional<std::any> AssignValue;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation::ComponentData& a_componentData) {
+		a_ar(a_componentData.Form, a_componentData.Count);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation& a_operation) {
+		a_ar(a_operation.OpType);
+		a_ar.template Any<Utils::FormReference, ConfigData::Operation::ComponentData>(a_operation.OpData);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.Operations);
+		a_ar.template Any<Utils::FormReference, std::uint16_t>(a_configData.AssignValue);
+	}
+
 	struct PatchData {
 		struct CategoriesData {
 			bool Clear = false;
@@ -101,6 +117,7 @@ namespace CObjs {
 		std::optional<RE::BGSKeyword*> WorkbenchKeyword;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::BGSKeyword*, std::uint16_t> g_keywordIndexMap;
 	std::unordered_map<RE::BGSConstructibleObject*, PatchData> g_filterByFormIDPatchMap;
@@ -109,6 +126,7 @@ namespace CObjs {
 	class CObjParser : public Parsers::Parser<ConfigData> {
 	public:
 		CObjParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		CObjParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -174,7 +192,7 @@ namespace CObjs {
 				}
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -193,7 +211,7 @@ namespace CObjs {
 
 					case OperationType::kAdd:
 					case OperationType::kDelete:
-						opLog = fmt::format(".{}({})", OperationTypeToString(a_configData.Operations[ii].OpType), std::any_cast<std::string>(a_configData.Operations[ii].OpData.value()));
+						opLog = fmt::format(".{}({})", OperationTypeToString(a_configData.Operations[ii].OpType), std::any_cast<Utils::FormReference>(a_configData.Operations[ii].OpData.value()));
 						break;
 					}
 
@@ -238,7 +256,7 @@ namespace CObjs {
 			case ElementType::kCreatedObject:
 			case ElementType::kWorkbenchKeyword:
 				logger::info("{}{}({}).{} = {};", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm, ElementTypeToString(a_configData.Element),
-					std::any_cast<std::string>(a_configData.AssignValue.value()));
+					std::any_cast<Utils::FormReference>(a_configData.AssignValue.value()));
 				break;
 
 			case ElementType::kCreatedObjectCount:
@@ -250,13 +268,16 @@ namespace CObjs {
 
 		bool ParseFilter(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kFilterByFormID:
 				a_configData.Filter = FilterType::kFormID;
-			}
-			else if (token == "FilterByCategoryKeyword") {
+				break;
+
+			case Symbol::kFilterByCategoryKeyword:
 				a_configData.Filter = FilterType::kCategoryKeyword;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid FilterName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -285,22 +306,28 @@ namespace CObjs {
 
 		bool ParseElement(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "Categories") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kCategories:
 				a_configData.Element = ElementType::kCategories;
-			}
-			else if (token == "Components") {
+				break;
+
+			case Symbol::kComponents:
 				a_configData.Element = ElementType::kComponents;
-			}
-			else if (token == "CreatedObject") {
+				break;
+
+			case Symbol::kCreatedObject:
 				a_configData.Element = ElementType::kCreatedObject;
-			}
-			else if (token == "CreatedObjectCount") {
+				break;
+
+			case Symbol::kCreatedObjectCount:
 				a_configData.Element = ElementType::kCreatedObjectCount;
-			}
-			else if (token == "WorkbenchKeyword") {
+				break;
+
+			case Symbol::kWorkbenchKeyword:
 				a_configData.Element = ElementType::kWorkbenchKeyword;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid ElementName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -317,12 +344,12 @@ namespace CObjs {
 
 			if (a_configData.Element == ElementType::kCreatedObject || a_configData.Element == ElementType::kWorkbenchKeyword) {
 				token = reader.Peek();
-				if (token == "null") {
+				if (reader.GetLastSymbol() == Symbol::kNull) {
 					reader.GetToken();
-					a_configData.AssignValue = std::any(std::string(token));
+					a_configData.AssignValue = std::any(Utils::FormReference{ token });
 				}
 				else {
-					std::optional<std::string> form = ParseForm();
+					std::optional<Utils::FormReference> form = ParseForm();
 					if (!form.has_value()) {
 						return false;
 					}
@@ -363,16 +390,20 @@ namespace CObjs {
 			ConfigData::Operation newOp;
 
 			auto token = reader.GetToken();
-			if (token == "Clear") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kClear:
 				newOp.OpType = OperationType::kClear;
-			}
-			else if (token == "Add") {
+				break;
+
+			case Symbol::kAdd:
 				newOp.OpType = OperationType::kAdd;
-			}
-			else if (token == "Delete") {
+				break;
+
+			case Symbol::kDelete:
 				newOp.OpType = OperationType::kDelete;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid OperationName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -416,7 +447,7 @@ namespace CObjs {
 			switch (a_configData.Element) {
 			case ElementType::kCategories:
 				if (newOp.OpType != OperationType::kClear) {
-					std::optional<std::string> form = ParseForm();
+					std::optional<Utils::FormReference> form = ParseForm();
 					if (!form.has_value()) {
 						return false;
 					}
@@ -433,7 +464,7 @@ namespace CObjs {
 					opData = ConfigData::Operation::ComponentData{};
 
 					if (newOp.OpType == OperationType::kAdd || newOp.OpType == OperationType::kDelete) {
-						std::optional<std::string> form = ParseForm();
+						std::optional<Utils::FormReference> form = ParseForm();
 						if (!form.has_value()) {
 							return false;
 						}
@@ -484,7 +515,11 @@ namespace CObjs {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<CObjParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<CObjParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+	}
+
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
 	}
 
 	void SetKeywordIndexMap() {
@@ -509,9 +544,9 @@ namespace CObjs {
 					a_patchData.Categories->Clear = true;
 				}
 				else if (op.OpType == OperationType::kAdd || op.OpType == OperationType::kDelete) {
-					std::string opForm = std::any_cast<std::string>(op.OpData.value());
+					const Utils::FormReference& opForm = std::any_cast<const Utils::FormReference&>(op.OpData.value());
 
-					RE::TESForm* keywordForm = Utils::GetFormFromString(opForm);
+					RE::TESForm* keywordForm = opForm.Form;
 					if (!keywordForm) {
 						logger::warn("Invalid KeywordForm: '{}'.", opForm);
 						continue;
@@ -550,7 +585,7 @@ namespace CObjs {
 				else if (op.OpType == OperationType::kAdd || op.OpType == OperationType::kDelete) {
 					ConfigData::Operation::ComponentData componentData = std::any_cast<ConfigData::Operation::ComponentData>(op.OpData.value());
 
-					RE::TESForm* form = Utils::GetFormFromString(componentData.Form);
+					RE::TESForm* form = componentData.Form.Form;
 					if (!form) {
 						logger::warn("Invalid Form: '{}'.", componentData.Form);
 						continue;
@@ -566,15 +601,15 @@ namespace CObjs {
 			}
 		}
 		else if (a_configData.Element == ElementType::kCreatedObject) {
-			std::string formStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+			const Utils::FormReference& formRef = std::any_cast<const Utils::FormReference&>(a_configData.AssignValue.value());
 
-			if (formStr == "null") {
+			if (formRef.IsNull()) {
 				a_patchData.CreatedObject = nullptr;
 			}
 			else {
-				RE::TESForm* form = Utils::GetFormFromString(formStr);
+				RE::TESForm* form = formRef.Form;
 				if (!form) {
-					logger::warn("Invalid Form: '{}'.", formStr);
+					logger::warn("Invalid Form: '{}'.", formRef);
 					return;
 				}
 
@@ -585,21 +620,21 @@ namespace CObjs {
 			a_patchData.CreatedObjectCount = std::any_cast<std::uint16_t>(a_configData.AssignValue.value());
 		}
 		else if (a_configData.Element == ElementType::kWorkbenchKeyword) {
-			std::string keywordFormStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+			const Utils::FormReference& keywordFormRef = std::any_cast<const Utils::FormReference&>(a_configData.AssignValue.value());
 
-			if (keywordFormStr == "null") {
+			if (keywordFormRef.IsNull()) {
 				a_patchData.WorkbenchKeyword = nullptr;
 			}
 			else {
-				RE::TESForm* keywordForm = Utils::GetFormFromString(keywordFormStr);
+				RE::TESForm* keywordForm = keywordFormRef.Form;
 				if (!keywordForm) {
-					logger::warn("Invalid Form: '{}'.", keywordFormStr);
+					logger::warn("Invalid Form: '{}'.", keywordFormRef);
 					return;
 				}
 
 				RE::BGSKeyword* keyword = keywordForm->As<RE::BGSKeyword>();
 				if (!keyword) {
-					logger::warn("'{}' is not a Keyword.", keywordFormStr);
+					logger::warn("'{}' is not a Keyword.", keywordFormRef);
 					return;
 				}
 
@@ -609,7 +644,7 @@ namespace CObjs {
 	}
 
 	void PrepareFilterByFormID(const ConfigData& a_configData) {
-		RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+		RE::TESForm* filterForm = a_configData.FilterForm.Form;
 		if (!filterForm) {
 			logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 			return;
@@ -626,7 +661,7 @@ namespace CObjs {
 	}
 
 	void PrepareFilterByCategoryKeyword(const ConfigData& a_configData) {
-		RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+		RE::TESForm* filterForm = a_configData.FilterForm.Form;
 		if (!filterForm) {
 			logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 			return;
@@ -905,6 +940,7 @@ namespace CObjs {
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
 		g_keywordIndexMap.clear();
 		g_filterByFormIDPatchMap.clear();
 		g_filterByCategoryKeywordPatchMap.clear();
@@ -0,0 +1,134 @@
+#include "Caches.h"
+
+#include <fstream>
+
+namespace Caches {
+	namespace {
+		constexpr std::uint32_t CacheMagic = 0x43435054;  // "TPCC"
+
+		// Bump whenever a ConfigData layout, its Serialize function, the layout of cached log messages or the text the parsers
+		// accept changes
+		constexpr std::uint32_t CacheFormatVersion = 9;
+
+		std::uint64_t HashContents(std::string_view a_contents) {
+			std::uint64_t hash = 0xCBF29CE484222325;
+			for (unsigned char ch : a_contents) {
+				hash ^= ch;
+				hash *= 0x100000001B3;
+			}
+
+			return hash;
+		}
+	}
+
+	std::optional<Fingerprint> GetFingerprint(const std::filesystem::path& a_path) {
+		std::error_code ec;
+
+		Fingerprint fingerprint;
+
+		fingerprint.Size = std::filesystem::file_size(a_path, ec);
+		if (ec) {
+			return std::nullopt;
+		}
+
+		fingerprint.WriteTime = static_cast<std::int64_t>(std::filesystem::last_write_time(a_path, ec).time_since_epoch().count());
+		if (ec) {
+			return std::nullopt;
+		}
+
+		// Empty files cannot be mapped
+		if (fingerprint.Size == 0) {
+			fingerprint.Hash = HashContents({});
+			return fingerprint;
+		}
+
+		mmio::mapped_file_source mappedFile;
+		if (!mappedFile.open(a_path)) {
+			return std::nullopt;
+		}
+
+		fingerprint.Hash = HashContents(std::string_view(reinterpret_cast<const char*>(mappedFile.data()), mappedFile.size()));
+		return fingerprint;
+	}
+
+	ConfigCache::ConfigCache(std::string_view a_configType) :
+		_cachePath(std::filesystem::path{ "Data\\" + std::string(Version::PROJECT) } / "Cache" / (std::string(a_configType) + ".bin")) {
+		std::ifstream cacheFile(_cachePath, std::ios::binary | std::ios::ate);
+		if (!cacheFile.is_open()) {
+			return;
+		}
+
+		std::string fileContents(static_cast<std::size_t>(cacheFile.tellg()), '\0');
+		cacheFile.seekg(0, std::ios::beg);
+		if (!cacheFile.read(fileContents.data(), static_cast<std::streamsize>(fileContents.size()))) {
+			return;
+		}
+
+		Reader reader(fileContents);
+
+		std::uint32_t magic = 0;
+		std::uint32_t formatVersion = 0;
+		std::string pluginVersion;
+		bool hasStatementLog = false;
+		reader(magic, formatVersion, pluginVersion, hasStatementLog);
+		if (reader.Failed() || magic != CacheMagic || formatVersion != CacheFormatVersion || pluginVersion != Version::NAME) {
+			return;
+		}
+
+		// A cache written while statements were not logged lacks their output
+		if (!hasStatementLog && Logs::GetStatementLog() != Logs::StatementLog::kNone) {
+			return;
+		}
+
+		std::vector<Entry> entries;
+		reader(entries);
+		if (reader.Failed()) {
+			return;
+		}
+
+		for (auto& entry : entries) {
+			std::string path = entry.Path;
+			_entries.emplace(std::move(path), std::move(entry));
+		}
+	}
+
+	const ConfigCache::Entry* ConfigCache::Find(const std::string& a_path, const Fingerprint& a_fingerprint) const {
+		auto it = _entries.find(a_path);
+		if (it == _entries.end() || it->second.Fingerprint != a_fingerprint) {
+			return nullptr;
+		}
+
+		return &it->second;
+	}
+
+	void ConfigCache::Save(std::vector<Entry>& a_entries) const {
+		Writer writer;
+
+		std::uint32_t magic = CacheMagic;
+		std::uint32_t formatVersion = CacheFormatVersion;
+		std::string pluginVersion(Version::NAME);
+		bool hasStatementLog = Logs::GetStatementLog() != Logs::StatementLog::kNone;
+		writer(magic, formatVersion, pluginVersion, hasStatementLog, a_entries);
+
+		// Written beside the old cache and swapped in, so that an interrupted write never leaves a truncated cache behind
+		std::error_code ec;
+		std::filesystem::create_directories(_cachePath.parent_path(), ec);
+
+		auto tempPath = _cachePath;
+		tempPath += ".tmp";
+
+		{
+			std::ofstream cacheFile(tempPath, std::ios::binary | std::ios::trunc);
+			if (!cacheFile.is_open() || !cacheFile.write(writer.Data().data(), static_cast<std::streamsize>(writer.Data().size()))) {
+				logger::warn("Cannot write the config cache: {}", _cachePath.string());
+				return;
+			}
+		}
+
+		std::filesystem::rename(tempPath, _cachePath, ec);
+		if (ec) {
+			logger::warn("Cannot write the config cache: {}", _cachePath.string());
+			std::filesystem::remove(tempPath, ec);
+		}
+	}
+}
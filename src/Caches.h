@@ -0,0 +1,394 @@
+#pragma once
+
+#include <any>
+#include <variant>
+
+#include "Arenas.h"
+#include "Logs.h"
+#include "Utils.h"
+
+namespace Caches {
+	// Identifies one revision of a config file; any difference forces the file to be parsed again
+	struct Fingerprint {
+		std::uint64_t Size = 0;
+		std::int64_t WriteTime = 0;
+		std::uint64_t Hash = 0;
+
+		bool operator==(const Fingerprint&) const = default;
+	};
+
+	std::optional<Fingerprint> GetFingerprint(const std::filesystem::path& a_path);
+
+	template <typename T>
+	struct IsOptional : std::false_type {};
+
+	template <typename T>
+	struct IsOptional<std::optional<T>> : std::true_type {};
+
+	template <typename T>
+	struct IsVector : std::false_type {};
+
+	template <typename T, typename A>
+	struct IsVector<std::vector<T, A>> : std::true_type {};
+
+	template <typename T>
+	struct IsPair : std::false_type {};
+
+	template <typename T1, typename T2>
+	struct IsPair<std::pair<T1, T2>> : std::true_type {};
+
+	template <typename T>
+	struct IsVariant : std::false_type {};
+
+	template <typename... Ts>
+	struct IsVariant<std::variant<Ts...>> : std::true_type {};
+
+	// Appends values to a byte buffer. Class types are written through a Serialize(a_ar, a_value) overload found by ADL,
+	// which is shared with Reader so that both directions always agree on the layout.
+	class Writer {
+	public:
+		template <typename... Ts>
+		void operator()(Ts&... a_values) {
+			(Process(a_values), ...);
+		}
+
+		template <typename T>
+		void Process(T& a_value) {
+			if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+				WriteBytes(&a_value, sizeof(T));
+			}
+			else if constexpr (std::is_same_v<T, std::monostate>) {
+			}
+			else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) {
+				WriteSize(a_value.size());
+				WriteBytes(a_value.data(), a_value.size());
+			}
+			else if constexpr (std::is_same_v<T, spdlog::details::log_msg_buffer>) {
+				// The logger name tells statement output apart, so it is kept for Logs::CaptureSink to route on replay
+				std::uint8_t level = static_cast<std::uint8_t>(a_value.level);
+				Process(level);
+				WriteSize(a_value.logger_name.size());
+				WriteBytes(a_value.logger_name.data(), a_value.logger_name.size());
+				WriteSize(a_value.payload.size());
+				WriteBytes(a_value.payload.data(), a_value.payload.size());
+			}
+			else if constexpr (std::is_same_v<T, Utils::FormKey>) {
+				// Ordinals only hold for the current launch, so the names they stand for are written instead
+				std::string_view pluginName = Utils::GetPluginName(a_value.GetPluginOrdinal());
+				bool isEditorID = a_value.IsEditorID();
+				Process(pluginName);
+				Process(isEditorID);
+
+				if (isEditorID) {
+					std::string_view editorID = Utils::GetEditorID(a_value.GetEditorIDOrdinal());
+					Process(editorID);
+				}
+				else {
+					std::uint32_t localID = a_value.GetLocalID();
+					Process(localID);
+				}
+			}
+			else if constexpr (IsOptional<T>::value) {
+				bool hasValue = a_value.has_value();
+				Process(hasValue);
+				if (hasValue) {
+					Process(a_value.value());
+				}
+			}
+			else if constexpr (IsVector<T>::value) {
+				WriteSize(a_value.size());
+				for (auto& element : a_value) {
+					Process(element);
+				}
+			}
+			else if constexpr (IsPair<T>::value) {
+				Process(a_value.first);
+				Process(a_value.second);
+			}
+			else if constexpr (IsVariant<T>::value) {
+				std::uint8_t typeIndex = static_cast<std::uint8_t>(a_value.index());
+				Process(typeIndex);
+				std::visit([this](auto& a_alternative) { Process(a_alternative); }, a_value);
+			}
+			else {
+				Serialize(*this, a_value);
+			}
+		}
+
+		// std::any keeps no layout of its own, so the caller lists every type the value may hold
+		template <typename... Ts>
+		void Any(std::any& a_value) {
+			std::uint8_t typeIndex = 0;
+			if (a_value.has_value()) {
+				std::uint8_t index = 1;
+				static_cast<void>(((a_value.type() == typeid(Ts) ? (typeIndex = index, true) : (++index, false)) || ...));
+				if (typeIndex == 0) {
+					_failed = true;
+					return;
+				}
+			}
+
+			Process(typeIndex);
+
+			std::uint8_t index = 1;
+			static_cast<void>(((typeIndex == index++ ? (Process(*std::any_cast<Ts>(&a_value)), true) : false) || ...));
+		}
+
+		template <typename... Ts>
+		void Any(std::optional<std::any>& a_value) {
+			bool hasValue = a_value.has_value();
+			Process(hasValue);
+			if (hasValue) {
+				Any<Ts...>(a_value.value());
+			}
+		}
+
+		bool Failed() const { return _failed; }
+		std::string& Data() { return _data; }
+
+	private:
+		void WriteSize(std::size_t a_size) {
+			std::uint32_t size = static_cast<std::uint32_t>(a_size);
+			Process(size);
+		}
+
+		void WriteBytes(const void* a_bytes, std::size_t a_length) {
+			_data.append(static_cast<const char*>(a_bytes), a_length);
+		}
+
+		std::string _data;
+		bool _failed = false;
+	};
+
+	// Reads values back in the order Writer appended them. Running past the end of the data marks the reader as
+	// failed instead of throwing, and every value read afterwards is left default constructed.
+	class Reader {
+	public:
+		Reader(std::string_view a_data) : _data(a_data) {}
+
+		template <typename... Ts>
+		void operator()(Ts&... a_values) {
+			(Process(a_values), ...);
+		}
+
+		template <typename T>
+		void Process(T& a_value) {
+			if (_failed) {
+				return;
+			}
+
+			if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+				ReadBytes(&a_value, sizeof(T));
+			}
+			else if constexpr (std::is_same_v<T, std::monostate>) {
+			}
+			else if constexpr (std::is_same_v<T, std::string>) {
+				a_value = std::string(ReadString());
+			}
+			else if constexpr (std::is_same_v<T, std::string_view>) {
+				// The cache data is freed once loading is done, so the text is moved into the current arena
+				a_value = Arenas::StoreString({ ReadString() });
+			}
+			else if constexpr (std::is_same_v<T, spdlog::details::log_msg_buffer>) {
+				std::uint8_t level = 0;
+				Process(level);
+				std::string_view loggerName = ReadString();
+				std::string_view payload = ReadString();
+				if (!_failed) {
+					a_value = spdlog::details::log_msg_buffer(spdlog::details::log_msg(spdlog::source_loc{}, loggerName,
+						static_cast<spdlog::level::level_enum>(level), payload));
+				}
+			}
+			else if constexpr (std::is_same_v<T, Utils::FormKey>) {
+				std::string_view pluginName = ReadString();
+				bool isEditorID = false;
+				Process(isEditorID);
+
+				if (isEditorID) {
+					std::string_view editorID = ReadString();
+					if (!_failed) {
+						a_value = Utils::MakeEditorIDKey(pluginName, editorID);
+					}
+				}
+				else {
+					std::uint32_t localID = 0;
+					Process(localID);
+					if (!_failed) {
+						a_value = Utils::MakeFormKey(pluginName, localID);
+					}
+				}
+			}
+			else if constexpr (IsOptional<T>::value) {
+				bool hasValue = false;
+				Process(hasValue);
+				if (hasValue) {
+					Process(a_value.emplace());
+				}
+				else {
+					a_value.reset();
+				}
+			}
+			else if constexpr (IsVector<T>::value) {
+				std::uint32_t size = ReadSize();
+				a_value.clear();
+				a_value.reserve(size);
+				for (std::uint32_t ii = 0; ii < size && !_failed; ii++) {
+					Process(a_value.emplace_back());
+				}
+			}
+			else if constexpr (IsPair<T>::value) {
+				Process(a_value.first);
+				Process(a_value.second);
+			}
+			else if constexpr (IsVariant<T>::value) {
+				std::uint8_t typeIndex = 0;
+				Process(typeIndex);
+				if (!_failed) {
+					ProcessVariant(a_value, typeIndex, std::make_index_sequence<std::variant_size_v<T>>{});
+				}
+			}
+			else {
+				Serialize(*this, a_value);
+			}
+		}
+
+		template <typename... Ts>
+		void Any(std::any& a_value) {
+			std::uint8_t typeIndex = 0;
+			Process(typeIndex);
+			if (_failed) {
+				return;
+			}
+
+			a_value.reset();
+			if (typeIndex == 0) {
+				return;
+			}
+
+			std::uint8_t index = 1;
+			bool found = ((typeIndex == index++ ? (Process(a_value.emplace<Ts>()), true) : false) || ...);
+			if (!found) {
+				_failed = true;
+			}
+		}
+
+		template <typename... Ts>
+		void Any(std::optional<std::any>& a_value) {
+			bool hasValue = false;
+			Process(hasValue);
+			if (hasValue) {
+				Any<Ts...>(a_value.emplace());
+			}
+			else {
+				a_value.reset();
+			}
+		}
+
+		bool Failed() const { return _failed; }
+
+	private:
+		template <typename T, std::size_t... Is>
+		void ProcessVariant(T& a_value, std::uint8_t a_typeIndex, std::index_sequence<Is...>) {
+			bool found = ((a_typeIndex == Is ? (Process(a_value.template emplace<Is>()), true) : false) || ...);
+			if (!found) {
+				_failed = true;
+			}
+		}
+
+		std::uint32_t ReadSize() {
+			std::uint32_t size = 0;
+			Process(size);
+
+			// Every element takes at least one byte, which keeps a damaged size from reserving a huge buffer
+			if (size > _data.length() - _index) {
+				_failed = true;
+				return 0;
+			}
+
+			return size;
+		}
+
+		std::string_view ReadString() {
+			std::uint32_t length = ReadSize();
+			if (_failed) {
+				return {};
+			}
+
+			auto retStr = _data.substr(_index, length);
+			_index += length;
+			return retStr;
+		}
+
+		void ReadBytes(void* a_bytes, std::size_t a_length) {
+			if (a_length > _data.length() - _index) {
+				_failed = true;
+				return;
+			}
+
+			std::memcpy(a_bytes, _data.data() + _index, a_length);
+			_index += a_length;
+		}
+
+		std::string_view _data;
+		std::size_t _index = 0;
+		bool _failed = false;
+	};
+
+	// Parsed statements and log output of every config file of one type, stored in Data\TullPatcherF4\Cache
+	class ConfigCache {
+	public:
+		struct Entry {
+			std::string Path;
+			Caches::Fingerprint Fingerprint;
+			std::string Data;
+		};
+
+		ConfigCache(std::string_view a_configType);
+
+		// Returns the stored entry for a_path, or nullptr if the file was not cached at this revision
+		const Entry* Find(const std::string& a_path, const Fingerprint& a_fingerprint) const;
+
+		std::size_t Size() const { return _entries.size(); }
+
+		// Replaces the cache file with a_entries
+		void Save(std::vector<Entry>& a_entries) const;
+
+	private:
+		std::filesystem::path _cachePath;
+		std::unordered_map<std::string, Entry> _entries;
+	};
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, Fingerprint& a_fingerprint) {
+		a_ar(a_fingerprint.Size, a_fingerprint.WriteTime, a_fingerprint.Hash);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigCache::Entry& a_entry) {
+		a_ar(a_entry.Path, a_entry.Fingerprint, a_entry.Data);
+	}
+
+	template <typename StatementT>
+	std::optional<std::string> StoreStatements(std::vector<StatementT>& a_statements, Logs::Buffer& a_log) {
+		Writer writer;
+		writer(a_statements, a_log);
+		if (writer.Failed()) {
+			return std::nullopt;
+		}
+
+		return std::move(writer.Data());
+	}
+
+	template <typename StatementT>
+	bool LoadStatements(std::string_view a_data, std::vector<StatementT>& a_statements, Logs::Buffer& a_log) {
+		Reader reader(a_data);
+		reader(a_statements, a_log);
+		if (reader.Failed()) {
+			a_statements.clear();
+			a_log.clear();
+			return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,104 @@
+#include "ConfigUtils.h"
+
+namespace ConfigUtils {
+	namespace {
+		std::once_flag g_configIndexOnce;
+		ConfigIndex g_configIndex;
+
+		std::string ToLower(std::string_view a_str) {
+			std::string retStr(a_str);
+			std::transform(retStr.begin(), retStr.end(), retStr.begin(), [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+			return retStr;
+		}
+
+		bool IsConfigFileName(std::basic_string_view<std::filesystem::path::value_type> a_fileName) {
+			using CharT = std::filesystem::path::value_type;
+
+			constexpr std::string_view extension = ".cfg";
+			if (a_fileName.length() < extension.length()) {
+				return false;
+			}
+
+			auto suffix = a_fileName.substr(a_fileName.length() - extension.length());
+			for (std::size_t ii = 0; ii < extension.length(); ii++) {
+				CharT ch = suffix[ii];
+				if (ch >= 'A' && ch <= 'Z') {
+					ch = static_cast<CharT>(ch - 'A' + 'a');
+				}
+
+				if (ch != static_cast<CharT>(extension[ii])) {
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		void BuildConfigIndex() {
+			g_configIndex = ScanConfigPaths();
+		}
+	}
+
+	ConfigIndex ScanConfigPaths() {
+		ConfigIndex retIndex;
+
+		const std::filesystem::path configRoot{ "Data\\" + std::string(Version::PROJECT) };
+
+		std::error_code ec;
+		if (!std::filesystem::is_directory(configRoot, ec)) {
+			return retIndex;
+		}
+
+		for (auto it = std::filesystem::recursive_directory_iterator(configRoot, std::filesystem::directory_options::skip_permission_denied, ec);
+			 it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+			if (ec) {
+				break;
+			}
+
+			// Only files inside a type folder are configs; anything directly under the root is ignored
+			if (it.depth() == 0 || !it->is_regular_file(ec)) {
+				continue;
+			}
+
+			const auto& path = it->path();
+
+			if (!IsConfigFileName(path.filename().native())) {
+				continue;
+			}
+
+			auto typeFolder = path.lexically_relative(configRoot).begin()->string();
+			retIndex[ToLower(typeFolder)].push_back(path);
+		}
+
+		for (auto& configPaths : retIndex) {
+			std::sort(configPaths.second.begin(), configPaths.second.end());
+		}
+
+		return retIndex;
+	}
+
+	const std::vector<std::filesystem::path>& GetConfigPaths(std::string_view a_configType) {
+		static const std::vector<std::filesystem::path> empty;
+
+		std::call_once(g_configIndexOnce, BuildConfigIndex);
+
+		auto it = g_configIndex.find(ToLower(a_configType));
+		if (it == g_configIndex.end()) {
+			return empty;
+		}
+
+		return it->second;
+	}
+
+	void RescanConfigPaths() {
+		bool scanned = false;
+		std::call_once(g_configIndexOnce, [&scanned]() {
+			BuildConfigIndex();
+			scanned = true;
+		});
+
+		if (!scanned) {
+			BuildConfigIndex();
+		}
+	}
+}
@@ -1,44 +1,296 @@
 #pragma once
 
+#include <execution>
+#include <numeric>
+
+#include "Arenas.h"
+#include "Caches.h"
+#include "Logs.h"
 #include "Parsers.h"
+#include "Settings.h"
+#include "Utils.h"
 
 namespace ConfigUtils {
+	// Config files under Data\TullPatcherF4, keyed by the lowercase name of their type folder and sorted by path
+	using ConfigIndex = std::unordered_map<std::string, std::vector<std::filesystem::path>>;
+
+	ConfigIndex ScanConfigPaths();
+
+	const std::vector<std::filesystem::path>& GetConfigPaths(std::string_view a_configType);
+
+	// Picks up added and removed files; must not run while configs are being read
+	void RescanConfigPaths();
+
+	// Configs larger than this are cut into chunks of about this size, which are parsed concurrently
+	constexpr std::size_t ParseChunkSize = 1024 * 1024;
+
+	// Chunks are merged in order and nothing after a chunk that failed to parse is kept, so the result and the log are
+	// the same as if the file had been parsed from start to end by one parser
 	template <typename ParserT, typename StatementT>
-	inline std::vector<StatementT> ReadConfigs(std::string_view a_configType) {
-		const std::filesystem::path configDir{ "Data\\" + std::string(Version::PROJECT) + "\\" + std::string(a_configType) };
-		if (!std::filesystem::exists(configDir)) {
+	inline std::vector<StatementT> ParseConfig(const std::string& a_path, Arenas::Arena& a_arena, Logs::Buffer& a_log) {
+		ParserT parser(a_path);
+
+		auto chunks = parser.Split(ParseChunkSize);
+		if (chunks.size() <= 1) {
+			Logs::ScopedCapture capture(a_log);
+			return parser.Parse();
+		}
+
+		struct ChunkResult {
+			std::vector<StatementT> Statements;
+			Logs::Buffer Log;
+			bool Failed = false;
+		};
+
+		std::vector<ChunkResult> chunkResults(chunks.size());
+
+		std::vector<std::size_t> chunkIndices(chunks.size());
+		std::iota(chunkIndices.begin(), chunkIndices.end(), std::size_t{ 0 });
+
+		std::for_each(std::execution::par, chunkIndices.begin(), chunkIndices.end(), [&](std::size_t a_chunkIndex) {
+			ChunkResult& chunkResult = chunkResults[a_chunkIndex];
+
+			Arenas::ScopedArena arenaScope(a_arena);
+			Logs::ScopedCapture capture(chunkResult.Log);
+
+			ParserT chunkParser(chunks[a_chunkIndex]);
+			chunkResult.Statements = chunkParser.Parse();
+			chunkResult.Failed = chunkParser.Failed();
+		});
+
+		std::vector<StatementT> retVec;
+
+		for (auto& chunkResult : chunkResults) {
+			a_log.insert(a_log.end(), std::make_move_iterator(chunkResult.Log.begin()), std::make_move_iterator(chunkResult.Log.end()));
+			retVec.insert(retVec.end(), std::make_move_iterator(chunkResult.Statements.begin()), std::make_move_iterator(chunkResult.Statements.end()));
+
+			if (chunkResult.Failed) {
+				break;
+			}
+		}
+
+		return retVec;
+	}
+
+	// Statement trees are allocated from a_arena, which must outlive the returned statements
+	template <typename ParserT, typename StatementT>
+	inline std::vector<StatementT> ReadConfigs(std::string_view a_configType, Arenas::Arena& a_arena) {
+		// Config files are listed by a single scan of the data folder shared by all record types,
+		// already sorted so that the patch order and the log stay reproducible
+		const auto& configPaths = GetConfigPaths(a_configType);
+		if (configPaths.empty()) {
 			return {};
 		}
 
+		// Files that have not changed since the last launch are loaded from the cache instead of being parsed again
+		Caches::ConfigCache configCache(a_configType);
+
+		// Files are parsed concurrently, each into its own slot, and merged back in path order
+		struct ParseResult {
+			std::vector<StatementT> Statements;
+			Logs::Buffer Log;
+			const Caches::ConfigCache::Entry* CachedEntry = nullptr;
+			std::optional<Caches::ConfigCache::Entry> NewEntry;
+		};
+
+		std::vector<ParseResult> parseResults(configPaths.size());
+
+		std::vector<std::size_t> fileIndices(configPaths.size());
+		std::iota(fileIndices.begin(), fileIndices.end(), std::size_t{ 0 });
+
+		std::for_each(std::execution::par, fileIndices.begin(), fileIndices.end(), [&](std::size_t a_fileIndex) {
+			ParseResult& parseResult = parseResults[a_fileIndex];
+
+			Arenas::ScopedArena arenaScope(a_arena);
+
+			std::string path = configPaths[a_fileIndex].string();
+
+			auto fingerprint = Caches::GetFingerprint(configPaths[a_fileIndex]);
+			if (fingerprint.has_value()) {
+				const auto* cachedEntry = configCache.Find(path, fingerprint.value());
+				if (cachedEntry && Caches::LoadStatements(cachedEntry->Data, parseResult.Statements, parseResult.Log)) {
+					parseResult.CachedEntry = cachedEntry;
+					return;
+				}
+			}
+
+			{
+				Logs::ScopedCapture capture(parseResult.Log);
+				logger::info("=========== Reading {} config file: {} ===========", a_configType, path);
+			}
+
+			parseResult.Statements = ParseConfig<ParserT, StatementT>(path, a_arena, parseResult.Log);
+
+			{
+				Logs::ScopedCapture capture(parseResult.Log);
+				logger::info("");
+			}
+
+			if (fingerprint.has_value()) {
+				auto data = Caches::StoreStatements(parseResult.Statements, parseResult.Log);
+				if (data.has_value()) {
+					parseResult.NewEntry = Caches::ConfigCache::Entry{ path, fingerprint.value(), std::move(data.value()) };
+				}
+			}
+		});
+
 		std::vector<StatementT> retVec;
 
-		static const std::regex filter(".*\\.cfg", std::regex_constants::icase);
+		bool cacheChanged = configCache.Size() != configPaths.size();
+
+		for (auto& parseResult : parseResults) {
+			Logs::Replay(parseResult.Log);
+			retVec.insert(retVec.end(), std::make_move_iterator(parseResult.Statements.begin()), std::make_move_iterator(parseResult.Statements.end()));
+
+			if (!parseResult.CachedEntry) {
+				cacheChanged = true;
+			}
+		}
+
+		if (cacheChanged) {
+			std::vector<Caches::ConfigCache::Entry> cacheEntries;
+			for (auto& parseResult : parseResults) {
+				if (parseResult.CachedEntry) {
+					cacheEntries.push_back(*parseResult.CachedEntry);
+				}
+				else if (parseResult.NewEntry.has_value()) {
+					cacheEntries.push_back(std::move(parseResult.NewEntry.value()));
+				}
+			}
+
+			configCache.Save(cacheEntries);
+		}
+
+		return retVec;
+	}
+
+	// Applies a_patchMap on top of a_appliedMap, the patches currently in effect, and makes it the new a_appliedMap. Only
+	// forms whose patch changed are touched. Before a field of a form is first patched, a_capture copies its value into
+	// a_originalMap, and a form whose patch changed or was removed gets those values back before its new patch is applied.
+	// With reloading turned off nothing is ever restored, so a_patchMap is applied as is and neither map is kept.
+	//   a_capture(form, patchData, original): sets every field of original that patchData sets and original does not
+	//   a_apply(form, patchData): writes every field that patchData sets
+	template <typename FormT, typename PatchDataT, typename CaptureF, typename ApplyF>
+	inline void ApplyPatches(std::unordered_map<FormT*, PatchDataT>& a_appliedMap, std::unordered_map<FormT*, PatchDataT>& a_originalMap,
+		std::unordered_map<FormT*, PatchDataT>&& a_patchMap, CaptureF a_capture, ApplyF a_apply) {
+		if (Settings::GetReloadPollInterval().count() == 0) {
+			for (const auto& [form, patchData] : a_patchMap) {
+				a_apply(form, patchData);
+			}
+			return;
+		}
 
-		for (const auto& entry : std::filesystem::recursive_directory_iterator(configDir)) {
-			if (!std::filesystem::is_regular_file(entry.status())) {
+		for (const auto& [form, appliedPatch] : a_appliedMap) {
+			auto it = a_patchMap.find(form);
+			if (it != a_patchMap.end() && it->second == appliedPatch) {
 				continue;
 			}
 
-			if (!std::regex_match(entry.path().filename().string(), filter)) {
+			a_apply(form, a_originalMap[form]);
+		}
+
+		for (const auto& [form, patchData] : a_patchMap) {
+			auto it = a_appliedMap.find(form);
+			if (it != a_appliedMap.end() && it->second == patchData) {
 				continue;
 			}
 
-			std::string path = entry.path().string();
-			logger::info("=========== Reading {} config file: {} ===========", a_configType, path);
+			a_capture(form, patchData, a_originalMap[form]);
+			a_apply(form, patchData);
+		}
 
-			ParserT parser(path);
-			auto parsedStatements = parser.Parse();
+		a_appliedMap = std::move(a_patchMap);
+	}
 
-			retVec.insert(retVec.end(), parsedStatements.begin(), parsedStatements.end());
+	// Walks a config through its Serialize overloads, as Caches::Writer does, and keeps a pointer to every form reference
+	// it meets, so that ResolveForms can fill them in
+	class FormCollector {
+	public:
+		FormCollector(std::vector<Utils::FormReference*>& a_formReferences) : _formReferences(a_formReferences) {}
 
-			logger::info("");
+		template <typename... Ts>
+		void operator()(Ts&... a_values) {
+			(Process(a_values), ...);
 		}
 
-		return retVec;
+		template <typename T>
+		void Process(T& a_value) {
+			if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_same_v<T, std::monostate> ||
+				std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) {
+			}
+			else if constexpr (std::is_same_v<T, Utils::FormReference>) {
+				if (!a_value.IsNull()) {
+					_formReferences.push_back(&a_value);
+				}
+			}
+			else if constexpr (Caches::IsOptional<T>::value) {
+				if (a_value.has_value()) {
+					Process(a_value.value());
+				}
+			}
+			else if constexpr (Caches::IsVector<T>::value) {
+				for (auto& element : a_value) {
+					Process(element);
+				}
+			}
+			else if constexpr (Caches::IsPair<T>::value) {
+				Process(a_value.first);
+				Process(a_value.second);
+			}
+			else if constexpr (Caches::IsVariant<T>::value) {
+				std::visit([this](auto& a_alternative) { Process(a_alternative); }, a_value);
+			}
+			else {
+				Serialize(*this, a_value);
+			}
+		}
+
+		template <typename... Ts>
+		void Any(std::any& a_value) {
+			static_cast<void>(((a_value.type() == typeid(Ts) ? (Process(*std::any_cast<Ts>(&a_value)), true) : false) || ...));
+		}
+
+		template <typename... Ts>
+		void Any(std::optional<std::any>& a_value) {
+			if (a_value.has_value()) {
+				Any<Ts...>(a_value.value());
+			}
+		}
+
+	private:
+		std::vector<Utils::FormReference*>& _formReferences;
+	};
+
+	// Gathers the form references of the branches Prepare will take
+	template <typename StatementT, typename AllocatorT>
+	inline void CollectForms(std::vector<StatementT, AllocatorT>& a_configVec, FormCollector& a_collector) {
+		for (auto& configData : a_configVec) {
+			if (configData.Type == Parsers::StatementType::kExpression) {
+				a_collector.Process(configData.ExpressionStatement.value());
+			}
+			else if (configData.Type == Parsers::StatementType::kConditional) {
+				CollectForms(configData.ConditionalStatement->Evaluates(), a_collector);
+			}
+		}
+	}
+
+	template <typename StatementT>
+	inline void CollectForms(std::vector<StatementT>& a_configVec, std::vector<Utils::FormReference*>& a_formReferences) {
+		FormCollector collector(a_formReferences);
+		CollectForms(a_configVec, collector);
+	}
+
+	// Resolves the form references of a single record type, for record types prepared outside the shared pass
+	template <typename StatementT>
+	inline void ResolveForms(std::vector<StatementT>& a_configVec) {
+		std::vector<Utils::FormReference*> formReferences;
+		CollectForms(a_configVec, formReferences);
+		Utils::ResolveForms(formReferences);
 	}
 
-	template <typename StatementT, typename PrepareF>
-	inline void Prepare(const std::vector<StatementT>& a_configVec, PrepareF a_prepareFunc) {
+	// Branches are Arenas::Vectors, so the allocator is deduced along with the statement type
+	template <typename StatementT, typename AllocatorT, typename PrepareF>
+	inline void Prepare(const std::vector<StatementT, AllocatorT>& a_configVec, PrepareF a_prepareFunc) {
 		for (const auto& configData : a_configVec) {
 			if (configData.Type == Parsers::StatementType::kExpression) {
 				a_prepareFunc(configData.ExpressionStatement.value());
@@ -48,4 +300,84 @@ namespace ConfigUtils {
 			}
 		}
 	}
+
+	// Record types are prepared on one thread until every shard would get at least this many statements
+	constexpr std::size_t PrepareShardSize = 1024;
+
+	// Prepares the taken statements of a_configVec into a_patchMap on worker threads. Every statement patches only the
+	// form it filters by, so statements are sharded by that form: a shard sees all statements for its forms in their
+	// original order and fills a patch map of its own. The shard maps hold disjoint forms and are moved into a_patchMap in
+	// the order a serial run would have inserted them, and messages are logged in statement order.
+	//   a_prepareFunc(configData, patchMap): prepares one statement into patchMap
+	template <typename StatementT, typename AllocatorT, typename PatchMapT, typename PrepareF>
+	inline void Prepare(const std::vector<StatementT, AllocatorT>& a_configVec, PatchMapT& a_patchMap, PrepareF a_prepareFunc) {
+		using ConfigDataT = std::remove_cvref_t<decltype(std::declval<const StatementT&>().ExpressionStatement.value())>;
+		using FormT = std::remove_pointer_t<typename PatchMapT::key_type>;
+
+		std::vector<const ConfigDataT*> configDataVec;
+		Prepare(a_configVec, [&configDataVec](const ConfigDataT& a_configData) {
+			configDataVec.push_back(&a_configData);
+		});
+
+		std::size_t shardCount = std::min<std::size_t>(std::thread::hardware_concurrency(), configDataVec.size() / PrepareShardSize);
+
+		// Shards could not see entries that are already there, so those are prepared serially as well
+		if (shardCount <= 1 || !a_patchMap.empty()) {
+			for (const ConfigDataT* configData : configDataVec) {
+				a_prepareFunc(*configData, a_patchMap);
+			}
+			return;
+		}
+
+		struct Shard {
+			std::vector<std::size_t> Indices;
+			PatchMapT PatchMap;
+		};
+
+		std::vector<Shard> shards(shardCount);
+		std::vector<FormT*> forms(configDataVec.size());
+		std::vector<std::size_t> shardIndices(configDataVec.size());
+
+		for (std::size_t ii = 0; ii < configDataVec.size(); ii++) {
+			RE::TESForm* filterForm = configDataVec[ii]->FilterForm.Form;
+			forms[ii] = filterForm ? filterForm->As<FormT>() : nullptr;
+
+			// Forms are aligned, so the low bits of their addresses are mixed in before picking a shard
+			auto address = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(forms[ii]));
+			shardIndices[ii] = static_cast<std::size_t>(((address * 0x9E3779B97F4A7C15) >> 32) % shardCount);
+			shards[shardIndices[ii]].Indices.push_back(ii);
+		}
+
+		std::vector<Logs::Buffer> logs(configDataVec.size());
+		std::vector<std::uint8_t> insertedForms(configDataVec.size());
+
+		std::for_each(std::execution::par, shards.begin(), shards.end(), [&](Shard& a_shard) {
+			for (std::size_t index : a_shard.Indices) {
+				std::size_t sizeBefore = a_shard.PatchMap.size();
+
+				{
+					Logs::ScopedCapture capture(logs[index]);
+					a_prepareFunc(*configDataVec[index], a_shard.PatchMap);
+				}
+
+				insertedForms[index] = a_shard.PatchMap.size() > sizeBefore;
+			}
+		});
+
+		for (std::size_t ii = 0; ii < configDataVec.size(); ii++) {
+			Logs::Replay(logs[ii]);
+
+			if (insertedForms[ii]) {
+				auto node = shards[shardIndices[ii]].PatchMap.extract(forms[ii]);
+				if (!node.empty()) {
+					a_patchMap.insert(std::move(node));
+				}
+			}
+		}
+
+		// Only entries keyed by something other than the filter form are left, should a record type add any
+		for (auto& shard : shards) {
+			a_patchMap.merge(shard.PatchMap);
+		}
+	}
 }
@@ -1,148 +1,360 @@
 #include "Configs.h"
 
+#include <bit>
 #include <fstream>
 
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__)
+#	include <emmintrin.h>
+#endif
+
 #include "Utils.h"
 
 namespace Configs {
-	ConfigReader::ConfigReader(std::string_view a_path) : _currentTokenIndex(0), _lastTokenIndex(0) {
-		std::ifstream configFile(std::string(a_path).c_str());
-		if (!configFile.is_open()) {
+	namespace {
+		enum CharClass : std::uint8_t {
+			kSpace = 1 << 0,  // isspace() except '\n'
+			kNewline = 1 << 1,
+			kComment = 1 << 2,
+			kQuote = 1 << 3,
+			kDelimiter = 1 << 4
+		};
+
+		constexpr std::array<std::uint8_t, 256> CharClasses = [] {
+			std::array<std::uint8_t, 256> table{};
+			for (unsigned char ch : " \t\v\f\r"sv) {
+				table[ch] |= kSpace;
+			}
+			for (unsigned char ch : ".,=!&|();"sv) {
+				table[ch] |= kDelimiter;
+			}
+			table['\n'] |= kNewline;
+			table['#'] |= kComment;
+			table['\"'] |= kQuote;
+			return table;
+		}();
+
+		constexpr std::uint8_t TokenEndClasses = kSpace | kNewline | kComment | kDelimiter;
+
+#if defined(__AVX2__)
+		using Block = __m256i;
+
+		constexpr std::size_t BlockSize = 32;
+
+		inline Block Load(const char* a_ptr) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_ptr)); }
+		inline Block Splat(char a_ch) { return _mm256_set1_epi8(a_ch); }
+		inline Block Equal(Block a_lhs, Block a_rhs) { return _mm256_cmpeq_epi8(a_lhs, a_rhs); }
+		inline Block Or(Block a_lhs, Block a_rhs) { return _mm256_or_si256(a_lhs, a_rhs); }
+		inline Block AndNot(Block a_mask, Block a_value) { return _mm256_andnot_si256(a_mask, a_value); }
+		inline Block Min(Block a_lhs, Block a_rhs) { return _mm256_min_epu8(a_lhs, a_rhs); }
+		inline Block Max(Block a_lhs, Block a_rhs) { return _mm256_max_epu8(a_lhs, a_rhs); }
+		inline std::uint32_t MoveMask(Block a_block) { return static_cast<std::uint32_t>(_mm256_movemask_epi8(a_block)); }
+#elif defined(_M_X64) || defined(__SSE2__)
+		using Block = __m128i;
+
+		constexpr std::size_t BlockSize = 16;
+
+		inline Block Load(const char* a_ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_ptr)); }
+		inline Block Splat(char a_ch) { return _mm_set1_epi8(a_ch); }
+		inline Block Equal(Block a_lhs, Block a_rhs) { return _mm_cmpeq_epi8(a_lhs, a_rhs); }
+		inline Block Or(Block a_lhs, Block a_rhs) { return _mm_or_si128(a_lhs, a_rhs); }
+		inline Block AndNot(Block a_mask, Block a_value) { return _mm_andnot_si128(a_mask, a_value); }
+		inline Block Min(Block a_lhs, Block a_rhs) { return _mm_min_epu8(a_lhs, a_rhs); }
+		inline Block Max(Block a_lhs, Block a_rhs) { return _mm_max_epu8(a_lhs, a_rhs); }
+		inline std::uint32_t MoveMask(Block a_block) { return static_cast<std::uint32_t>(_mm_movemask_epi8(a_block)); }
+#else
+#	define TULLPATCHER_SCALAR_LEXER
+#endif
+
+#ifndef TULLPATCHER_SCALAR_LEXER
+		// Returns a bitmask with one bit set for every byte of the block that belongs to any of a_classes
+		template <std::uint8_t a_classes>
+		std::uint32_t Classify(Block a_block) {
+			Block matches{};
+
+			if constexpr ((a_classes & kSpace) != 0) {
+				// '\t', '\v', '\f' and '\r' are the control range [0x09, 0x0D] without '\n'
+				Block controls = Equal(Min(Max(a_block, Splat(0x09)), Splat(0x0D)), a_block);
+				if constexpr ((a_classes & kNewline) == 0) {
+					controls = AndNot(Equal(a_block, Splat('\n')), controls);
+				}
+				matches = Or(matches, Or(controls, Equal(a_block, Splat(' '))));
+			}
+			if constexpr ((a_classes & kNewline) != 0) {
+				matches = Or(matches, Equal(a_block, Splat('\n')));
+			}
+			if constexpr ((a_classes & kComment) != 0) {
+				matches = Or(matches, Equal(a_block, Splat('#')));
+			}
+			if constexpr ((a_classes & kQuote) != 0) {
+				matches = Or(matches, Equal(a_block, Splat('\"')));
+			}
+			if constexpr ((a_classes & kDelimiter) != 0) {
+				for (char ch : ".,=!&|();"sv) {
+					matches = Or(matches, Equal(a_block, Splat(ch)));
+				}
+			}
+
+			return MoveMask(matches);
+		}
+#endif
+
+		// Returns the index of the first byte at or after a_index that belongs (or, with a_match = false,
+		// does not belong) to any of a_classes, or the length of a_data if there is none
+		template <std::uint8_t a_classes, bool a_match = true>
+		std::size_t Find(std::string_view a_data, std::size_t a_index) {
+			const std::size_t length = a_data.size();
+
+#ifndef TULLPATCHER_SCALAR_LEXER
+			constexpr std::uint32_t fullMask = BlockSize == 32 ? 0xFFFFFFFFu : 0xFFFFu;
+
+			while (a_index + BlockSize <= length) {
+				std::uint32_t mask = Classify<a_classes>(Load(a_data.data() + a_index));
+				if constexpr (!a_match) {
+					mask = ~mask & fullMask;
+				}
+
+				if (mask) {
+					return a_index + static_cast<std::size_t>(std::countr_zero(mask));
+				}
+
+				a_index += BlockSize;
+			}
+#endif
+
+			while (a_index < length && ((CharClasses[static_cast<unsigned char>(a_data[a_index])] & a_classes) != 0) != a_match) {
+				a_index++;
+			}
+
+			return a_index;
+		}
+	}
+
+	ConfigReader::ConfigReader(std::string_view a_path) {
+		if (!MapFile(a_path) && !ReadFile(a_path)) {
 			logger::warn("Cannot open the config file: {}", a_path);
-			return;
+		}
+	}
+
+	ConfigReader::ConfigReader(const ConfigChunk& a_chunk) :
+		_buffer(a_chunk.Buffer), _contents(a_chunk.Contents), _line(a_chunk.Line), _column(a_chunk.Column) {}
+
+	bool ConfigReader::MapFile(std::string_view a_path) {
+		// Empty files cannot be mapped, so they always take the buffered path
+		std::error_code ec;
+		const std::filesystem::path path{ a_path };
+		if (std::filesystem::file_size(path, ec) == 0 || ec) {
+			return false;
+		}
+
+		auto mappedFile = std::make_shared<mmio::mapped_file_source>();
+		if (!mappedFile->open(path)) {
+			return false;
 		}
 
-		std::stringstream buffer;
-		buffer << configFile.rdbuf();
+		_contents = std::string_view(reinterpret_cast<const char*>(mappedFile->data()), mappedFile->size());
+		_buffer = std::move(mappedFile);
+		return true;
+	}
+
+	bool ConfigReader::ReadFile(std::string_view a_path) {
+		std::ifstream configFile(std::filesystem::path{ a_path }, std::ios::binary | std::ios::ate);
+		if (!configFile.is_open()) {
+			return false;
+		}
+
+		const auto fileSize = static_cast<std::size_t>(configFile.tellg());
+		configFile.seekg(0, std::ios::beg);
 
-		_fileContents = buffer.str();
+		auto fileContents = std::make_shared<std::string>(fileSize, '\0');
+		if (fileSize > 0 && !configFile.read(fileContents->data(), static_cast<std::streamsize>(fileSize))) {
+			return false;
+		}
 
-		ParseTokens();
+		_contents = *fileContents;
+		_buffer = std::move(fileContents);
+		return true;
 	}
 
-	bool ConfigReader::EndOfFile() const {
-		return _currentTokenIndex >= _tokens.size();
+	bool ConfigReader::EndOfFile() {
+		return !FillLookahead();
 	}
 
 	std::string_view ConfigReader::GetToken() {
 		if (EndOfFile()) {
 			return std::string_view{};
 		}
-		_lastTokenIndex = _currentTokenIndex;
-		return _tokens[_currentTokenIndex++].value;
+
+		_lastToken = _lookahead[_lookaheadStart];
+		_lookaheadStart = (_lookaheadStart + 1) % LookaheadSize;
+		_lookaheadCount--;
+		return _lastToken.value;
 	}
 
 	std::string_view ConfigReader::Peek() {
 		if (EndOfFile()) {
 			return std::string_view{};
 		}
-		_lastTokenIndex = _currentTokenIndex;
-		return _tokens[_currentTokenIndex].value;
+
+		_lastToken = _lookahead[_lookaheadStart];
+		return _lastToken.value;
+	}
+
+	Symbols::Symbol ConfigReader::PeekSymbol() {
+		if (EndOfFile()) {
+			return Symbols::Symbol::kUnknown;
+		}
+
+		_lastToken = _lookahead[_lookaheadStart];
+		return _lastToken.symbol;
+	}
+
+	Symbols::Symbol ConfigReader::GetLastSymbol() const {
+		return _lastToken.symbol;
 	}
 
 	std::size_t ConfigReader::GetLastLine() const {
-		return _tokens[_lastTokenIndex].line;
+		return _lastToken.line;
 	}
 
 	std::size_t ConfigReader::GetLastLineIndex() const {
-		return _tokens[_lastTokenIndex].column;
+		return _lastToken.column;
 	}
 
-	bool ConfigReader::IsDelimiter(char ch) const {
-		return ch == '.' || ch == ',' || ch == '=' || ch == '!' ||
-		       ch == '&' || ch == '|' || ch == '(' || ch == ')' || ch == ';';
+	std::shared_ptr<const void> ConfigReader::GetBuffer() const {
+		return _buffer;
 	}
 
-	void ConfigReader::ParseTokens() {
-		std::size_t index = 0;
-		std::size_t line = 1;
-		std::size_t column = 1;
-		const std::size_t fileLength = _fileContents.size();
+	std::vector<ConfigChunk> ConfigReader::Split(std::size_t a_chunkSize) const {
+		const std::string_view contents = _contents.substr(_index);
+		if (contents.size() <= a_chunkSize) {
+			return { ConfigChunk{ _buffer, contents, _line, _column } };
+		}
 
-		while (index < fileLength) {
-			char ch = _fileContents[index];
+		// Chunks are cut between the tokens the parser will read, so a brace or an else counts only where the lexer makes
+		// a token of it alone
+		ConfigReader scanner(*this);
+		scanner._lookaheadCount = 0;
 
-			// Handle comments
-			if (ch == '#') {
-				while (index < fileLength && _fileContents[index] != '\n') {
-					index++;
-					column++;
+		std::vector<ConfigChunk> retVec;
+
+		std::size_t chunkStart = _index;
+		std::size_t chunkLine = _line;
+		std::size_t chunkColumn = _column;
+		std::size_t depth = 0;
+
+		Token nextToken{};
+		bool hasNextToken = scanner.LexToken(nextToken);
+		while (hasNextToken) {
+			const Token token = nextToken;
+			hasNextToken = scanner.LexToken(nextToken);
+
+			bool isStatementEnd = false;
+			if (token.value == "{") {
+				depth++;
+			}
+			else if (token.value == "}") {
+				if (depth == 0) {
+					return { ConfigChunk{ _buffer, contents, _line, _column } };
 				}
+
+				// An if chain continues while the next token is else
+				depth--;
+				isStatementEnd = depth == 0 && !(hasNextToken && nextToken.value == "else");
+			}
+			else if (token.value == ";") {
+				isStatementEnd = depth == 0;
+			}
+
+			const std::size_t tokenEnd = static_cast<std::size_t>(token.value.data() - _contents.data()) + token.value.size();
+			if (isStatementEnd && tokenEnd - chunkStart >= a_chunkSize) {
+				retVec.push_back(ConfigChunk{ _buffer, _contents.substr(chunkStart, tokenEnd - chunkStart), chunkLine, chunkColumn });
+
+				// Tokens never span lines, so the next chunk starts on the line of the token that ended this one
+				chunkStart = tokenEnd;
+				chunkLine = token.line;
+				chunkColumn = token.column + token.value.size();
+			}
+		}
+
+		if (depth != 0) {
+			return { ConfigChunk{ _buffer, contents, _line, _column } };
+		}
+
+		if (chunkStart < _contents.size() || retVec.empty()) {
+			retVec.push_back(ConfigChunk{ _buffer, _contents.substr(chunkStart), chunkLine, chunkColumn });
+		}
+
+		return retVec;
+	}
+
+	bool ConfigReader::FillLookahead() {
+		if (_lookaheadCount > 0) {
+			return true;
+		}
+
+		_lookaheadStart = 0;
+		while (_lookaheadCount < LookaheadSize && LexToken(_lookahead[_lookaheadCount])) {
+			_lookaheadCount++;
+		}
+
+		return _lookaheadCount > 0;
+	}
+
+	bool ConfigReader::LexToken(Token& a_token) {
+		const std::size_t fileLength = _contents.size();
+
+		while (_index < fileLength) {
+			char ch = _contents[_index];
+			std::uint8_t charClass = CharClasses[static_cast<unsigned char>(ch)];
+
+			// Handle comments
+			if (charClass & kComment) {
+				std::size_t endIdx = Find<kNewline>(_contents, _index);
+				_column += endIdx - _index;
+				_index = endIdx;
 			}
 			// Handle newline characters
-			else if (ch == '\n') {
-				index++;
-				line++;
-				column = 1;
+			else if (charClass & kNewline) {
+				_index++;
+				_line++;
+				_column = 1;
 			}
 			// Handle whitespace characters
-			else if (std::isspace(static_cast<unsigned char>(ch))) {
-				while (index < fileLength && std::isspace(static_cast<unsigned char>(_fileContents[index])) && _fileContents[index] != '\n') {
-					index++;
-					column++;
-				}
+			else if (charClass & kSpace) {
+				std::size_t endIdx = Find<kSpace, false>(_contents, _index);
+				_column += endIdx - _index;
+				_index = endIdx;
 			}
-			// Handle string literals
-			else if (ch == '\"') {
-				std::size_t startIdx = index;
-				std::size_t startLine = line;
-				std::size_t startColumn = column;
-
-				index++;
-				column++;
-
-                while (index < fileLength) {
-					char current = _fileContents[index];
-
-					if (current == '\"') {
-						index++;
-						column++;
-						break;
-					} else if (current == '\n') {
-						break;
-					} else {
-						index++;
-						column++;
-					}
-				}
-
-				std::size_t tokenLen = index - startIdx;
-				std::string_view tokenValue = std::string_view(_fileContents).substr(startIdx, tokenLen);
-				_tokens.emplace_back(Token{ tokenValue, startLine, startColumn });
-			}
-			// Handle delimiters as individual tokens
-			else if (IsDelimiter(ch)) {
-				std::size_t startIdx = index;
-				std::size_t startLine = line;
-				std::size_t startColumn = column;
-				std::size_t tokenLen = 1;
-				std::string_view tokenValue = std::string_view(_fileContents).substr(startIdx, tokenLen);
-				_tokens.emplace_back(Token{ tokenValue, startLine, startColumn });
-				index++;
-				column++;
-			}
-			// Handle general tokens
 			else {
-				std::size_t startIdx = index;
-				std::size_t startLine = line;
-				std::size_t startColumn = column;
-				std::size_t tokenLen = 0;
-
-				while (index < fileLength) {
-					char current = _fileContents[index];
-					if (std::isspace(static_cast<unsigned char>(current)) || current == '#' || current == '\n' || IsDelimiter(current)) {
-						break;
+				std::size_t endIdx;
+				Symbols::Symbol symbol = Symbols::Symbol::kUnknown;
+
+				// Handle string literals
+				if (charClass & kQuote) {
+					endIdx = Find<kQuote | kNewline>(_contents, _index + 1);
+					if (endIdx < fileLength && _contents[endIdx] == '\"') {
+						endIdx++;
 					}
-					index++;
-					column++;
-					tokenLen++;
 				}
-
-				if (tokenLen > 0) {
-					std::string_view tokenValue = std::string_view(_fileContents).substr(startIdx, tokenLen);
-					_tokens.emplace_back(Token{ tokenValue, startLine, startColumn });
+				// Handle delimiters as individual tokens
+				else if (charClass & kDelimiter) {
+					endIdx = _index + 1;
+				}
+				// Handle general tokens, which are the only ones that can be keywords
+				else {
+					endIdx = Find<TokenEndClasses>(_contents, _index + 1);
+					symbol = Symbols::Intern(_contents.substr(_index, endIdx - _index));
 				}
+
+				a_token = Token{ _contents.substr(_index, endIdx - _index), symbol, _line, _column };
+				_column += endIdx - _index;
+				_index = endIdx;
+				return true;
 			}
 		}
+
+		return false;
 	}
 }
@@ -1,28 +1,61 @@
 #pragma once
 
+#include "Symbols.h"
+
 namespace Configs {
+	// A run of whole top-level statements of a config file, and the position in the file where it starts
+	struct ConfigChunk {
+		std::shared_ptr<const void> Buffer;
+		std::string_view Contents;
+		std::size_t Line = 1;
+		std::size_t Column = 1;
+	};
+
 	class ConfigReader {
 	public:
 		ConfigReader(std::string_view a_path);
-		bool EndOfFile() const;
+		ConfigReader(const ConfigChunk& a_chunk);
+		bool EndOfFile();
 		std::string_view GetToken();
 		std::string_view Peek();
+		Symbols::Symbol PeekSymbol();
+		Symbols::Symbol GetLastSymbol() const;
 		std::size_t GetLastLine() const;
 		std::size_t GetLastLineIndex() const;
 
+		// Owner of the memory every token points into; holding it keeps the tokens valid after the reader is gone
+		std::shared_ptr<const void> GetBuffer() const;
+
+		// Cuts the unread contents into chunks of about a_chunkSize bytes, each ending after a ';' or the closing '}' of an
+		// if chain at brace depth 0. Braces and else count only as the tokens GetToken returns. Contents whose braces do not
+		// balance are returned as a single chunk.
+		std::vector<ConfigChunk> Split(std::size_t a_chunkSize) const;
+
 	protected:
-		bool IsDelimiter(char ch) const;
-		void ParseTokens();
+		bool MapFile(std::string_view a_path);
+		bool ReadFile(std::string_view a_path);
 
 		struct Token {
 			std::string_view value;
+			Symbols::Symbol symbol;
 			std::size_t line;
 			std::size_t column;
 		};
 
-		std::string _fileContents;
-		std::vector<Token> _tokens;
-		std::size_t _currentTokenIndex;
-		std::size_t _lastTokenIndex;
+		bool FillLookahead();
+		bool LexToken(Token& a_token);
+
+		// Tokens are lexed on demand into a small ring buffer, so memory use does not grow with the file size
+		static constexpr std::size_t LookaheadSize = 8;
+
+		std::shared_ptr<const void> _buffer;
+		std::string_view _contents;
+		std::size_t _index = 0;
+		std::size_t _line = 1;
+		std::size_t _column = 1;
+		std::array<Token, LookaheadSize> _lookahead{};
+		std::size_t _lookaheadStart = 0;
+		std::size_t _lookaheadCount = 0;
+		Token _lastToken{};
 	};
 }
@@ -1,7 +1,5 @@
 #include "DefaultObjectManagers.h"
 
-#include <regex>
-
 #include "ConfigUtils.h"
 #include "Parsers.h"
 #include "Utils.h"
@@ -45,8 +43,8 @@ namespace DefaultObjectManagers {
 	struct ConfigData {
 		struct Operation {
 			struct ObjectData {
-				std::string Use;
-				std::string ObjectID;
+				std::string_view Use;
+				Utils::FormReference ObjectID;
 			};
 
 			OperationType OpType;
@@ -54,11 +52,26 @@ namespace DefaultObjectManagers {
 		};
 
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
-		std::vector<Operation> Operations;
+		Arenas::Vector<Operation> Operations;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation::ObjectData& a_objectData) {
+		a_ar(a_objectData.Use, a_objectData.ObjectID);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation& a_operation) {
+		a_ar(a_operation.OpType, a_operation.OpData);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.Operations);
+	}
+
 	struct PatchData {
 		struct ObjectData {
 			std::unordered_map<RE::DEFAULT_OBJECT, RE::TESForm*> SetObjectMap;
@@ -67,10 +80,11 @@ namespace DefaultObjectManagers {
 		std::optional<ObjectData> Objects;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::BGSDefaultObjectManager*, PatchData> g_patchMap;
 
-	const std::unordered_map<std::string, RE::DEFAULT_OBJECT> g_defaultObjectsMap = {
+	const std::unordered_map<std::string_view, RE::DEFAULT_OBJECT> g_defaultObjectsMap = {
 		{ "SittingAngleLimit", RE::DEFAULT_OBJECT::kSittingAngleLimit },
 		{ "AllowPlayerShout", RE::DEFAULT_OBJECT::kAllowPlayerShout },
 		{ "Gold", RE::DEFAULT_OBJECT::kGold },
@@ -465,6 +479,7 @@ namespace DefaultObjectManagers {
 	class DefaultObjectManagerParser : public Parsers::Parser<ConfigData> {
 	public:
 		DefaultObjectManagerParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		DefaultObjectManagerParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -516,7 +531,7 @@ namespace DefaultObjectManagers {
 				}
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -541,7 +556,7 @@ namespace DefaultObjectManagers {
 
 		bool ParseFilter(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_configData.Filter = FilterType::kFormID;
 			}
 			else {
@@ -573,7 +588,7 @@ namespace DefaultObjectManagers {
 
 		bool ParseElement(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "Objects") {
+			if (reader.GetLastSymbol() == Symbol::kObjects) {
 				a_configData.Element = ElementType::kObjects;
 			}
 			else {
@@ -589,7 +604,7 @@ namespace DefaultObjectManagers {
 			ConfigData::Operation::ObjectData objData;
 
 			auto token = reader.GetToken();
-			if (token == "Set") {
+			if (reader.GetLastSymbol() == Symbol::kSet) {
 				opType = OperationType::kSet;
 			}
 			else {
@@ -604,7 +619,7 @@ namespace DefaultObjectManagers {
 			}
 
 			token = reader.GetToken();
-			objData.Use = std::string(token);
+			objData.Use = token;
 
 			token = reader.GetToken();
 			if (token != ",") {
@@ -612,12 +627,11 @@ namespace DefaultObjectManagers {
 				return false;
 			}
 
-			token = reader.Peek();
-			if (token == "null") {
-				objData.ObjectID = reader.GetToken();
+			if (reader.PeekSymbol() == Symbol::kNull) {
+				objData.ObjectID = Utils::FormReference{ reader.GetToken() };
 			}
 			else {
-				std::optional<std::string> form = ParseForm();
+				std::optional<Utils::FormReference> form = ParseForm();
 				if (!form.has_value()) {
 					return false;
 				}
@@ -638,12 +652,16 @@ namespace DefaultObjectManagers {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<DefaultObjectManagerParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<DefaultObjectManagerParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+	}
+
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::BGSDefaultObjectManager*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -655,7 +673,7 @@ namespace DefaultObjectManagers {
 				return;
 			}
 
-			PatchData& patchData = g_patchMap[defObjManager];
+			PatchData& patchData = a_patchMap[defObjManager];
 
 			if (a_configData.Element == ElementType::kObjects) {
 				if (!patchData.Objects.has_value()) {
@@ -670,11 +688,11 @@ namespace DefaultObjectManagers {
 							continue;
 						}
 
-						if (op.OpData->ObjectID == "null") {
+						if (op.OpData->ObjectID.IsNull()) {
 							patchData.Objects->SetObjectMap.insert({ it->second, nullptr });
 						}
 						else {
-							RE::TESForm* objForm = Utils::GetFormFromString(op.OpData->ObjectID);
+							RE::TESForm* objForm = op.OpData->ObjectID.Form;
 							if (!objForm) {
 								logger::warn("Invalid Form: '{}'.", op.OpData->ObjectID);
 								continue;
@@ -703,7 +721,7 @@ namespace DefaultObjectManagers {
 	void Patch() {
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
@@ -718,6 +736,7 @@ namespace DefaultObjectManagers {
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
 	}
 }
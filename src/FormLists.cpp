@@ -1,7 +1,6 @@
 #include "FormLists.h"
 
 #include <unordered_set>
-#include <regex>
 
 #include "ConfigUtils.h"
 #include "Parsers.h"
@@ -52,32 +51,50 @@ namespace FormLists {
 	struct ConfigData {
 		struct Operation {
 			OperationType OpType;
-			std::optional<std::string> OpForm;
+			std::optional<Utils::FormReference> OpForm;
 		};
 
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
-		std::vector<Operation> Operations;
+		Arenas::Vector<Operation> Operations;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation& a_operation) {
+		a_ar(a_operation.OpType, a_operation.OpForm);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.Operations);
+	}
+
 	struct PatchData {
 		struct ListData {
 			bool Clear = false;
 			std::vector<RE::TESForm*> AddFormVec;
 			std::unordered_set<RE::TESForm*> AddUniqueFormSet;
 			std::vector<RE::TESForm*> DeleteFormVec;
+
+			bool operator==(const ListData&) const = default;
 		};
 
 		std::optional<ListData> List;
+
+		bool operator==(const PatchData&) const = default;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::BGSListForm*, PatchData> g_patchMap;
+	std::unordered_map<RE::BGSListForm*, PatchData> g_appliedPatchMap;
+	std::unordered_map<RE::BGSListForm*, PatchData> g_originalDataMap;
 
 	class FormListParser : public Parsers::Parser<ConfigData> {
 	public:
 		FormListParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		FormListParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -129,7 +146,7 @@ namespace FormLists {
 				}
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -140,7 +157,7 @@ namespace FormLists {
 				logger::info("{}{}({}).{}", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm, ElementTypeToString(a_configData.Element));
 				for (std::size_t ii = 0; ii < a_configData.Operations.size(); ii++) {
 					std::string opLog = fmt::format(".{}({})", OperationTypeToString(a_configData.Operations[ii].OpType),
-						a_configData.Operations[ii].OpForm.has_value() ? a_configData.Operations[ii].OpForm.value() : "");
+						a_configData.Operations[ii].OpForm.has_value() ? a_configData.Operations[ii].OpForm->Text : "");
 
 					if (ii == a_configData.Operations.size() - 1) {
 						opLog += ";";
@@ -154,7 +171,7 @@ namespace FormLists {
 
 		bool ParseFilter(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_configData.Filter = FilterType::kFormID;
 			}
 			else {
@@ -186,7 +203,7 @@ namespace FormLists {
 
 		bool ParseElement(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "List") {
+			if (reader.GetLastSymbol() == Symbol::kList) {
 				a_configData.Element = ElementType::kList;
 			}
 			else {
@@ -201,19 +218,24 @@ namespace FormLists {
 			OperationType opType;
 
 			auto token = reader.GetToken();
-			if (token == "Clear") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kClear:
 				opType = OperationType::kClear;
-			}
-			else if (token == "Add") {
+				break;
+
+			case Symbol::kAdd:
 				opType = OperationType::kAdd;
-			}
-			else if (token == "AddIfNotExists") {
+				break;
+
+			case Symbol::kAddIfNotExists:
 				opType = OperationType::kAddIfNotExists;
-			}
-			else if (token == "Delete") {
+				break;
+
+			case Symbol::kDelete:
 				opType = OperationType::kDelete;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid OperationName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -224,7 +246,7 @@ namespace FormLists {
 				return false;
 			}
 
-			std::optional<std::string> opData;
+			std::optional<Utils::FormReference> opData;
 			if (opType != OperationType::kClear) {
 				opData = ParseForm();
 				if (!opData.has_value()) {
@@ -245,12 +267,16 @@ namespace FormLists {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<FormListParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<FormListParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+	}
+
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::BGSListForm*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -262,7 +288,7 @@ namespace FormLists {
 				return;
 			}
 
-			PatchData& patchData = g_patchMap[formList];
+			PatchData& patchData = a_patchMap[formList];
 
 			if (a_configData.Element == ElementType::kList) {
 				if (!patchData.List.has_value()) {
@@ -274,7 +300,7 @@ namespace FormLists {
 						patchData.List->Clear = true;
 					}
 					else if (op.OpType == OperationType::kAdd || op.OpType == OperationType::kAddIfNotExists || op.OpType == OperationType::kDelete) {
-						RE::TESForm* opForm = Utils::GetFormFromString(op.OpForm.value());
+						RE::TESForm* opForm = op.OpForm->Form;
 						if (!opForm) {
 							logger::warn("Invalid Form: '{}'.", op.OpForm.value());
 							continue;
@@ -335,30 +361,58 @@ namespace FormLists {
 		}
 	}
 
+	// The list is captured as a Clear followed by an Add of every form, so applying the original puts it back in order
+	void Capture(RE::BGSListForm* a_formList, const PatchData& a_patchData, PatchData& a_originalData) {
+		if (a_patchData.List.has_value() && !a_originalData.List.has_value()) {
+			a_originalData.List = PatchData::ListData{ true, std::vector<RE::TESForm*>(a_formList->arrayOfForms.begin(), a_formList->arrayOfForms.end()), {}, {} };
+		}
+	}
+
 	void Patch(RE::BGSListForm* a_formList, const PatchData& a_patchData) {
 		if (a_patchData.List.has_value()) {
 			PatchList(a_formList, a_patchData.List.value());
 		}
 	}
 
+	void ApplyPatches() {
+		ConfigUtils::ApplyPatches(g_appliedPatchMap, g_originalDataMap, std::move(g_patchMap), Capture, [](RE::BGSListForm* a_formList, const PatchData& a_patchData) {
+			Patch(a_formList, a_patchData);
+		});
+	}
+
 	void Patch() {
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
 
 		logger::info("======================== Start patching for {} ========================", TypeName);
 
-		for (const auto& patchData : g_patchMap) {
-			Patch(patchData.first, patchData.second);
-		}
+		ApplyPatches();
 
 		logger::info("======================== Finished patching for {} ========================", TypeName);
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
 	}
+
+	void Reload() {
+		logger::info("======================== Start reloading {} ========================", TypeName);
+
+		ReadConfigs();
+		ConfigUtils::ResolveForms(g_configVec);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
+		ApplyPatches();
+
+		g_configVec.clear();
+		g_arena.Release();
+		g_patchMap.clear();
+
+		logger::info("======================== Finished reloading {} ========================", TypeName);
+		logger::info("");
+	}
 }
@@ -1,6 +1,12 @@
 #pragma once
 
+#include "Utils.h"
+
 namespace FormLists {
 	void ReadConfigs();
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences);
 	void Patch();
+
+	// Reads the configs again, parsing only files that changed, and patches only forms whose patch changed
+	void Reload();
 }
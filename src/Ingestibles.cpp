@@ -1,7 +1,5 @@
 #include "Ingestibles.h"
 
-#include <regex>
-
 #include "ConfigUtils.h"
 #include "Parsers.h"
 #include "Utils.h"
@@ -49,7 +47,7 @@ namespace Ingestibles {
 	struct ConfigData {
 		struct Operation {
 			struct EffectData {
-				std::string EffectForm;
+				Utils::FormReference EffectForm;
 				float Magnitude;
 				std::uint32_t Area;
 				std::uint32_t Duration;
@@ -60,11 +58,26 @@ namespace Ingestibles {
 		};
 
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
-		std::vector<Operation> Operations;
+		Arenas::Vector<Operation> Operations;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation::EffectData& a_effectData) {
+		a_ar(a_effectData.EffectForm, a_effectData.Magnitude, a_effectData.Area, a_effectData.Duration);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation& a_operation) {
+		a_ar(a_operation.OpType, a_operation.OpEffectData);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.Operations);
+	}
+
 	struct PatchData {
 		struct EffectsData {
 			struct Effect {
@@ -82,12 +95,14 @@ namespace Ingestibles {
 		std::optional<EffectsData> Effects;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::AlchemyItem*, PatchData> g_patchMap;
 
 	class IngestibleParser : public Parsers::Parser<ConfigData> {
 	public:
 		IngestibleParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		IngestibleParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -139,7 +154,7 @@ namespace Ingestibles {
 				}
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -178,7 +193,7 @@ namespace Ingestibles {
 
 		bool ParseFilter(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_configData.Filter = FilterType::kFormID;
 			}
 			else {
@@ -210,7 +225,7 @@ namespace Ingestibles {
 
 		bool ParseElement(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "Effects") {
+			if (reader.GetLastSymbol() == Symbol::kEffects) {
 				a_configData.Element = ElementType::kEffects;
 			}
 			else {
@@ -225,16 +240,20 @@ namespace Ingestibles {
 			OperationType opType;
 
 			auto token = reader.GetToken();
-			if (token == "Clear") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kClear:
 				opType = OperationType::kClear;
-			}
-			else if (token == "Add") {
+				break;
+
+			case Symbol::kAdd:
 				opType = OperationType::kAdd;
-			}
-			else if (token == "Delete") {
+				break;
+
+			case Symbol::kDelete:
 				opType = OperationType::kDelete;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid OperationName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -260,7 +279,7 @@ namespace Ingestibles {
 				if (opType != OperationType::kClear) {
 					newOp.OpEffectData = ConfigData::Operation::EffectData{};
 
-					std::optional<std::string> opForm = ParseForm();
+					std::optional<Utils::FormReference> opForm = ParseForm();
 					if (!opForm.has_value()) {
 						return false;
 					}
@@ -362,12 +381,16 @@ namespace Ingestibles {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<IngestibleParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<IngestibleParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+	}
+
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::AlchemyItem*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -379,7 +402,7 @@ namespace Ingestibles {
 				return;
 			}
 
-			PatchData& patchData = g_patchMap[ingestibleForm];
+			PatchData& patchData = a_patchMap[ingestibleForm];
 
 			if (a_configData.Element == ElementType::kEffects) {
 				if (!patchData.Effects.has_value()) {
@@ -391,7 +414,7 @@ namespace Ingestibles {
 						patchData.Effects->Clear = true;
 					}
 					else if (op.OpType == OperationType::kAdd || op.OpType == OperationType::kDelete) {
-						RE::TESForm* opForm = Utils::GetFormFromString(op.OpEffectData->EffectForm);
+						RE::TESForm* opForm = op.OpEffectData->EffectForm.Form;
 						if (!opForm) {
 							logger::warn("Invalid Form: '{}'.", op.OpEffectData->EffectForm);
 							continue;
@@ -535,7 +558,7 @@ namespace Ingestibles {
 	void Patch() {
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
@@ -550,6 +573,7 @@ namespace Ingestibles {
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
 	}
 }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "Utils.h"
+
 namespace Ingestibles {
 	void ReadConfigs();
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences);
 	void Patch();
 }
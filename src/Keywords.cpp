@@ -1,7 +1,5 @@
 #include "Keywords.h"
 
-#include <regex>
-
 #include "ConfigUtils.h"
 #include "Parsers.h"
 #include "Utils.h"
@@ -33,21 +31,28 @@ namespace Keywords {
 
 	struct ConfigData {
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
-		std::optional<std::string> AssignValue;
+		std::optional<std::string_view> AssignValue;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.AssignValue);
+	}
+
 	struct PatchData {
 		std::optional<std::string> FullName;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::BGSKeyword*, PatchData> g_patchMap;
 
 	class KeywordParser : public Parsers::Parser<ConfigData> {
 	public:
 		KeywordParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		KeywordParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -81,7 +86,7 @@ namespace Keywords {
 				return std::nullopt;
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -97,7 +102,7 @@ namespace Keywords {
 
 		bool ParseFilter(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_config.Filter = FilterType::kFormID;
 			}
 			else {
@@ -129,7 +134,7 @@ namespace Keywords {
 
 		bool ParseElement(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "FullName") {
+			if (reader.GetLastSymbol() == Symbol::kFullName) {
 				a_config.Element = ElementType::kFullName;
 			}
 			else {
@@ -164,12 +169,16 @@ namespace Keywords {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<KeywordParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<KeywordParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+	}
+
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::BGSKeyword*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -182,7 +191,7 @@ namespace Keywords {
 			}
 
 			if (a_configData.Element == ElementType::kFullName) {
-				g_patchMap[keyword].FullName = a_configData.AssignValue.value();
+				a_patchMap[keyword].FullName = std::string(a_configData.AssignValue.value());
 			}
 		}
 	}
@@ -203,7 +212,7 @@ namespace Keywords {
 	void Patch() {
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
@@ -220,6 +229,7 @@ namespace Keywords {
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
 	}
 }
@@ -1,7 +1,6 @@
 #include "LeveledLists.h"
 
 #include <unordered_set>
-#include <regex>
 
 #include "ConfigUtils.h"
 #include "Parsers.h"
@@ -59,7 +58,7 @@ namespace LeveledLists {
 		struct Operation {
 			struct Data {
 				std::uint16_t Level;
-				std::string Form;
+				Utils::FormReference Form;
 				std::uint16_t Count;
 				std::uint8_t ChanceNone;
 			};
@@ -69,12 +68,27 @@ namespace LeveledLists {
 		};
 
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
-		std::vector<Operation> Operations;
+		Arenas::Vector<Operation> Operations;
 		std::optional<std::uint8_t> AssignValue;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation::Data& a_data) {
+		a_ar(a_data.Level, a_data.Form, a_data.Count, a_data.ChanceNone);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation& a_operation) {
+		a_ar(a_operation.OpType, a_operation.OpData);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.Operations, a_configData.AssignValue);
+	}
+
 	struct PatchData {
 		struct EntriesData {
 			struct Entry {
@@ -82,26 +96,39 @@ namespace LeveledLists {
 				RE::TESForm* Form;
 				std::uint16_t Count;
 				std::uint8_t ChanceNone;
+				// Only set for entries captured from the game. Replaced entry arrays are zeroed before they are freed, so
+				// the extra data outlives them.
+				RE::ContainerItemExtra* ItemExtra = nullptr;
+
+				bool operator==(const Entry&) const = default;
 			};
 
 			bool Clear;
 			std::vector<Entry> AddEntryVec;
 			std::vector<Entry> DeleteEntryVec;
 			std::unordered_set<RE::TESForm*> DeleteAllEntrySet;
+
+			bool operator==(const EntriesData&) const = default;
 		};
 
 		std::optional<std::uint8_t> ChanceNone;
 		std::optional<std::uint8_t> MaxCount;
 		std::optional<std::uint8_t> Flags;
 		std::optional<EntriesData> Entries;
+
+		bool operator==(const PatchData&) const = default;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::TESLeveledList*, PatchData> g_patchMap;
+	std::unordered_map<RE::TESLeveledList*, PatchData> g_appliedPatchMap;
+	std::unordered_map<RE::TESLeveledList*, PatchData> g_originalDataMap;
 
 	class LeveledListParser : public Parsers::Parser<ConfigData> {
 	public:
 		LeveledListParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		LeveledListParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -167,7 +194,7 @@ namespace LeveledLists {
 				}
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -217,7 +244,7 @@ namespace LeveledLists {
 
 		bool ParseFilter(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_configData.Filter = FilterType::kFormID;
 			}
 			else {
@@ -249,19 +276,24 @@ namespace LeveledLists {
 
 		bool ParseElement(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "Entries") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kEntries:
 				a_configData.Element = ElementType::kEntries;
-			}
-			else if (token == "ChanceNone") {
+				break;
+
+			case Symbol::kChanceNone:
 				a_configData.Element = ElementType::kChanceNone;
-			}
-			else if (token == "MaxCount") {
+				break;
+
+			case Symbol::kMaxCount:
 				a_configData.Element = ElementType::kMaxCount;
-			}
-			else if (token == "Flags") {
+				break;
+
+			case Symbol::kFlags:
 				a_configData.Element = ElementType::kFlags;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid ElementName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -312,19 +344,24 @@ namespace LeveledLists {
 			OperationType opType;
 
 			auto token = reader.GetToken();
-			if (token == "Clear") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kClear:
 				opType = OperationType::kClear;
-			}
-			else if (token == "Add") {
+				break;
+
+			case Symbol::kAdd:
 				opType = OperationType::kAdd;
-			}
-			else if (token == "Delete") {
+				break;
+
+			case Symbol::kDelete:
 				opType = OperationType::kDelete;
-			}
-			else if (token == "DeleteAll") {
+				break;
+
+			case Symbol::kDeleteAll:
 				opType = OperationType::kDeleteAll;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid OperationName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -374,7 +411,7 @@ namespace LeveledLists {
 						return false;
 					}
 
-					std::optional<std::string> opForm = ParseForm();
+					std::optional<Utils::FormReference> opForm = ParseForm();
 					if (!opForm.has_value()) {
 						return false;
 					}
@@ -432,7 +469,7 @@ namespace LeveledLists {
 					opData->ChanceNone = static_cast<std::uint8_t>(parsedValue);
 				}
 				else if (opType == OperationType::kDeleteAll) {
-					std::optional<std::string> opForm = ParseForm();
+					std::optional<Utils::FormReference> opForm = ParseForm();
 					if (!opForm.has_value()) {
 						return false;
 					}
@@ -454,12 +491,16 @@ namespace LeveledLists {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<LeveledListParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<LeveledListParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+	}
+
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::TESLeveledList*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -471,7 +512,7 @@ namespace LeveledLists {
 				return;
 			}
 
-			PatchData& patchData = g_patchMap[leveledList];
+			PatchData& patchData = a_patchMap[leveledList];
 
 			if (a_configData.Element == ElementType::kEntries) {
 				if (!patchData.Entries.has_value()) {
@@ -483,7 +524,7 @@ namespace LeveledLists {
 						patchData.Entries->Clear = true;
 					}
 					else if (op.OpType == OperationType::kAdd || op.OpType == OperationType::kDelete || op.OpType == OperationType::kDeleteAll) {
-						RE::TESForm* opForm = Utils::GetFormFromString(op.OpData->Form);
+						RE::TESForm* opForm = op.OpData->Form.Form;
 						if (!opForm) {
 							logger::warn("Invalid Form: '{}'.", op.OpData->Form);
 							continue;
@@ -630,7 +671,7 @@ namespace LeveledLists {
 
 		// Add
 		for (const auto& addEntry : a_entriesData.AddEntryVec) {
-			leveledListVec.push_back({ addEntry.Form, nullptr, addEntry.Count, addEntry.Level, static_cast<std::int8_t>(addEntry.ChanceNone) });
+			leveledListVec.push_back({ addEntry.Form, addEntry.ItemExtra, addEntry.Count, addEntry.Level, static_cast<std::int8_t>(addEntry.ChanceNone) });
 			isModified = true;
 		}
 
@@ -643,6 +684,28 @@ namespace LeveledLists {
 		}
 	}
 
+	// Entries are captured as a Clear followed by an Add of every entry, so applying the original puts them back
+	void Capture(RE::TESLeveledList* a_leveledList, const PatchData& a_patchData, PatchData& a_originalData) {
+		if (a_patchData.Entries.has_value() && !a_originalData.Entries.has_value()) {
+			a_originalData.Entries = PatchData::EntriesData{ true, {}, {}, {} };
+			for (const auto& entry : GetLeveledListEntries(a_leveledList)) {
+				a_originalData.Entries->AddEntryVec.push_back({ entry.level, entry.form, entry.count, static_cast<std::uint8_t>(entry.chanceNone), entry.itemExtra });
+			}
+		}
+
+		if (a_patchData.ChanceNone.has_value() && !a_originalData.ChanceNone.has_value()) {
+			a_originalData.ChanceNone = static_cast<std::uint8_t>(a_leveledList->chanceNone);
+		}
+
+		if (a_patchData.MaxCount.has_value() && !a_originalData.MaxCount.has_value()) {
+			a_originalData.MaxCount = static_cast<std::uint8_t>(a_leveledList->maxUseAllCount);
+		}
+
+		if (a_patchData.Flags.has_value() && !a_originalData.Flags.has_value()) {
+			a_originalData.Flags = static_cast<std::uint8_t>(a_leveledList->llFlags);
+		}
+	}
+
 	void Patch(RE::TESLeveledList* a_leveledList, const PatchData& a_patchData) {
 		if (a_patchData.Entries.has_value()) {
 			PatchEntries(a_leveledList, a_patchData.Entries.value());
@@ -661,24 +724,45 @@ namespace LeveledLists {
 		}
 	}
 
+	void ApplyPatches() {
+		ConfigUtils::ApplyPatches(g_appliedPatchMap, g_originalDataMap, std::move(g_patchMap), Capture, [](RE::TESLeveledList* a_leveledList, const PatchData& a_patchData) {
+			Patch(a_leveledList, a_patchData);
+		});
+	}
+
 	void Patch() {
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
 
 		logger::info("======================== Start patching for {} ========================", TypeName);
 
-		for (const auto& patchData : g_patchMap) {
-			Patch(patchData.first, patchData.second);
-		}
+		ApplyPatches();
 
 		logger::info("======================== Finished patching for {} ========================", TypeName);
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
+		g_patchMap.clear();
+	}
+
+	void Reload() {
+		logger::info("======================== Start reloading {} ========================", TypeName);
+
+		ReadConfigs();
+		ConfigUtils::ResolveForms(g_configVec);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
+		ApplyPatches();
+
+		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
+
+		logger::info("======================== Finished reloading {} ========================", TypeName);
+		logger::info("");
 	}
 }
@@ -1,7 +1,6 @@
 #include "Locations.h"
 
 #include <unordered_set>
-#include <regex>
 
 #include "ConfigUtils.h"
 #include "Parsers.h"
@@ -54,34 +53,52 @@ namespace Locations {
 	struct ConfigData {
 		struct Operation {
 			OperationType OpType;
-			std::optional<std::string> OpForm;
+			std::optional<Utils::FormReference> OpForm;
 		};
 
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
-		std::optional<std::string> AssignValue;
-		std::vector<Operation> Operations;
+		std::optional<std::string_view> AssignValue;
+		Arenas::Vector<Operation> Operations;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation& a_operation) {
+		a_ar(a_operation.OpType, a_operation.OpForm);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.AssignValue, a_configData.Operations);
+	}
+
 	struct PatchData {
 		struct KeywordsData {
 			bool Clear = false;
 			std::vector<RE::BGSKeyword*> AddKeywordVec;
 			std::unordered_set<RE::BGSKeyword*> AddUniqueKeywordSet;
 			std::vector<RE::BGSKeyword*> DeleteKeywordVec;
+
+			bool operator==(const KeywordsData&) const = default;
 		};
 
 		std::optional<std::string> FullName;
 		std::optional<KeywordsData> Keywords;
+
+		bool operator==(const PatchData&) const = default;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::BGSLocation*, PatchData> g_patchMap;
+	std::unordered_map<RE::BGSLocation*, PatchData> g_appliedPatchMap;
+	std::unordered_map<RE::BGSLocation*, PatchData> g_originalDataMap;
 
 	class LocationParser : public Parsers::Parser<ConfigData> {
 	public:
 		LocationParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		LocationParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -147,7 +164,7 @@ namespace Locations {
 				}
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -163,7 +180,7 @@ namespace Locations {
 				logger::info("{}{}({}).{}", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm, ElementTypeToString(a_configData.Element));
 				for (std::size_t ii = 0; ii < a_configData.Operations.size(); ii++) {
 					std::string opLog = fmt::format(".{}({})", OperationTypeToString(a_configData.Operations[ii].OpType),
-						a_configData.Operations[ii].OpForm.has_value() ? a_configData.Operations[ii].OpForm.value() : "");
+						a_configData.Operations[ii].OpForm.has_value() ? a_configData.Operations[ii].OpForm->Text : "");
 
 					if (ii == a_configData.Operations.size() - 1) {
 						opLog += ";";
@@ -177,7 +194,7 @@ namespace Locations {
 
 		bool ParseFilter(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_configData.Filter = FilterType::kFormID;
 			}
 			else {
@@ -209,13 +226,16 @@ namespace Locations {
 
 		bool ParseElement(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "FullName") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kFullName:
 				a_configData.Element = ElementType::kFullName;
-			}
-			else if (token == "Keywords") {
+				break;
+
+			case Symbol::kKeywords:
 				a_configData.Element = ElementType::kKeywords;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid ElementName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -241,7 +261,7 @@ namespace Locations {
 					return false;
 				}
 
-				a_config.AssignValue = std::string(token.substr(1, token.length() - 2));
+				a_config.AssignValue = token.substr(1, token.length() - 2);
 			}
 
 			return true;
@@ -251,19 +271,24 @@ namespace Locations {
 			OperationType opType;
 
 			auto token = reader.GetToken();
-			if (token == "Clear") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kClear:
 				opType = OperationType::kClear;
-			}
-			else if (token == "Add") {
+				break;
+
+			case Symbol::kAdd:
 				opType = OperationType::kAdd;
-			}
-			else if (token == "AddIfNotExists") {
+				break;
+
+			case Symbol::kAddIfNotExists:
 				opType = OperationType::kAddIfNotExists;
-			}
-			else if (token == "Delete") {
+				break;
+
+			case Symbol::kDelete:
 				opType = OperationType::kDelete;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid OperationName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -274,7 +299,7 @@ namespace Locations {
 				return false;
 			}
 
-			std::optional<std::string> opData;
+			std::optional<Utils::FormReference> opData;
 			if (opType != OperationType::kClear) {
 				opData = ParseForm();
 				if (!opData.has_value()) {
@@ -295,12 +320,16 @@ namespace Locations {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<LocationParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<LocationParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+	}
+
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::BGSLocation*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -312,10 +341,10 @@ namespace Locations {
 				return;
 			}
 
-			PatchData& patchData = g_patchMap[location];
+			PatchData& patchData = a_patchMap[location];
 
 			if (a_configData.Element == ElementType::kFullName) {
-				patchData.FullName = a_configData.AssignValue.value();
+				patchData.FullName = std::string(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kKeywords) {
 				if (!patchData.Keywords.has_value()) {
@@ -327,7 +356,7 @@ namespace Locations {
 						patchData.Keywords->Clear = true;
 					}
 					else if (op.OpType == OperationType::kAdd || op.OpType == OperationType::kAddIfNotExists || op.OpType == OperationType::kDelete) {
-						RE::TESForm* opForm = Utils::GetFormFromString(op.OpForm.value());
+						RE::TESForm* opForm = op.OpForm->Form;
 						if (!opForm) {
 							logger::warn("Invalid Form: '{}'.", op.OpForm.value());
 							continue;
@@ -413,6 +442,17 @@ namespace Locations {
 		}
 	}
 
+	// Keywords are captured as a Clear followed by an Add of every keyword, so applying the original puts them back in order
+	void Capture(RE::BGSLocation* a_location, const PatchData& a_patchData, PatchData& a_originalData) {
+		if (a_patchData.FullName.has_value() && !a_originalData.FullName.has_value()) {
+			a_originalData.FullName = std::string(a_location->fullName.c_str());
+		}
+
+		if (a_patchData.Keywords.has_value() && !a_originalData.Keywords.has_value()) {
+			a_originalData.Keywords = PatchData::KeywordsData{ true, std::vector<RE::BGSKeyword*>(a_location->keywords, a_location->keywords + a_location->numKeywords), {}, {} };
+		}
+	}
+
 	void Patch(RE::BGSLocation* a_location, const PatchData& a_patchData) {
 		if (a_patchData.FullName.has_value()) {
 			a_location->fullName = a_patchData.FullName.value();
@@ -423,24 +463,45 @@ namespace Locations {
 		}
 	}
 
+	void ApplyPatches() {
+		ConfigUtils::ApplyPatches(g_appliedPatchMap, g_originalDataMap, std::move(g_patchMap), Capture, [](RE::BGSLocation* a_location, const PatchData& a_patchData) {
+			Patch(a_location, a_patchData);
+		});
+	}
+
 	void Patch() {
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
 
 		logger::info("======================== Start patching for {} ========================", TypeName);
 
-		for (const auto& patchData : g_patchMap) {
-			Patch(patchData.first, patchData.second);
-		}
+		ApplyPatches();
 
 		logger::info("======================== Finished patching for {} ========================", TypeName);
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
 	}
+
+	void Reload() {
+		logger::info("======================== Start reloading {} ========================", TypeName);
+
+		ReadConfigs();
+		ConfigUtils::ResolveForms(g_configVec);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
+		ApplyPatches();
+
+		g_configVec.clear();
+		g_arena.Release();
+		g_patchMap.clear();
+
+		logger::info("======================== Finished reloading {} ========================", TypeName);
+		logger::info("");
+	}
 }
@@ -0,0 +1,201 @@
+#include "Logs.h"
+
+#include <spdlog/sinks/basic_file_sink.h>
+
+namespace Logs {
+	namespace {
+		constexpr std::string_view StatementLoggerName = "Statements";
+		constexpr std::size_t DumpQueueSize = 8192;
+
+		std::atomic<StatementLog> g_statementLog = StatementLog::kLog;
+
+		std::mutex g_dumpLock;
+		std::filesystem::path g_dumpPath;
+		std::shared_ptr<spdlog::sinks::sink> g_dumpSink;
+
+		std::shared_ptr<spdlog::sinks::sink> GetDumpSink() {
+			std::lock_guard<std::mutex> lock(g_dumpLock);
+
+			if (!g_dumpSink && !g_dumpPath.empty()) {
+				auto fileSink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(g_dumpPath.string(), true);
+				fileSink->set_pattern("%v");
+				g_dumpSink = std::make_shared<AsyncSink>(std::move(fileSink), DumpQueueSize);
+			}
+
+			return g_dumpSink;
+		}
+
+		bool IsStatementMessage(const spdlog::details::log_msg& a_msg) {
+			return std::string_view(a_msg.logger_name.data(), a_msg.logger_name.size()) == StatementLoggerName;
+		}
+	}
+
+	thread_local Buffer* t_captureBuffer = nullptr;
+	thread_local bool t_statementLog = false;
+
+	void SetStatementLog(StatementLog a_statementLog, const std::filesystem::path& a_dumpPath) {
+		{
+			std::lock_guard<std::mutex> lock(g_dumpLock);
+			g_dumpPath = a_dumpPath;
+			g_dumpSink.reset();
+		}
+
+		g_statementLog = a_statementLog;
+	}
+
+	StatementLog GetStatementLog() {
+		return g_statementLog;
+	}
+
+	ScopedCapture::ScopedCapture(Buffer& a_buffer) : _previous(t_captureBuffer) {
+		t_captureBuffer = &a_buffer;
+	}
+
+	ScopedCapture::~ScopedCapture() {
+		t_captureBuffer = _previous;
+	}
+
+	ScopedStatementLog::ScopedStatementLog() : _previous(t_statementLog) {
+		t_statementLog = true;
+	}
+
+	ScopedStatementLog::~ScopedStatementLog() {
+		t_statementLog = _previous;
+	}
+
+	CaptureSink::CaptureSink(std::shared_ptr<spdlog::sinks::sink> a_sink) : _sink(std::move(a_sink)) {}
+
+	void CaptureSink::log(const spdlog::details::log_msg& a_msg) {
+		// Statement output is tagged through the logger name, so that captured and cached messages are routed on replay
+		if (t_statementLog && !IsStatementMessage(a_msg)) {
+			spdlog::details::log_msg statementMsg = a_msg;
+			statementMsg.logger_name = StatementLoggerName;
+			log(statementMsg);
+			return;
+		}
+
+		if (t_captureBuffer) {
+			t_captureBuffer->emplace_back(a_msg);
+			return;
+		}
+
+		if (IsStatementMessage(a_msg)) {
+			switch (GetStatementLog()) {
+			case StatementLog::kNone:
+				return;
+			case StatementLog::kFile:
+				if (auto dumpSink = GetDumpSink()) {
+					dumpSink->log(a_msg);
+				}
+				return;
+			default:
+				break;
+			}
+		}
+
+		_sink->log(a_msg);
+	}
+
+	void CaptureSink::flush() {
+		if (t_captureBuffer) {
+			return;
+		}
+
+		_sink->flush();
+
+		std::lock_guard<std::mutex> lock(g_dumpLock);
+		if (g_dumpSink) {
+			g_dumpSink->flush();
+		}
+	}
+
+	void CaptureSink::set_pattern(const std::string& a_pattern) {
+		_sink->set_pattern(a_pattern);
+	}
+
+	void CaptureSink::set_formatter(std::unique_ptr<spdlog::formatter> a_formatter) {
+		_sink->set_formatter(std::move(a_formatter));
+	}
+
+	AsyncSink::AsyncSink(std::shared_ptr<spdlog::sinks::sink> a_sink, std::size_t a_queueSize) :
+		_sink(std::move(a_sink)), _queueSize(std::max<std::size_t>(a_queueSize, 1)) {
+		_worker = std::thread([this]() { Run(); });
+	}
+
+	AsyncSink::~AsyncSink() {
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+			_stopping = true;
+		}
+
+		_queued.notify_one();
+		_worker.join();
+	}
+
+	void AsyncSink::log(const spdlog::details::log_msg& a_msg) {
+		{
+			std::unique_lock<std::mutex> lock(_lock);
+			_written.wait(lock, [this]() { return _queue.size() < _queueSize; });
+			_queue.emplace_back(a_msg);
+		}
+
+		_queued.notify_one();
+	}
+
+	void AsyncSink::flush() {
+		std::unique_lock<std::mutex> lock(_lock);
+		_written.wait(lock, [this]() { return _queue.empty() && !_writing; });
+	}
+
+	void AsyncSink::set_pattern(const std::string& a_pattern) {
+		_sink->set_pattern(a_pattern);
+	}
+
+	void AsyncSink::set_formatter(std::unique_ptr<spdlog::formatter> a_formatter) {
+		_sink->set_formatter(std::move(a_formatter));
+	}
+
+	void AsyncSink::Run() {
+		Buffer batch;
+
+		std::unique_lock<std::mutex> lock(_lock);
+		while (true) {
+			_queued.wait(lock, [this]() { return !_queue.empty() || _stopping; });
+			if (_queue.empty()) {
+				return;
+			}
+
+			batch.swap(_queue);
+			_writing = true;
+
+			lock.unlock();
+			_written.notify_all();
+
+			for (const auto& msg : batch) {
+				_sink->log(msg);
+			}
+			_sink->flush();
+			batch.clear();
+
+			lock.lock();
+			_writing = false;
+			_written.notify_all();
+		}
+	}
+
+	void Replay(const Buffer& a_buffer) {
+		if (a_buffer.empty()) {
+			return;
+		}
+
+		// Sinks flush on their own, so replaying a large buffer does not wait for the file to be written
+		auto defaultLogger = spdlog::default_logger_raw();
+		for (const auto& msg : a_buffer) {
+			for (const auto& sink : defaultLogger->sinks()) {
+				if (sink->should_log(msg.level)) {
+					sink->log(msg);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <condition_variable>
+#include <thread>
+
+namespace Logs {
+	// Log messages recorded on one thread so that they can be written out later in a fixed order
+	using Buffer = std::vector<spdlog::details::log_msg_buffer>;
+
+	// Where the statements echoed while parsing configs are written
+	enum class StatementLog {
+		kLog,
+		kFile,
+		kNone
+	};
+
+	// a_dumpPath is the file used by kFile; it is only created once the first statement is written to it
+	void SetStatementLog(StatementLog a_statementLog, const std::filesystem::path& a_dumpPath = {});
+	StatementLog GetStatementLog();
+
+	// Redirects every message logged on the current thread into a_buffer for the lifetime of the object
+	class ScopedCapture {
+	public:
+		ScopedCapture(Buffer& a_buffer);
+		~ScopedCapture();
+
+		ScopedCapture(const ScopedCapture&) = delete;
+		ScopedCapture& operator=(const ScopedCapture&) = delete;
+
+	private:
+		Buffer* _previous;
+	};
+
+	// Marks every message logged on the current thread as statement output for the lifetime of the object
+	class ScopedStatementLog {
+	public:
+		ScopedStatementLog();
+		~ScopedStatementLog();
+
+		ScopedStatementLog(const ScopedStatementLog&) = delete;
+		ScopedStatementLog& operator=(const ScopedStatementLog&) = delete;
+
+	private:
+		bool _previous;
+	};
+
+	// Sink wrapper that diverts messages into the current thread's capture buffer, if there is one
+	class CaptureSink : public spdlog::sinks::sink {
+	public:
+		CaptureSink(std::shared_ptr<spdlog::sinks::sink> a_sink);
+
+		void log(const spdlog::details::log_msg& a_msg) override;
+		void flush() override;
+		void set_pattern(const std::string& a_pattern) override;
+		void set_formatter(std::unique_ptr<spdlog::formatter> a_formatter) override;
+
+	private:
+		std::shared_ptr<spdlog::sinks::sink> _sink;
+	};
+
+	// Sink wrapper that writes to a_sink on a background thread. Pending messages are written in batches with one flush per
+	// batch; once a_queueSize messages are pending, logging blocks rather than dropping messages.
+	class AsyncSink : public spdlog::sinks::sink {
+	public:
+		AsyncSink(std::shared_ptr<spdlog::sinks::sink> a_sink, std::size_t a_queueSize);
+		~AsyncSink() override;
+
+		void log(const spdlog::details::log_msg& a_msg) override;
+		// Blocks until every message logged so far has been written and flushed
+		void flush() override;
+		void set_pattern(const std::string& a_pattern) override;
+		void set_formatter(std::unique_ptr<spdlog::formatter> a_formatter) override;
+
+	private:
+		void Run();
+
+		std::shared_ptr<spdlog::sinks::sink> _sink;
+		std::size_t _queueSize;
+		std::mutex _lock;
+		std::condition_variable _queued;
+		std::condition_variable _written;
+		Buffer _queue;
+		bool _writing = false;
+		bool _stopping = false;
+		std::thread _worker;
+	};
+
+	// Writes buffered messages through the default logger, as if they had been logged now on this thread
+	void Replay(const Buffer& a_buffer);
+}
@@ -1,6 +1,5 @@
 #include "MusicTypes.h"
 
-#include <regex>
 #include <any>
 
 #include "ConfigUtils.h"
@@ -58,16 +57,27 @@ namespace MusicTypes {
 	struct ConfigData {
 		struct Operation {
 			OperationType OpType;
-			std::optional<std::string> OpForm;
+			std::optional<Utils::FormReference> OpForm;
 		};
 
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
-		std::vector<Operation> Operations;
+		Arenas::Vector<Operation> Operations;
 		std::optional<std::any> AssignValue;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation& a_operation) {
+		a_ar(a_operation.OpType, a_operation.OpForm);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.Operations);
+		a_ar.template Any<float, std::uint8_t, std::uint16_t, std::uint32_t>(a_configData.AssignValue);
+	}
+
 	struct PatchData {
 		struct MusicTracksData {
 			bool Clear = false;
@@ -82,12 +92,14 @@ namespace MusicTypes {
 		std::optional<std::uint8_t> Priority;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::BGSMusicType*, PatchData> g_patchMap;
 
 	class MusicTypeParser : public Parsers::Parser<ConfigData> {
 	public:
 		MusicTypeParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		MusicTypeParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -153,7 +165,7 @@ namespace MusicTypes {
 				}
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -208,7 +220,7 @@ namespace MusicTypes {
 
 		bool ParseFilter(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_configData.Filter = FilterType::kFormID;
 			}
 			else {
@@ -240,22 +252,28 @@ namespace MusicTypes {
 
 		bool ParseElement(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "Ducking") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kDucking:
 				a_configData.Element = ElementType::kDucking;
-			}
-			else if (token == "FadeDuration") {
+				break;
+
+			case Symbol::kFadeDuration:
 				a_configData.Element = ElementType::kFadeDuration;
-			}
-			else if (token == "Flags") {
+				break;
+
+			case Symbol::kFlags:
 				a_configData.Element = ElementType::kFlags;
-			}
-			else if (token == "MusicTracks") {
+				break;
+
+			case Symbol::kMusicTracks:
 				a_configData.Element = ElementType::kMusicTracks;
-			}
-			else if (token == "Priority") {
+				break;
+
+			case Symbol::kPriority:
 				a_configData.Element = ElementType::kPriority;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid ElementName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -408,16 +426,20 @@ namespace MusicTypes {
 			ConfigData::Operation newOp;
 
 			auto token = reader.GetToken();
-			if (token == "Clear") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kClear:
 				newOp.OpType = OperationType::kClear;
-			}
-			else if (token == "Add") {
+				break;
+
+			case Symbol::kAdd:
 				newOp.OpType = OperationType::kAdd;
-			}
-			else if (token == "Delete") {
+				break;
+
+			case Symbol::kDelete:
 				newOp.OpType = OperationType::kDelete;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid OperationName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -447,7 +469,7 @@ namespace MusicTypes {
 			switch (a_configData.Element) {
 			case ElementType::kMusicTracks:
 				if (newOp.OpType != OperationType::kClear) {
-					std::optional<std::string> form = ParseForm();
+					std::optional<Utils::FormReference> form = ParseForm();
 					if (!form.has_value()) {
 						return false;
 					}
@@ -476,28 +498,15 @@ namespace MusicTypes {
 				return std::nullopt;
 			}
 
-			if (token == "None") {
-				return 0x0000;
-			}
-			else if (token == "PlaysOneSelection") {
-				return 0x0001;
-			}
-			else if (token == "AbruptTransition") {
-				return 0x0002;
-			}
-			else if (token == "CycleTracks") {
-				return 0x0004;
-			}
-			else if (token == "MaintainTrackOrder") {
-				return 0x0008;
-			}
-			else if (token == "DucksCurrentTrack") {
-				return 0x0020;
-			}
-			else if (token == "DoesNotQueue") {
-				return 0x0040;
-			}
-			else {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kNone: return 0x0000;
+			case Symbol::kPlaysOneSelection: return 0x0001;
+			case Symbol::kAbruptTransition: return 0x0002;
+			case Symbol::kCycleTracks: return 0x0004;
+			case Symbol::kMaintainTrackOrder: return 0x0008;
+			case Symbol::kDucksCurrentTrack: return 0x0020;
+			case Symbol::kDoesNotQueue: return 0x0040;
+			default:
 				logger::warn("Line {}, Col {}: Invalid flag name '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return std::nullopt;
 			}
@@ -535,12 +544,16 @@ namespace MusicTypes {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<MusicTypeParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<MusicTypeParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+	}
+
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::BGSMusicType*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -552,7 +565,7 @@ namespace MusicTypes {
 				return;
 			}
 
-			PatchData& patchData = g_patchMap[musicType];
+			PatchData& patchData = a_patchMap[musicType];
 
 			if (a_configData.Element == ElementType::kDucking) {
 				patchData.Ducking = std::any_cast<std::uint16_t>(a_configData.AssignValue.value());
@@ -573,7 +586,7 @@ namespace MusicTypes {
 						patchData.MusicTracks->Clear = true;
 					}
 					else if (op.OpType == OperationType::kAdd || op.OpType == OperationType::kDelete) {
-						RE::TESForm* opForm = Utils::GetFormFromString(op.OpForm.value());
+						RE::TESForm* opForm = op.OpForm->Form;
 						if (!opForm) {
 							logger::warn("Invalid Form: '{}'.", op.OpForm.value());
 							continue;
@@ -662,7 +675,7 @@ namespace MusicTypes {
 	void Patch() {
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
@@ -677,6 +690,7 @@ namespace MusicTypes {
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
 	}
 }
@@ -1,8 +1,8 @@
 #include "NPCs.h"
 
 #include <unordered_set>
-#include <regex>
-#include <any>
+#include <variant>
+#include <latch>
 
 #include "ConfigUtils.h"
 #include "Parsers.h"
@@ -98,16 +98,36 @@ namespace NPCs {
 			};
 
 			OperationType OpType;
-			std::optional<std::any> OpData;
+			std::optional<std::variant<Utils::FormReference, MorphData, TintData>> OpData;
 		};
 
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
-		std::optional<std::any> AssignValue;
-		std::vector<Operation> Operations;
+		std::optional<std::variant<std::string_view, Utils::FormReference, float, bool, std::uint8_t>> AssignValue;
+		Arenas::Vector<Operation> Operations;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation::MorphData& a_morphData) {
+		a_ar(a_morphData.Key, a_morphData.Value);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation::TintData& a_tintData) {
+		a_ar(a_tintData.Index, a_tintData.Color, a_tintData.Alpha);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation& a_operation) {
+		a_ar(a_operation.OpType, a_operation.OpData);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.AssignValue, a_configData.Operations);
+	}
+
 	struct PatchData {
 		struct HeadPartsData {
 			bool Clear;
@@ -148,12 +168,15 @@ namespace NPCs {
 	};
 
 	bool g_prepared = false;
+	std::latch g_configsRead{ 1 };
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::TESNPC*, PatchData> g_patchMap;
 
 	class NPCParser : public Parsers::Parser<ConfigData> {
 	public:
 		NPCParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		NPCParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -219,7 +242,7 @@ namespace NPCs {
 				}
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -239,7 +262,7 @@ namespace NPCs {
 					case OperationType::kAdd:
 					case OperationType::kDelete:
 						opLog = fmt::format(".{}({})", OperationTypeToString(a_configData.Operations[ii].OpType),
-							std::any_cast<std::string>(a_configData.Operations[ii].OpData.value()));
+							std::get<Utils::FormReference>(a_configData.Operations[ii].OpData.value()));
 						break;
 					}
 
@@ -263,13 +286,13 @@ namespace NPCs {
 
 					case OperationType::kSet:
 						opLog = fmt::format(".{}({:08X}, {})", OperationTypeToString(a_configData.Operations[ii].OpType),
-							std::any_cast<ConfigData::Operation::MorphData>(a_configData.Operations[ii].OpData.value()).Key,
-							std::any_cast<ConfigData::Operation::MorphData>(a_configData.Operations[ii].OpData.value()).Value);
+							std::get<ConfigData::Operation::MorphData>(a_configData.Operations[ii].OpData.value()).Key,
+							std::get<ConfigData::Operation::MorphData>(a_configData.Operations[ii].OpData.value()).Value);
 						break;
 
 					case OperationType::kDelete:
 						opLog = fmt::format(".{}({:08X})", OperationTypeToString(a_configData.Operations[ii].OpType),
-							std::any_cast<ConfigData::Operation::MorphData>(a_configData.Operations[ii].OpData.value()).Key);
+							std::get<ConfigData::Operation::MorphData>(a_configData.Operations[ii].OpData.value()).Key);
 						break;
 					}
 
@@ -293,16 +316,16 @@ namespace NPCs {
 
 					case OperationType::kSet:
 						opLog = fmt::format(".{}({}, {}, {}, {}, {})", OperationTypeToString(a_configData.Operations[ii].OpType),
-							std::any_cast<ConfigData::Operation::TintData>(a_configData.Operations[ii].OpData.value()).Index,
-							std::any_cast<ConfigData::Operation::TintData>(a_configData.Operations[ii].OpData.value()).Color & 0xFF,
-							(std::any_cast<ConfigData::Operation::TintData>(a_configData.Operations[ii].OpData.value()).Color >> 8) & 0xFF,
-							(std::any_cast<ConfigData::Operation::TintData>(a_configData.Operations[ii].OpData.value()).Color >> 16) & 0xFF,
-							std::any_cast<ConfigData::Operation::TintData>(a_configData.Operations[ii].OpData.value()).Alpha);
+							std::get<ConfigData::Operation::TintData>(a_configData.Operations[ii].OpData.value()).Index,
+							std::get<ConfigData::Operation::TintData>(a_configData.Operations[ii].OpData.value()).Color & 0xFF,
+							(std::get<ConfigData::Operation::TintData>(a_configData.Operations[ii].OpData.value()).Color >> 8) & 0xFF,
+							(std::get<ConfigData::Operation::TintData>(a_configData.Operations[ii].OpData.value()).Color >> 16) & 0xFF,
+							std::get<ConfigData::Operation::TintData>(a_configData.Operations[ii].OpData.value()).Alpha);
 						break;
 
 					case OperationType::kDelete:
 						opLog = fmt::format(".{}({})", OperationTypeToString(a_configData.Operations[ii].OpType),
-							std::any_cast<ConfigData::Operation::TintData>(a_configData.Operations[ii].OpData.value()).Index);
+							std::get<ConfigData::Operation::TintData>(a_configData.Operations[ii].OpData.value()).Index);
 						break;
 					}
 
@@ -320,36 +343,40 @@ namespace NPCs {
 			case ElementType::kWeightMuscular:
 			case ElementType::kWeightThin:
 				logger::info("{}{}({}).{} = {};", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm,
-					ElementTypeToString(a_configData.Element), std::any_cast<float>(a_configData.AssignValue.value()));
+					ElementTypeToString(a_configData.Element), std::get<float>(a_configData.AssignValue.value()));
 				break;
 
 			case ElementType::kClass:
 			case ElementType::kCombatStyle:
 			case ElementType::kDefaultOutfit:
-			case ElementType::kFullName:
 			case ElementType::kHairColor:
 			case ElementType::kHeadTexture:
 			case ElementType::kRace:
 			case ElementType::kSkin:
 				logger::info("{}{}({}).{} = {};", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm,
-					ElementTypeToString(a_configData.Element), std::any_cast<std::string>(a_configData.AssignValue.value()));
+					ElementTypeToString(a_configData.Element), std::get<Utils::FormReference>(a_configData.AssignValue.value()));
+				break;
+
+			case ElementType::kFullName:
+				logger::info("{}{}({}).{} = {};", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm,
+					ElementTypeToString(a_configData.Element), std::get<std::string_view>(a_configData.AssignValue.value()));
 				break;
 
 			case ElementType::kIsChargenFacePreset:
 				logger::info("{}{}({}).{} = {};", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm,
-					ElementTypeToString(a_configData.Element), std::any_cast<bool>(a_configData.AssignValue.value()));
+					ElementTypeToString(a_configData.Element), std::get<bool>(a_configData.AssignValue.value()));
 				break;
 
 			case ElementType::kSex:
 				logger::info("{}{}({}).{} = {};", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm,
-					ElementTypeToString(a_configData.Element), std::any_cast<std::uint8_t>(a_configData.AssignValue.value()));
+					ElementTypeToString(a_configData.Element), std::get<std::uint8_t>(a_configData.AssignValue.value()));
 				break;
 			}
 		}
 
 		bool ParseFilter(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_config.Filter = FilterType::kFormID;
 			}
 			else {
@@ -381,61 +408,80 @@ namespace NPCs {
 
 		bool ParseElement(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "Class") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kClass:
 				a_config.Element = ElementType::kClass;
-			}
-			else if (token == "CombatStyle") {
+				break;
+
+			case Symbol::kCombatStyle:
 				a_config.Element = ElementType::kCombatStyle;
-			}
-			else if (token == "DefaultOutfit") {
+				break;
+
+			case Symbol::kDefaultOutfit:
 				a_config.Element = ElementType::kDefaultOutfit;
-			}
-			else if (token == "FullName") {
+				break;
+
+			case Symbol::kFullName:
 				a_config.Element = ElementType::kFullName;
-			}
-			else if (token == "HairColor") {
+				break;
+
+			case Symbol::kHairColor:
 				a_config.Element = ElementType::kHairColor;
-			}
-			else if (token == "HeadParts") {
+				break;
+
+			case Symbol::kHeadParts:
 				a_config.Element = ElementType::kHeadParts;
-			}
-			else if (token == "HeadTexture") {
+				break;
+
+			case Symbol::kHeadTexture:
 				a_config.Element = ElementType::kHeadTexture;
-			}
-			else if (token == "HeightMax") {
+				break;
+
+			case Symbol::kHeightMax:
 				a_config.Element = ElementType::kHeightMax;
-			}
-			else if (token == "HeightMin") {
+				break;
+
+			case Symbol::kHeightMin:
 				a_config.Element = ElementType::kHeightMin;
-			} 
-			else if (token == "IsChargenFacePreset") {
+				break;
+
+			case Symbol::kIsChargenFacePreset:
 				a_config.Element = ElementType::kIsChargenFacePreset;
-			}
-			else if (token == "Morphs") {
+				break;
+
+			case Symbol::kMorphs:
 				a_config.Element = ElementType::kMorphs;
-			}
-			else if (token == "Race") {
+				break;
+
+			case Symbol::kRace:
 				a_config.Element = ElementType::kRace;
-			}
-			else if (token == "Sex") {
+				break;
+
+			case Symbol::kSex:
 				a_config.Element = ElementType::kSex;
-			}
-			else if (token == "Skin") {
+				break;
+
+			case Symbol::kSkin:
 				a_config.Element = ElementType::kSkin;
-			}
-			else if (token == "Tints") {
+				break;
+
+			case Symbol::kTints:
 				a_config.Element = ElementType::kTints;
-			}
-			else if (token == "WeightFat") {
+				break;
+
+			case Symbol::kWeightFat:
 				a_config.Element = ElementType::kWeightFat;
-			}
-			else if (token == "WeightMuscular") {
+				break;
+
+			case Symbol::kWeightMuscular:
 				a_config.Element = ElementType::kWeightMuscular;
-			}
-			else if (token == "WeightThin") {
+				break;
+
+			case Symbol::kWeightThin:
 				a_config.Element = ElementType::kWeightThin;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid ElementName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -452,9 +498,8 @@ namespace NPCs {
 
 			if (a_config.Element == ElementType::kClass || a_config.Element == ElementType::kCombatStyle || a_config.Element == ElementType::kDefaultOutfit ||
 				a_config.Element == ElementType::kHairColor || a_config.Element == ElementType::kHeadTexture || a_config.Element == ElementType::kRace|| a_config.Element == ElementType::kSkin) {
-				token = reader.Peek();
-				if (token == "null") {
-					a_config.AssignValue = std::any(std::string(reader.GetToken()));
+				if (reader.PeekSymbol() == Symbol::kNull) {
+					a_config.AssignValue = Utils::FormReference{ reader.GetToken() };
 				}
 				else {
 					auto form = ParseForm();
@@ -462,7 +507,7 @@ namespace NPCs {
 						return false;
 					}
 
-					a_config.AssignValue = std::any(form.value());
+					a_config.AssignValue = form.value();
 				}
 			}
 			else if (a_config.Element == ElementType::kFullName) {
@@ -476,7 +521,7 @@ namespace NPCs {
 					return false;
 				}
 
-				a_config.AssignValue = std::any(std::string(token.substr(1, token.length() - 2)));
+				a_config.AssignValue = token.substr(1, token.length() - 2);
 			}
 			else if (a_config.Element == ElementType::kHeightMax || a_config.Element == ElementType::kHeightMin ||
 				     a_config.Element == ElementType::kWeightFat || a_config.Element == ElementType::kWeightMuscular || a_config.Element == ElementType::kWeightThin) {
@@ -485,17 +530,20 @@ namespace NPCs {
 					return false;
 				}
 
-				a_config.AssignValue = std::any(opValue.value());
+				a_config.AssignValue = opValue.value();
 			}
 			else if (a_config.Element == ElementType::kIsChargenFacePreset) {
 				token = reader.GetToken();
-				if (token == "true") {
-					a_config.AssignValue = std::any(true);
-				}
-				else if (token == "false") {
-					a_config.AssignValue = std::any(false);
-				}
-				else {
+				switch (reader.GetLastSymbol()) {
+				case Symbol::kTrue:
+					a_config.AssignValue = true;
+					break;
+
+				case Symbol::kFalse:
+					a_config.AssignValue = false;
+					break;
+
+				default:
 					logger::warn("Line {}, Col {}: Invalid value '{}'. For IsChargenFacePreset, the value must be 'true' or 'false'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 					return false;
 				}
@@ -519,7 +567,7 @@ namespace NPCs {
 					return false;
 				}
 
-				a_config.AssignValue = std::any(static_cast<std::uint8_t>(parsedValue));
+				a_config.AssignValue = static_cast<std::uint8_t>(parsedValue);
 			}
 
 			return true;
@@ -529,19 +577,24 @@ namespace NPCs {
 			ConfigData::Operation newOp;
 
 			auto token = reader.GetToken();
-			if (token == "Clear") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kClear:
 				newOp.OpType = OperationType::kClear;
-			}
-			else if (token == "Add") {
+				break;
+
+			case Symbol::kAdd:
 				newOp.OpType = OperationType::kAdd;
-			}
-			else if (token == "Set") {
+				break;
+
+			case Symbol::kSet:
 				newOp.OpType = OperationType::kSet;
-			}
-			else if (token == "Delete") {
+				break;
+
+			case Symbol::kDelete:
 				newOp.OpType = OperationType::kDelete;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid OperationName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -579,12 +632,12 @@ namespace NPCs {
 			switch (a_config.Element) {
 			case ElementType::kHeadParts:
 				if (newOp.OpType != OperationType::kClear) {
-					std::optional<std::string> opForm = ParseForm();
+					std::optional<Utils::FormReference> opForm = ParseForm();
 					if (!opForm.has_value()) {
 						return false;
 					}
 
-					newOp.OpData = std::any(opForm.value());
+					newOp.OpData = opForm.value();
 				}
 
 				break;
@@ -621,7 +674,7 @@ namespace NPCs {
 						morphData.Value = morphValue.value();
 					}
 
-					newOp.OpData = std::any(morphData);
+					newOp.OpData = morphData;
 				}
 
 				break;
@@ -747,7 +800,7 @@ namespace NPCs {
 						tintData.Alpha = tintAlpha.value();
 					}
 
-					newOp.OpData = std::any(tintData);
+					newOp.OpData = tintData;
 				}
 
 				break;
@@ -766,12 +819,13 @@ namespace NPCs {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<NPCParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<NPCParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+		g_configsRead.count_down();
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::TESNPC*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -784,89 +838,89 @@ namespace NPCs {
 			}
 
 			if (a_configData.Element == ElementType::kClass) {
-				std::string classFormStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+				const Utils::FormReference& classFormRef = std::get<Utils::FormReference>(a_configData.AssignValue.value());
 				RE::TESClass* _class = nullptr;
 
-				if (classFormStr != "null") {
-					RE::TESForm* classForm = Utils::GetFormFromString(classFormStr);
+				if (!classFormRef.IsNull()) {
+					RE::TESForm* classForm = classFormRef.Form;
 					if (!classForm) {
-						logger::warn("Invalid Form: '{}'.", classFormStr);
+						logger::warn("Invalid Form: '{}'.", classFormRef);
 						return;
 					}
 
 					_class = classForm->As<RE::TESClass>();
 					if (!_class) {
-						logger::warn("'{}' is not a Class.", classFormStr);
+						logger::warn("'{}' is not a Class.", classFormRef);
 						return;
 					}
 				}
 
-				g_patchMap[npc].Class = _class;
+				a_patchMap[npc].Class = _class;
 			}
 			else if (a_configData.Element == ElementType::kCombatStyle) {
-				std::string comStyleFormStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+				const Utils::FormReference& comStyleFormRef = std::get<Utils::FormReference>(a_configData.AssignValue.value());
 				RE::TESCombatStyle* comStyle = nullptr;
 
-				if (comStyleFormStr != "null") {
-					RE::TESForm* comStyleForm = Utils::GetFormFromString(comStyleFormStr);
+				if (!comStyleFormRef.IsNull()) {
+					RE::TESForm* comStyleForm = comStyleFormRef.Form;
 					if (!comStyleForm) {
-						logger::warn("Invalid Form: '{}'.", comStyleFormStr);
+						logger::warn("Invalid Form: '{}'.", comStyleFormRef);
 						return;
 					}
 					comStyle = comStyleForm->As<RE::TESCombatStyle>();
 					if (!comStyle) {
-						logger::warn("'{}' is not a CombatStyle.", comStyleFormStr);
+						logger::warn("'{}' is not a CombatStyle.", comStyleFormRef);
 						return;
 					}
 				}
 
-				g_patchMap[npc].CombatStyle = comStyle;
+				a_patchMap[npc].CombatStyle = comStyle;
 			}
 			else if (a_configData.Element == ElementType::kDefaultOutfit) {
-				std::string outfitFormStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+				const Utils::FormReference& outfitFormRef = std::get<Utils::FormReference>(a_configData.AssignValue.value());
 				RE::BGSOutfit* outfit = nullptr;
 
-				if (outfitFormStr != "null") {
-					RE::TESForm* outfitForm = Utils::GetFormFromString(outfitFormStr);
+				if (!outfitFormRef.IsNull()) {
+					RE::TESForm* outfitForm = outfitFormRef.Form;
 					if (!outfitForm) {
-						logger::warn("Invalid Form: '{}'.", outfitFormStr);
+						logger::warn("Invalid Form: '{}'.", outfitFormRef);
 						return;
 					}
 
 					outfit = outfitForm->As<RE::BGSOutfit>();
 					if (!outfit) {
-						logger::warn("'{}' is not a Outfit.", outfitFormStr);
+						logger::warn("'{}' is not a Outfit.", outfitFormRef);
 						return;
 					}
 				}
 
-				g_patchMap[npc].DefaultOutfit = outfit;
+				a_patchMap[npc].DefaultOutfit = outfit;
 			}
 			else if (a_configData.Element == ElementType::kFullName) {
-				g_patchMap[npc].FullName = std::any_cast<std::string>(a_configData.AssignValue.value());
+				a_patchMap[npc].FullName = std::string(std::get<std::string_view>(a_configData.AssignValue.value()));
 			}
 			else if (a_configData.Element == ElementType::kHairColor) {
-				std::string colorFormStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+				const Utils::FormReference& colorFormRef = std::get<Utils::FormReference>(a_configData.AssignValue.value());
 				RE::BGSColorForm* color = nullptr;
 
-				if (colorFormStr != "null") {
-					RE::TESForm* colorForm = Utils::GetFormFromString(colorFormStr);
+				if (!colorFormRef.IsNull()) {
+					RE::TESForm* colorForm = colorFormRef.Form;
 					if (!colorForm) {
-						logger::warn("Invalid Form: '{}'.", colorFormStr);
+						logger::warn("Invalid Form: '{}'.", colorFormRef);
 						return;
 					}
 
 					color = colorForm->As<RE::BGSColorForm>();
 					if (!color) {
-						logger::warn("'{}' is not a Color.", colorFormStr);
+						logger::warn("'{}' is not a Color.", colorFormRef);
 						return;
 					}
 				}
 
-				g_patchMap[npc].HairColor = color;
+				a_patchMap[npc].HairColor = color;
 			}
 			else if (a_configData.Element == ElementType::kHeadParts) {
-				PatchData& patchData = g_patchMap[npc];
+				PatchData& patchData = a_patchMap[npc];
 
 				if (!patchData.HeadParts.has_value()) {
 					patchData.HeadParts = PatchData::HeadPartsData{};
@@ -877,17 +931,17 @@ namespace NPCs {
 						patchData.HeadParts->Clear = true;
 					}
 					else if (op.OpType == OperationType::kAdd || op.OpType == OperationType::kDelete) {
-						std::string opFormStr = std::any_cast<std::string>(op.OpData.value());
+						const Utils::FormReference& opFormRef = std::get<Utils::FormReference>(op.OpData.value());
 
-						RE::TESForm* opForm = Utils::GetFormFromString(opFormStr);
+						RE::TESForm* opForm = opFormRef.Form;
 						if (!opForm) {
-							logger::warn("Invalid Form: '{}'.", opFormStr);
+							logger::warn("Invalid Form: '{}'.", opFormRef);
 							continue;
 						}
 
 						RE::BGSHeadPart* headPart = opForm->As<RE::BGSHeadPart>();
 						if (!headPart) {
-							logger::warn("'{}' is not a HeadPart.", opFormStr);
+							logger::warn("'{}' is not a HeadPart.", opFormRef);
 							continue;
 						}
 
@@ -901,36 +955,36 @@ namespace NPCs {
 				}
 			}
 			else if (a_configData.Element == ElementType::kHeadTexture) {
-				std::string texFormStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+				const Utils::FormReference& texFormRef = std::get<Utils::FormReference>(a_configData.AssignValue.value());
 				RE::BGSTextureSet* textureSet = nullptr;
 
-				if (texFormStr != "null") {
-					RE::TESForm* texForm = Utils::GetFormFromString(texFormStr);
+				if (!texFormRef.IsNull()) {
+					RE::TESForm* texForm = texFormRef.Form;
 					if (!texForm) {
-						logger::warn("Invalid Form: '{}'.", texFormStr);
+						logger::warn("Invalid Form: '{}'.", texFormRef);
 						return;
 					}
 
 					textureSet = texForm->As<RE::BGSTextureSet>();
 					if (!textureSet) {
-						logger::warn("'{}' is not a TextureSet.", texFormStr);
+						logger::warn("'{}' is not a TextureSet.", texFormRef);
 						return;
 					}
 				}
 
-				g_patchMap[npc].HeadTexture = textureSet;
+				a_patchMap[npc].HeadTexture = textureSet;
 			}
 			else if (a_configData.Element == ElementType::kHeightMax) {
-				g_patchMap[npc].HeightMax = std::any_cast<float>(a_configData.AssignValue.value());
+				a_patchMap[npc].HeightMax = std::get<float>(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kHeightMin) {
-				g_patchMap[npc].HeightMin = std::any_cast<float>(a_configData.AssignValue.value());
+				a_patchMap[npc].HeightMin = std::get<float>(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kIsChargenFacePreset) {
-				g_patchMap[npc].IsChargenFacePreset = std::any_cast<bool>(a_configData.AssignValue.value());
+				a_patchMap[npc].IsChargenFacePreset = std::get<bool>(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kMorphs) {
-				PatchData& patchData = g_patchMap[npc];
+				PatchData& patchData = a_patchMap[npc];
 
 				if (!patchData.Morphs.has_value()) {
 					patchData.Morphs = PatchData::MorphsData{};
@@ -941,7 +995,7 @@ namespace NPCs {
 						patchData.Morphs->Clear = true;
 					}
 					else if (op.OpType == OperationType::kSet || op.OpType == OperationType::kDelete) {
-						auto morphData = std::any_cast<ConfigData::Operation::MorphData>(op.OpData.value());
+						const auto& morphData = std::get<ConfigData::Operation::MorphData>(op.OpData.value());
 
 						if (op.OpType == OperationType::kSet) {
 							patchData.Morphs->SetMorphMap.insert(std::make_pair(morphData.Key, morphData.Value));
@@ -953,50 +1007,50 @@ namespace NPCs {
 				}
 			}
 			else if (a_configData.Element == ElementType::kRace) {
-				std::string raceFormStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+				const Utils::FormReference& raceFormRef = std::get<Utils::FormReference>(a_configData.AssignValue.value());
 				RE::TESRace* race = nullptr;
 
-				if (raceFormStr != "null") {
-					RE::TESForm* raceForm = Utils::GetFormFromString(raceFormStr);
+				if (!raceFormRef.IsNull()) {
+					RE::TESForm* raceForm = raceFormRef.Form;
 					if (!raceForm) {
-						logger::warn("Invalid Form: '{}'.", raceFormStr);
+						logger::warn("Invalid Form: '{}'.", raceFormRef);
 						return;
 					}
 
 					race = raceForm->As<RE::TESRace>();
 					if (!race) {
-						logger::warn("'{}' is not a Race.", raceFormStr);
+						logger::warn("'{}' is not a Race.", raceFormRef);
 						return;
 					}
 				}
 
-				g_patchMap[npc].Race = race;
+				a_patchMap[npc].Race = race;
 			}
 			else if (a_configData.Element == ElementType::kSex) {
-				g_patchMap[npc].Sex = std::any_cast<std::uint8_t>(a_configData.AssignValue.value());
+				a_patchMap[npc].Sex = std::get<std::uint8_t>(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kSkin) {
-				std::string armoFormStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+				const Utils::FormReference& armoFormRef = std::get<Utils::FormReference>(a_configData.AssignValue.value());
 				RE::TESObjectARMO* armo = nullptr;
 
-				if (armoFormStr != "null") {
-					RE::TESForm* armoForm = Utils::GetFormFromString(armoFormStr);
+				if (!armoFormRef.IsNull()) {
+					RE::TESForm* armoForm = armoFormRef.Form;
 					if (!armoForm) {
-						logger::warn("Invalid Form: '{}'.", armoFormStr);
+						logger::warn("Invalid Form: '{}'.", armoFormRef);
 						return;
 					}
 
 					armo = armoForm->As<RE::TESObjectARMO>();
 					if (!armo) {
-						logger::warn("'{}' is not a Armor.", armoFormStr);
+						logger::warn("'{}' is not a Armor.", armoFormRef);
 						return;
 					}
 				}
 
-				g_patchMap[npc].Skin = armo;
+				a_patchMap[npc].Skin = armo;
 			}
 			else if (a_configData.Element == ElementType::kTints) {
-				PatchData& patchData = g_patchMap[npc];
+				PatchData& patchData = a_patchMap[npc];
 
 				if (!patchData.Tints.has_value()) {
 					patchData.Tints = PatchData::TintsData{};
@@ -1007,7 +1061,7 @@ namespace NPCs {
 						patchData.Tints->Clear = true;
 					}
 					else if (op.OpType == OperationType::kSet || op.OpType == OperationType::kDelete) {
-						auto tintData = std::any_cast<ConfigData::Operation::TintData>(op.OpData.value());
+						const auto& tintData = std::get<ConfigData::Operation::TintData>(op.OpData.value());
 
 						if (op.OpType == OperationType::kSet) {
 							patchData.Tints->SetTintMap.insert(std::make_pair(tintData.Index, std::make_pair(tintData.Color, tintData.Alpha)));
@@ -1019,13 +1073,13 @@ namespace NPCs {
 				}
 			}
 			else if (a_configData.Element == ElementType::kWeightFat) {
-				g_patchMap[npc].WeightFat = std::any_cast<float>(a_configData.AssignValue.value());
+				a_patchMap[npc].WeightFat = std::get<float>(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kWeightMuscular) {
-				g_patchMap[npc].WeightMuscular = std::any_cast<float>(a_configData.AssignValue.value());
+				a_patchMap[npc].WeightMuscular = std::get<float>(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kWeightThin) {
-				g_patchMap[npc].WeightThin = std::any_cast<float>(a_configData.AssignValue.value());
+				a_patchMap[npc].WeightThin = std::get<float>(a_configData.AssignValue.value());
 			}
 		}
 	}
@@ -1035,11 +1089,18 @@ namespace NPCs {
 			return;
 		}
 
+		// ReadConfigs runs in the background and the hook can fire before it has finished
+		g_configsRead.wait();
+
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::ResolveForms(g_configVec);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 		g_prepared = true;
 
+		g_configVec.clear();
+		g_arena.Release();
+
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
 	}
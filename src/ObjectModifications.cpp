@@ -1,11 +1,10 @@
 #include "ObjectModifications.h"
 
-#include <any>
-#include <regex>
-#include <unordered_set>
+#include <variant>
 
 #include "ConfigUtils.h"
 #include "Parsers.h"
+#include "PerfectHash.h"
 #include "Utils.h"
 
 namespace ObjectModifications {
@@ -53,14 +52,203 @@ namespace ObjectModifications {
 		}
 	}
 
+	enum class ValueType {
+		kInt,
+		kFloat,
+		kBool,
+		kEnum,
+		kFormIDInt,
+		kFormIDFloat
+	};
+
+	std::string_view ValueTypeToString(ValueType a_value) {
+		switch (a_value) {
+		case ValueType::kInt:
+			return "Int";
+		case ValueType::kFloat:
+			return "Float";
+		case ValueType::kBool:
+			return "Bool";
+		case ValueType::kEnum:
+			return "Enum";
+		case ValueType::kFormIDInt:
+			return "FormIDInt";
+		case ValueType::kFormIDFloat:
+			return "FormIDFloat";
+		default:
+			return std::string_view{};
+		}
+	}
+
+	enum class FunctionType {
+		kSet,
+		kAdd,
+		kMulAdd,
+		kAnd,
+		kOr,
+		kRem
+	};
+
+	std::string_view FunctionTypeToString(FunctionType a_value) {
+		switch (a_value) {
+		case FunctionType::kSet:
+			return "SET";
+		case FunctionType::kAdd:
+			return "ADD";
+		case FunctionType::kMulAdd:
+			return "MULADD";
+		case FunctionType::kAnd:
+			return "AND";
+		case FunctionType::kOr:
+			return "OR";
+		case FunctionType::kRem:
+			return "REM";
+		default:
+			return std::string_view{};
+		}
+	}
+
+	constexpr std::uint32_t FunctionTypeBit(FunctionType a_value) {
+		return 1u << static_cast<std::uint32_t>(a_value);
+	}
+
+	// Function types each value type accepts, indexed by ValueType
+	constexpr std::array<std::uint32_t, 6> AllowedFunctionTypes{
+		FunctionTypeBit(FunctionType::kSet) | FunctionTypeBit(FunctionType::kAdd) | FunctionTypeBit(FunctionType::kMulAdd),  // kInt
+		FunctionTypeBit(FunctionType::kSet) | FunctionTypeBit(FunctionType::kAdd) | FunctionTypeBit(FunctionType::kMulAdd),  // kFloat
+		FunctionTypeBit(FunctionType::kSet) | FunctionTypeBit(FunctionType::kAnd) | FunctionTypeBit(FunctionType::kOr),      // kBool
+		FunctionTypeBit(FunctionType::kSet),                                                                                // kEnum
+		FunctionTypeBit(FunctionType::kSet) | FunctionTypeBit(FunctionType::kRem) | FunctionTypeBit(FunctionType::kAdd),     // kFormIDInt
+		FunctionTypeBit(FunctionType::kSet) | FunctionTypeBit(FunctionType::kRem) | FunctionTypeBit(FunctionType::kAdd)      // kFormIDFloat
+	};
+
+	constexpr std::uint32_t NoTarget = 0xFFFFFFFF;
+
+	// Every property an OMOD can change, with its target index on each form type the OMOD can attach to
+	struct Property {
+		std::string_view Name;
+		std::uint32_t WeaponTarget;
+		std::uint32_t ArmorTarget;
+		std::uint32_t ActorTarget;
+	};
+
+	constexpr std::array Properties{
+		Property{ "Enchantments"sv, 65, 0, 3 },
+		Property{ "BashImpactDataSet"sv, 63, 1, NoTarget },
+		Property{ "BlockMaterial"sv, 64, 2, NoTarget },
+		Property{ "Keywords"sv, 31, 3, 0 },
+		Property{ "Weight"sv, 30, 4, NoTarget },
+		Property{ "Value"sv, 29, 5, NoTarget },
+		Property{ "Rating"sv, NoTarget, 6, NoTarget },
+		Property{ "AddonIndex"sv, NoTarget, 7, NoTarget },
+		Property{ "BodyPart"sv, NoTarget, 8, NoTarget },
+		Property{ "DamageTypeValue"sv, NoTarget, 9, NoTarget },
+		Property{ "ActorValues"sv, 94, 10, NoTarget },
+		Property{ "Health"sv, NoTarget, 11, NoTarget },
+		Property{ "ColorRemappingIndex"sv, 88, 12, 4 },
+		Property{ "MaterialSwaps"sv, 89, 13, 5 },
+		Property{ "ForcedInventory"sv, NoTarget, NoTarget, 1 },
+		Property{ "XPOffset"sv, NoTarget, NoTarget, 2 },
+		Property{ "Speed"sv, 0, NoTarget, NoTarget },
+		Property{ "Reach"sv, 1, NoTarget, NoTarget },
+		Property{ "MinRange"sv, 2, NoTarget, NoTarget },
+		Property{ "MaxRange"sv, 3, NoTarget, NoTarget },
+		Property{ "AttackDelaySec"sv, 4, NoTarget, NoTarget },
+		Property{ "Unknown 5"sv, 5, NoTarget, NoTarget },
+		Property{ "OutOfRangeDamageMult"sv, 6, NoTarget, NoTarget },
+		Property{ "SecondaryDamage"sv, 7, NoTarget, NoTarget },
+		Property{ "CriticalChargeBonus"sv, 8, NoTarget, NoTarget },
+		Property{ "HitBehaviour"sv, 9, NoTarget, NoTarget },
+		Property{ "Rank"sv, 10, NoTarget, NoTarget },
+		Property{ "Unknown 11"sv, 11, NoTarget, NoTarget },
+		Property{ "AmmoCapacity"sv, 12, NoTarget, NoTarget },
+		Property{ "Unknown 13"sv, 13, NoTarget, NoTarget },
+		Property{ "Unknown 14"sv, 14, NoTarget, NoTarget },
+		Property{ "Type"sv, 15, NoTarget, NoTarget },
+		Property{ "IsPlayerOnly"sv, 16, NoTarget, NoTarget },
+		Property{ "NPCsUseAmmo"sv, 17, NoTarget, NoTarget },
+		Property{ "HasChargingReload"sv, 18, NoTarget, NoTarget },
+		Property{ "IsMinorCrime"sv, 19, NoTarget, NoTarget },
+		Property{ "IsFixedRange"sv, 20, NoTarget, NoTarget },
+		Property{ "HasEffectOnDeath"sv, 21, NoTarget, NoTarget },
+		Property{ "HasAlternateRumble"sv, 22, NoTarget, NoTarget },
+		Property{ "IsNonHostile"sv, 23, NoTarget, NoTarget },
+		Property{ "IgnoreResist"sv, 24, NoTarget, NoTarget },
+		Property{ "IsAutomatic"sv, 25, NoTarget, NoTarget },
+		Property{ "CantDrop"sv, 26, NoTarget, NoTarget },
+		Property{ "IsNonPlayable"sv, 27, NoTarget, NoTarget },
+		Property{ "AttackDamage"sv, 28, NoTarget, NoTarget },
+		Property{ "AimModel"sv, 32, NoTarget, NoTarget },
+		Property{ "AimModelMinConeDegrees"sv, 33, NoTarget, NoTarget },
+		Property{ "AimModelMaxConeDegrees"sv, 34, NoTarget, NoTarget },
+		Property{ "AimModelConeIncreasePerShot"sv, 35, NoTarget, NoTarget },
+		Property{ "AimModelConeDecreasePerSec"sv, 36, NoTarget, NoTarget },
+		Property{ "AimModelConeDecreaseDelayMs"sv, 37, NoTarget, NoTarget },
+		Property{ "AimModelConeSneakMultiplier"sv, 38, NoTarget, NoTarget },
+		Property{ "AimModelRecoilDiminishSpringForce"sv, 39, NoTarget, NoTarget },
+		Property{ "AimModelRecoilDiminishSightsMult"sv, 40, NoTarget, NoTarget },
+		Property{ "AimModelRecoilMaxDegPerShot"sv, 41, NoTarget, NoTarget },
+		Property{ "AimModelRecoilMinDegPerShot"sv, 42, NoTarget, NoTarget },
+		Property{ "AimModelRecoilHipMult"sv, 43, NoTarget, NoTarget },
+		Property{ "AimModelRecoilShotsForRunaway"sv, 44, NoTarget, NoTarget },
+		Property{ "AimModelRecoilArcDeg"sv, 45, NoTarget, NoTarget },
+		Property{ "AimModelRecoilArcRotateDeg"sv, 46, NoTarget, NoTarget },
+		Property{ "AimModelConeIronSightsMultiplier"sv, 47, NoTarget, NoTarget },
+		Property{ "HasScope"sv, 48, NoTarget, NoTarget },
+		Property{ "ZoomDataFOVMult"sv, 49, NoTarget, NoTarget },
+		Property{ "FireSeconds"sv, 50, NoTarget, NoTarget },
+		Property{ "NumProjectiles"sv, 51, NoTarget, NoTarget },
+		Property{ "AttackSound"sv, 52, NoTarget, NoTarget },
+		Property{ "AttackSound2D"sv, 53, NoTarget, NoTarget },
+		Property{ "AttackLoop"sv, 54, NoTarget, NoTarget },
+		Property{ "AttackFailSound"sv, 55, NoTarget, NoTarget },
+		Property{ "IdleSound"sv, 56, NoTarget, NoTarget },
+		Property{ "EquipSound"sv, 57, NoTarget, NoTarget },
+		Property{ "UnEquipSound"sv, 58, NoTarget, NoTarget },
+		Property{ "SoundLevel"sv, 59, NoTarget, NoTarget },
+		Property{ "ImpactDataSet"sv, 60, NoTarget, NoTarget },
+		Property{ "Ammo"sv, 61, NoTarget, NoTarget },
+		Property{ "CritEffect"sv, 62, NoTarget, NoTarget },
+		Property{ "AimModelBaseStability"sv, 66, NoTarget, NoTarget },
+		Property{ "ZoomData"sv, 67, NoTarget, NoTarget },
+		Property{ "ZoomDataOverlay"sv, 68, NoTarget, NoTarget },
+		Property{ "ZoomDataImageSpace"sv, 69, NoTarget, NoTarget },
+		Property{ "ZoomDataCameraOffsetX"sv, 70, NoTarget, NoTarget },
+		Property{ "ZoomDataCameraOffsetY"sv, 71, NoTarget, NoTarget },
+		Property{ "ZoomDataCameraOffsetZ"sv, 72, NoTarget, NoTarget },
+		Property{ "EquipSlot"sv, 73, NoTarget, NoTarget },
+		Property{ "SoundLevelMult"sv, 74, NoTarget, NoTarget },
+		Property{ "NPCAmmoList"sv, 75, NoTarget, NoTarget },
+		Property{ "ReloadSpeed"sv, 76, NoTarget, NoTarget },
+		Property{ "DamageTypeValues"sv, 77, NoTarget, NoTarget },
+		Property{ "AccuracyBonus"sv, 78, NoTarget, NoTarget },
+		Property{ "AttackActionPointCost"sv, 79, NoTarget, NoTarget },
+		Property{ "OverrideProjectile"sv, 80, NoTarget, NoTarget },
+		Property{ "HasBoltAction"sv, 81, NoTarget, NoTarget },
+		Property{ "StaggerValue"sv, 82, NoTarget, NoTarget },
+		Property{ "SightedTransitionSeconds"sv, 83, NoTarget, NoTarget },
+		Property{ "FullPowerSeconds"sv, 84, NoTarget, NoTarget },
+		Property{ "HoldInputToPower"sv, 85, NoTarget, NoTarget },
+		Property{ "HasRepeatableSingleFire"sv, 86, NoTarget, NoTarget },
+		Property{ "MinPowerPerShot"sv, 87, NoTarget, NoTarget },
+		Property{ "CriticalDamageMult"sv, 90, NoTarget, NoTarget },
+		Property{ "FastEquipSound"sv, 91, NoTarget, NoTarget },
+		Property{ "DisableShells"sv, 92, NoTarget, NoTarget },
+		Property{ "HasChargingAttack"sv, 93, NoTarget, NoTarget },
+	};
+
+	constexpr PerfectHash::Table<Properties> g_propertyTable;
+
+	static_assert(PerfectHash::IsTableValid<Properties, g_propertyTable>(), "Property names must be unique");
+
 	struct ConfigData {
 		struct Operation {
 			struct Data {
-				std::string ValueType;
-				std::string FunctionType;
-				std::string Property;
-				std::any Value1;
-				std::any Value2;
+				ValueType ValType;
+				FunctionType FuncType;
+				std::uint32_t PropertyIndex;
+				std::variant<std::monostate, std::uint32_t, float, bool, Utils::FormReference> Value1;
+				std::variant<std::monostate, std::uint32_t, float, bool, Utils::FormReference> Value2;
 			};
 
 			OperationType OpType;
@@ -68,11 +256,26 @@ namespace ObjectModifications {
 		};
 
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
-		std::vector<Operation> Operations;
+		Arenas::Vector<Operation> Operations;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation::Data& a_data) {
+		a_ar(a_data.ValType, a_data.FuncType, a_data.PropertyIndex, a_data.Value1, a_data.Value2);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation& a_operation) {
+		a_ar(a_operation.OpType, a_operation.OpData);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.Operations);
+	}
+
 	using PropertyContainer = std::array<std::byte, sizeof(RE::BGSMod::Property::Mod)>;
 
 	struct PatchData {
@@ -84,241 +287,14 @@ namespace ObjectModifications {
 		std::optional<PropertiesData> Properties;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::BGSMod::Attachment::Mod*, PatchData> g_patchMap;
 
-	const std::unordered_set<std::string_view> g_propertySet = {
-		"Enchantments",
-		"BashImpactDataSet",
-		"BlockMaterial",
-		"Keywords",
-		"Weight",
-		"Value",
-		"Rating",
-		"AddonIndex",
-		"BodyPart",
-		"DamageTypeValue",
-		"ActorValues",
-		"Health",
-		"ColorRemappingIndex",
-		"MaterialSwaps",
-		"ForcedInventory",
-		"XPOffset",
-		"Speed",
-		"Reach",
-		"MinRange",
-		"MaxRange",
-		"AttackDelaySec",
-		"Unknown 5",
-		"OutOfRangeDamageMult",
-		"SecondaryDamage",
-		"CriticalChargeBonus",
-		"HitBehaviour",
-		"Rank",
-		"Unknown 11",
-		"AmmoCapacity",
-		"Unknown 13",
-		"Unknown 14",
-		"Type",
-		"IsPlayerOnly",
-		"NPCsUseAmmo",
-		"HasChargingReload",
-		"IsMinorCrime",
-		"IsFixedRange",
-		"HasEffectOnDeath",
-		"HasAlternateRumble",
-		"IsNonHostile",
-		"IgnoreResist",
-		"IsAutomatic",
-		"CantDrop",
-		"IsNonPlayable",
-		"AttackDamage",
-		"AimModel",
-		"AimModelMinConeDegrees",
-		"AimModelMaxConeDegrees",
-		"AimModelConeIncreasePerShot",
-		"AimModelConeDecreasePerSec",
-		"AimModelConeDecreaseDelayMs",
-		"AimModelConeSneakMultiplier",
-		"AimModelRecoilDiminishSpringForce",
-		"AimModelRecoilDiminishSightsMult",
-		"AimModelRecoilMaxDegPerShot",
-		"AimModelRecoilMinDegPerShot",
-		"AimModelRecoilHipMult",
-		"AimModelRecoilShotsForRunaway",
-		"AimModelRecoilArcDeg",
-		"AimModelRecoilArcRotateDeg",
-		"AimModelConeIronSightsMultiplier",
-		"HasScope",
-		"ZoomDataFOVMult",
-		"FireSeconds",
-		"NumProjectiles",
-		"AttackSound",
-		"AttackSound2D",
-		"AttackLoop",
-		"AttackFailSound",
-		"IdleSound",
-		"EquipSound",
-		"UnEquipSound",
-		"SoundLevel",
-		"ImpactDataSet",
-		"Ammo",
-		"CritEffect",
-		"AimModelBaseStability",
-		"ZoomData",
-		"ZoomDataOverlay",
-		"ZoomDataImageSpace",
-		"ZoomDataCameraOffsetX",
-		"ZoomDataCameraOffsetY",
-		"ZoomDataCameraOffsetZ",
-		"EquipSlot",
-		"SoundLevelMult",
-		"NPCAmmoList",
-		"ReloadSpeed",
-		"DamageTypeValues",
-		"AccuracyBonus",
-		"AttackActionPointCost",
-		"OverrideProjectile",
-		"HasBoltAction",
-		"StaggerValue",
-		"SightedTransitionSeconds",
-		"FullPowerSeconds",
-		"HoldInputToPower",
-		"HasRepeatableSingleFire",
-		"MinPowerPerShot",
-		"CriticalDamageMult",
-		"FastEquipSound",
-		"DisableShells",
-		"HasChargingAttack"
-	};
-
-	const std::unordered_map<std::string_view, std::uint32_t> g_armorPropertyMap = {
-		{ "Enchantments", 0 },
-		{ "BashImpactDataSet", 1 },
-		{ "BlockMaterial", 2 },
-		{ "Keywords", 3 },
-		{ "Weight", 4 },
-		{ "Value", 5 },
-		{ "Rating", 6 },
-		{ "AddonIndex", 7 },
-		{ "BodyPart", 8 },
-		{ "DamageTypeValue", 9 },
-		{ "ActorValues", 10 },
-		{ "Health", 11 },
-		{ "ColorRemappingIndex", 12 },
-		{ "MaterialSwaps", 13 }
-	};
-
-	const std::unordered_map<std::string_view, std::uint32_t> g_actorPropertyMap = {
-		{ "Keywords", 0 },
-		{ "ForcedInventory", 1 },
-		{ "XPOffset", 2 },
-		{ "Enchantments", 3 },
-		{ "ColorRemappingIndex", 4 },
-		{ "MaterialSwaps", 5 }
-	};
-
-	const std::unordered_map<std::string_view, std::uint32_t> g_weaponPropertyMap = {
-		{ "Speed", 0 },
-		{ "Reach", 1 },
-		{ "MinRange", 2 },
-		{ "MaxRange", 3 },
-		{ "AttackDelaySec", 4 },
-		{ "Unknown 5", 5 },
-		{ "OutOfRangeDamageMult", 6 },
-		{ "SecondaryDamage", 7 },
-		{ "CriticalChargeBonus", 8 },
-		{ "HitBehaviour", 9 },
-		{ "Rank", 10 },
-		{ "Unknown 11", 11 },
-		{ "AmmoCapacity", 12 },
-		{ "Unknown 13", 13 },
-		{ "Unknown 14", 14 },
-		{ "Type", 15 },
-		{ "IsPlayerOnly", 16 },
-		{ "NPCsUseAmmo", 17 },
-		{ "HasChargingReload", 18 },
-		{ "IsMinorCrime", 19 },
-		{ "IsFixedRange", 20 },
-		{ "HasEffectOnDeath", 21 },
-		{ "HasAlternateRumble", 22 },
-		{ "IsNonHostile", 23 },
-		{ "IgnoreResist", 24 },
-		{ "IsAutomatic", 25 },
-		{ "CantDrop", 26 },
-		{ "IsNonPlayable", 27 },
-		{ "AttackDamage", 28 },
-		{ "Value", 29 },
-		{ "Weight", 30 },
-		{ "Keywords", 31 },
-		{ "AimModel", 32 },
-		{ "AimModelMinConeDegrees", 33 },
-		{ "AimModelMaxConeDegrees", 34 },
-		{ "AimModelConeIncreasePerShot", 35 },
-		{ "AimModelConeDecreasePerSec", 36 },
-		{ "AimModelConeDecreaseDelayMs", 37 },
-		{ "AimModelConeSneakMultiplier", 38 },
-		{ "AimModelRecoilDiminishSpringForce", 39 },
-		{ "AimModelRecoilDiminishSightsMult", 40 },
-		{ "AimModelRecoilMaxDegPerShot", 41 },
-		{ "AimModelRecoilMinDegPerShot", 42 },
-		{ "AimModelRecoilHipMult", 43 },
-		{ "AimModelRecoilShotsForRunaway", 44 },
-		{ "AimModelRecoilArcDeg", 45 },
-		{ "AimModelRecoilArcRotateDeg", 46 },
-		{ "AimModelConeIronSightsMultiplier", 47 },
-		{ "HasScope", 48 },
-		{ "ZoomDataFOVMult", 49 },
-		{ "FireSeconds", 50 },
-		{ "NumProjectiles", 51 },
-		{ "AttackSound", 52 },
-		{ "AttackSound2D", 53 },
-		{ "AttackLoop", 54 },
-		{ "AttackFailSound", 55 },
-		{ "IdleSound", 56 },
-		{ "EquipSound", 57 },
-		{ "UnEquipSound", 58 },
-		{ "SoundLevel", 59 },
-		{ "ImpactDataSet", 60 },
-		{ "Ammo", 61 },
-		{ "CritEffect", 62 },
-		{ "BashImpactDataSet", 63 },
-		{ "BlockMaterial", 64 },
-		{ "Enchantments", 65 },
-		{ "AimModelBaseStability", 66 },
-		{ "ZoomData", 67 },
-		{ "ZoomDataOverlay", 68 },
-		{ "ZoomDataImageSpace", 69 },
-		{ "ZoomDataCameraOffsetX", 70 },
-		{ "ZoomDataCameraOffsetY", 71 },
-		{ "ZoomDataCameraOffsetZ", 72 },
-		{ "EquipSlot", 73 },
-		{ "SoundLevelMult", 74 },
-		{ "NPCAmmoList", 75 },
-		{ "ReloadSpeed", 76 },
-		{ "DamageTypeValues", 77 },
-		{ "AccuracyBonus", 78 },
-		{ "AttackActionPointCost", 79 },
-		{ "OverrideProjectile", 80 },
-		{ "HasBoltAction", 81 },
-		{ "StaggerValue", 82 },
-		{ "SightedTransitionSeconds", 83 },
-		{ "FullPowerSeconds", 84 },
-		{ "HoldInputToPower", 85 },
-		{ "HasRepeatableSingleFire", 86 },
-		{ "MinPowerPerShot", 87 },
-		{ "ColorRemappingIndex", 88 },
-		{ "MaterialSwaps", 89 },
-		{ "CriticalDamageMult", 90 },
-		{ "FastEquipSound", 91 },
-		{ "DisableShells", 92 },
-		{ "HasChargingAttack", 93 },
-		{ "ActorValues", 94 }
-	};
-
 	class ObjectModificationParser : public Parsers::Parser<ConfigData> {
 	public:
 		ObjectModificationParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		ObjectModificationParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -370,7 +346,7 @@ namespace ObjectModifications {
 				}
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -388,23 +364,23 @@ namespace ObjectModifications {
 						break;
 
 					case OperationType::kAdd:
-						if (a_configData.Operations[ii].OpData->ValueType == "Int") {
-							opLog = fmt::format(".{}({}, {}, {}, {}, {})", OperationTypeToString(a_configData.Operations[ii].OpType), a_configData.Operations[ii].OpData->ValueType, a_configData.Operations[ii].OpData->FunctionType, a_configData.Operations[ii].OpData->Property, std::any_cast<std::uint32_t>(a_configData.Operations[ii].OpData->Value1), std::any_cast<std::uint32_t>(a_configData.Operations[ii].OpData->Value2));
+						if (a_configData.Operations[ii].OpData->ValType == ValueType::kInt) {
+							opLog = fmt::format(".{}({}, {}, {}, {}, {})", OperationTypeToString(a_configData.Operations[ii].OpType), ValueTypeToString(a_configData.Operations[ii].OpData->ValType), FunctionTypeToString(a_configData.Operations[ii].OpData->FuncType), Properties[a_configData.Operations[ii].OpData->PropertyIndex].Name, std::get<std::uint32_t>(a_configData.Operations[ii].OpData->Value1), std::get<std::uint32_t>(a_configData.Operations[ii].OpData->Value2));
 						}
-						else if (a_configData.Operations[ii].OpData->ValueType == "Float") {
-							opLog = fmt::format(".{}({}, {}, {}, {}, {})", OperationTypeToString(a_configData.Operations[ii].OpType), a_configData.Operations[ii].OpData->ValueType, a_configData.Operations[ii].OpData->FunctionType, a_configData.Operations[ii].OpData->Property, std::any_cast<float>(a_configData.Operations[ii].OpData->Value1), std::any_cast<float>(a_configData.Operations[ii].OpData->Value2));
+						else if (a_configData.Operations[ii].OpData->ValType == ValueType::kFloat) {
+							opLog = fmt::format(".{}({}, {}, {}, {}, {})", OperationTypeToString(a_configData.Operations[ii].OpType), ValueTypeToString(a_configData.Operations[ii].OpData->ValType), FunctionTypeToString(a_configData.Operations[ii].OpData->FuncType), Properties[a_configData.Operations[ii].OpData->PropertyIndex].Name, std::get<float>(a_configData.Operations[ii].OpData->Value1), std::get<float>(a_configData.Operations[ii].OpData->Value2));
 						} 
-						else if (a_configData.Operations[ii].OpData->ValueType == "Bool") {
-							opLog = fmt::format(".{}({}, {}, {}, {}, {})", OperationTypeToString(a_configData.Operations[ii].OpType), a_configData.Operations[ii].OpData->ValueType, a_configData.Operations[ii].OpData->FunctionType, a_configData.Operations[ii].OpData->Property, std::any_cast<bool>(a_configData.Operations[ii].OpData->Value1), std::any_cast<bool>(a_configData.Operations[ii].OpData->Value2));
+						else if (a_configData.Operations[ii].OpData->ValType == ValueType::kBool) {
+							opLog = fmt::format(".{}({}, {}, {}, {}, {})", OperationTypeToString(a_configData.Operations[ii].OpType), ValueTypeToString(a_configData.Operations[ii].OpData->ValType), FunctionTypeToString(a_configData.Operations[ii].OpData->FuncType), Properties[a_configData.Operations[ii].OpData->PropertyIndex].Name, std::get<bool>(a_configData.Operations[ii].OpData->Value1), std::get<bool>(a_configData.Operations[ii].OpData->Value2));
 						}
-						else if (a_configData.Operations[ii].OpData->ValueType == "Enum") {
-							opLog = fmt::format(".{}({}, {}, {}, {})", OperationTypeToString(a_configData.Operations[ii].OpType), a_configData.Operations[ii].OpData->ValueType, a_configData.Operations[ii].OpData->FunctionType, a_configData.Operations[ii].OpData->Property, std::any_cast<std::uint32_t>(a_configData.Operations[ii].OpData->Value1));
+						else if (a_configData.Operations[ii].OpData->ValType == ValueType::kEnum) {
+							opLog = fmt::format(".{}({}, {}, {}, {})", OperationTypeToString(a_configData.Operations[ii].OpType), ValueTypeToString(a_configData.Operations[ii].OpData->ValType), FunctionTypeToString(a_configData.Operations[ii].OpData->FuncType), Properties[a_configData.Operations[ii].OpData->PropertyIndex].Name, std::get<std::uint32_t>(a_configData.Operations[ii].OpData->Value1));
 						}
-						else if (a_configData.Operations[ii].OpData->ValueType == "FormIDInt") {
-							opLog = fmt::format(".{}({}, {}, {}, {})", OperationTypeToString(a_configData.Operations[ii].OpType), a_configData.Operations[ii].OpData->ValueType, a_configData.Operations[ii].OpData->FunctionType, a_configData.Operations[ii].OpData->Property, std::any_cast<std::string>(a_configData.Operations[ii].OpData->Value1));
+						else if (a_configData.Operations[ii].OpData->ValType == ValueType::kFormIDInt) {
+							opLog = fmt::format(".{}({}, {}, {}, {})", OperationTypeToString(a_configData.Operations[ii].OpType), ValueTypeToString(a_configData.Operations[ii].OpData->ValType), FunctionTypeToString(a_configData.Operations[ii].OpData->FuncType), Properties[a_configData.Operations[ii].OpData->PropertyIndex].Name, std::get<Utils::FormReference>(a_configData.Operations[ii].OpData->Value1));
 						}
-						else if (a_configData.Operations[ii].OpData->ValueType == "FormIDFloat") {
-							opLog = fmt::format(".{}({}, {}, {}, {}, {})", OperationTypeToString(a_configData.Operations[ii].OpType), a_configData.Operations[ii].OpData->ValueType, a_configData.Operations[ii].OpData->FunctionType, a_configData.Operations[ii].OpData->Property, std::any_cast<std::string>(a_configData.Operations[ii].OpData->Value1), std::any_cast<float>(a_configData.Operations[ii].OpData->Value2));
+						else if (a_configData.Operations[ii].OpData->ValType == ValueType::kFormIDFloat) {
+							opLog = fmt::format(".{}({}, {}, {}, {}, {})", OperationTypeToString(a_configData.Operations[ii].OpType), ValueTypeToString(a_configData.Operations[ii].OpData->ValType), FunctionTypeToString(a_configData.Operations[ii].OpData->FuncType), Properties[a_configData.Operations[ii].OpData->PropertyIndex].Name, std::get<Utils::FormReference>(a_configData.Operations[ii].OpData->Value1), std::get<float>(a_configData.Operations[ii].OpData->Value2));
 						}
 						break;
 
@@ -424,7 +400,7 @@ namespace ObjectModifications {
 
 		bool ParseFilter(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_configData.Filter = FilterType::kFormID;
 			} else {
 				logger::warn("Line {}, Col {}: Invalid FilterName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
@@ -455,7 +431,7 @@ namespace ObjectModifications {
 
 		bool ParseElement(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "Properties") {
+			if (reader.GetLastSymbol() == Symbol::kProperties) {
 				a_configData.Element = ElementType::kProperties;
 			} else {
 				logger::warn("Line {}, Col {}: Invalid ElementName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
@@ -469,11 +445,16 @@ namespace ObjectModifications {
 			OperationType opType;
 
 			auto token = reader.GetToken();
-			if (token == "Clear") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kClear:
 				opType = OperationType::kClear;
-			} else if (token == "Add") {
+				break;
+
+			case Symbol::kAdd:
 				opType = OperationType::kAdd;
-			} else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid OperationName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -493,7 +474,7 @@ namespace ObjectModifications {
 					return false;
 				}
 
-				opData->ValueType = valueType.value();
+				opData->ValType = valueType.value();
 
 				token = reader.GetToken();
 				if (token != ",") {
@@ -506,7 +487,13 @@ namespace ObjectModifications {
 					return false;
 				}
 
-				opData->FunctionType = funcType.value();
+				opData->FuncType = funcType.value();
+
+				if ((AllowedFunctionTypes[static_cast<std::size_t>(opData->ValType)] & FunctionTypeBit(opData->FuncType)) == 0) {
+					logger::warn("Line {}, Col {}: Invalid function type for {} '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(),
+						ValueTypeToString(opData->ValType), FunctionTypeToString(opData->FuncType));
+					return false;
+				}
 
 				token = reader.GetToken();
 				if (token != ",") {
@@ -514,12 +501,12 @@ namespace ObjectModifications {
 					return false;
 				}
 
-				auto prop = ParseProperty();
-				if (!prop.has_value()) {
+				auto propIndex = ParseProperty();
+				if (!propIndex.has_value()) {
 					return false;
 				}
 
-				opData->Property = prop.value();
+				opData->PropertyIndex = propIndex.value();
 
 				token = reader.GetToken();
 				if (token != ",") {
@@ -527,23 +514,16 @@ namespace ObjectModifications {
 					return false;
 				}
 
-				if (opData->ValueType == "Int" || opData->ValueType == "Float") {
-					if (opData->FunctionType != "SET" &&
-						opData->FunctionType != "ADD" &&
-						opData->FunctionType != "MULADD") {
-						logger::warn("Line {}, Col {}: Invalid function type for {} '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), opData->ValueType, opData->FunctionType);
-						return false;
-					}
-					
+				if (opData->ValType == ValueType::kInt || opData->ValType == ValueType::kFloat) {
 					auto value1 = ParseNumber();
 					if (!value1.has_value()) {
 						return false;
 					}
 
-					if (opData->ValueType == "Int") {
-						opData->Value1 = std::any(static_cast<std::uint32_t>(value1.value()));
+					if (opData->ValType == ValueType::kInt) {
+						opData->Value1 = static_cast<std::uint32_t>(value1.value());
 					} else {
-						opData->Value1 = std::any(value1.value());
+						opData->Value1 = value1.value();
 					}
 
 					token = reader.GetToken();
@@ -557,26 +537,19 @@ namespace ObjectModifications {
 						return false;
 					}
 
-					if (opData->ValueType == "Int") {
-						opData->Value2 = std::any(static_cast<std::uint32_t>(value2.value()));
+					if (opData->ValType == ValueType::kInt) {
+						opData->Value2 = static_cast<std::uint32_t>(value2.value());
 					} else {
-						opData->Value2 = std::any(value2.value());
+						opData->Value2 = value2.value();
 					}
 				}
-				else if (opData->ValueType == "Bool") {
-					if (opData->FunctionType != "SET" &&
-						opData->FunctionType != "AND" &&
-						opData->FunctionType != "OR") {
-						logger::warn("Line {}, Col {}: Invalid function type for {} '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), opData->ValueType, opData->FunctionType);
-						return false;
-					}
-
+				else if (opData->ValType == ValueType::kBool) {
 					auto value1 = ParseBool();
 					if (!value1.has_value()) {
 						return false;
 					}
 
-					opData->Value1 = std::any(value1.value());
+					opData->Value1 = value1.value();
 
 					token = reader.GetToken();
 					if (token != ",") {
@@ -589,37 +562,25 @@ namespace ObjectModifications {
 						return false;
 					}
 
-					opData->Value2 = std::any(value2.value());
+					opData->Value2 = value2.value();
 				}
-				else if (opData->ValueType == "Enum") {
-					if (opData->FunctionType != "SET") {
-						logger::warn("Line {}, Col {}: Invalid function type for {} '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), opData->ValueType, opData->FunctionType);
-						return false;
-					}
-
+				else if (opData->ValType == ValueType::kEnum) {
 					auto value1 = ParseNumber();
 					if (!value1.has_value()) {
 						return false;
 					}
 
-					opData->Value1 = std::any(static_cast<std::uint32_t>(value1.value()));
+					opData->Value1 = static_cast<std::uint32_t>(value1.value());
 				}
-				else if (opData->ValueType == "FormIDInt" || opData->ValueType == "FormIDFloat") {
-					if (opData->FunctionType != "SET" &&
-						opData->FunctionType != "REM" &&
-						opData->FunctionType != "ADD") {
-						logger::warn("Line {}, Col {}: Invalid function type for {} '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), opData->ValueType, opData->FunctionType);
-						return false;
-					}
-
+				else if (opData->ValType == ValueType::kFormIDInt || opData->ValType == ValueType::kFormIDFloat) {
 					auto value1 = ParseForm();
 					if (!value1.has_value()) {
 						return false;
 					}
 
-					opData->Value1 = std::any(value1.value());
+					opData->Value1 = value1.value();
 
-					if (opData->ValueType == "FormIDFloat") {
+					if (opData->ValType == ValueType::kFormIDFloat) {
 						token = reader.GetToken();
 						if (token != ",") {
 							logger::warn("Line {}, Col {}: Syntax error. Expected ','.", reader.GetLastLine(), reader.GetLastLineIndex());
@@ -631,7 +592,7 @@ namespace ObjectModifications {
 							return false;
 						}
 
-						opData->Value2 = std::any(value2.value());
+						opData->Value2 = value2.value();
 					}
 				}
 			}
@@ -647,42 +608,41 @@ namespace ObjectModifications {
 			return true;
 		}
 
-		std::optional<std::string> ParseValueType() {
+		std::optional<ValueType> ParseValueType() {
 			auto token = reader.GetToken();
-			if (token == "Int" ||
-				token == "Float" || 
-				token == "Bool" ||
-				token == "FormIDInt" ||
-				token == "Enum" ||
-				token == "FormIDFloat") {
-				return std::string(token);
-			}
-			else {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kInt: return ValueType::kInt;
+			case Symbol::kFloat: return ValueType::kFloat;
+			case Symbol::kBool: return ValueType::kBool;
+			case Symbol::kFormIDInt: return ValueType::kFormIDInt;
+			case Symbol::kEnum: return ValueType::kEnum;
+			case Symbol::kFormIDFloat: return ValueType::kFormIDFloat;
+			default:
 				logger::warn("Line {}, Col {}: Invalid value type '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return std::nullopt;
 			}
 		}
 
-		std::optional<std::string> ParseFunctionType() {
+		std::optional<FunctionType> ParseFunctionType() {
 			auto token = reader.GetToken();
-			if (token == "SET" ||
-				token == "REM" ||
-				token == "AND" ||
-				token == "OR" ||
-				token == "ADD" ||
-				token == "MULADD") {
-				return std::string(token);
-			}
-			else {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kSET: return FunctionType::kSet;
+			case Symbol::kREM: return FunctionType::kRem;
+			case Symbol::kAND: return FunctionType::kAnd;
+			case Symbol::kOR: return FunctionType::kOr;
+			case Symbol::kADD: return FunctionType::kAdd;
+			case Symbol::kMULADD: return FunctionType::kMulAdd;
+			default:
 				logger::warn("Line {}, Col {}: Invalid function type '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return std::nullopt;
 			}
 		}
 
-		std::optional<std::string> ParseProperty() {
+		std::optional<std::uint32_t> ParseProperty() {
 			auto token = reader.GetToken();
-			if (g_propertySet.contains(token)) {
-				return std::string(token);
+			std::size_t propIndex = g_propertyTable.Find(token);
+			if (propIndex != PerfectHash::npos) {
+				return static_cast<std::uint32_t>(propIndex);
 			}
 			else {
 				logger::warn("Line {}, Col {}: Invalid property name '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
@@ -692,13 +652,14 @@ namespace ObjectModifications {
 
 		std::optional<bool> ParseBool() {
 			auto token = reader.GetToken();
-			if (token == "true") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kTrue:
 				return true;
-			}
-			else if (token == "false") {
+
+			case Symbol::kFalse:
 				return false;
-			}
-			else {
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid bool value '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return std::nullopt;
 			}
@@ -706,12 +667,16 @@ namespace ObjectModifications {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<ObjectModificationParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<ObjectModificationParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+	}
+
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::BGSMod::Attachment::Mod*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -723,7 +688,7 @@ namespace ObjectModifications {
 				return;
 			}
 
-			PatchData& patchData = g_patchMap[oMod];
+			PatchData& patchData = a_patchMap[oMod];
 
 			if (a_configData.Element == ElementType::kProperties) {
 				if (!patchData.Properties.has_value()) {
@@ -738,38 +703,34 @@ namespace ObjectModifications {
 						patchData.Properties->AddProperties.push_back({});
 						auto& prop = reinterpret_cast<RE::BGSMod::Property::Mod&>(patchData.Properties->AddProperties.back());
 
-						std::uint32_t target = 0;
+						const Property& property = Properties[op.OpData->PropertyIndex];
+
+						std::uint32_t target = NoTarget;
 						if (oMod->targetFormType.get() == RE::ENUM_FORM_ID::kWEAP)
 						{
-							auto it = g_weaponPropertyMap.find(op.OpData->Property);
-							if (it == g_weaponPropertyMap.end()) {
-								logger::warn("Invalid weapon property: '{}'.", op.OpData->Property);
+							target = property.WeaponTarget;
+							if (target == NoTarget) {
+								logger::warn("Invalid weapon property: '{}'.", property.Name);
 								patchData.Properties->AddProperties.pop_back();
 								continue;
 							}
-
-							target = it->second;
 						}
 						else if(oMod->targetFormType.get() == RE::ENUM_FORM_ID::kARMO)
 						{
-							auto it = g_armorPropertyMap.find(op.OpData->Property);
-							if (it == g_armorPropertyMap.end()) {
-								logger::warn("Invalid armor property: '{}'.", op.OpData->Property);
+							target = property.ArmorTarget;
+							if (target == NoTarget) {
+								logger::warn("Invalid armor property: '{}'.", property.Name);
 								patchData.Properties->AddProperties.pop_back();
 								continue;
 							}
-
-							target = it->second;
 						}
 						else if (oMod->targetFormType.get() == RE::ENUM_FORM_ID::kNPC_) {
-							auto it = g_actorPropertyMap.find(op.OpData->Property);
-							if (it == g_actorPropertyMap.end()) {
-								logger::warn("Invalid actor property: '{}'.", op.OpData->Property);
+							target = property.ActorTarget;
+							if (target == NoTarget) {
+								logger::warn("Invalid actor property: '{}'.", property.Name);
 								patchData.Properties->AddProperties.pop_back();
 								continue;
 							}
-
-							target = it->second;
 						}
 						else {
 							logger::warn("Unknown target form type: '{}'.", static_cast<int>(oMod->targetFormType.get()));
@@ -779,84 +740,84 @@ namespace ObjectModifications {
 
 						prop.target = target;
 
-						if (op.OpData->ValueType == "Int" || op.OpData->ValueType == "Float") {
-							if (op.OpData->ValueType == "Int") {
+						if (op.OpData->ValType == ValueType::kInt || op.OpData->ValType == ValueType::kFloat) {
+							if (op.OpData->ValType == ValueType::kInt) {
 								prop.type = RE::BGSMod::Property::TYPE::kInt;
 							} else {
 								prop.type = RE::BGSMod::Property::TYPE::kFloat;
 							}
 
-							if (op.OpData->FunctionType == "SET") {
+							if (op.OpData->FuncType == FunctionType::kSet) {
 								prop.op = RE::BGSMod::Property::OP::kSet;
-							} else if (op.OpData->FunctionType == "ADD") {
+							} else if (op.OpData->FuncType == FunctionType::kAdd) {
 								prop.op = RE::BGSMod::Property::OP::kAdd;
-							} else {  // op.OpData->FunctionType == "MULADD"
+							} else {  // op.OpData->FuncType == FunctionType::kMulAdd
 								prop.op = RE::BGSMod::Property::OP::kMul;
 							}
 
-							if (op.OpData->ValueType == "Int") {
-								prop.data.mm.min.i = static_cast<std::int32_t>(std::any_cast<std::uint32_t>(op.OpData->Value1));
-								prop.data.mm.max.i = static_cast<std::int32_t>(std::any_cast<std::uint32_t>(op.OpData->Value2));
+							if (op.OpData->ValType == ValueType::kInt) {
+								prop.data.mm.min.i = static_cast<std::int32_t>(std::get<std::uint32_t>(op.OpData->Value1));
+								prop.data.mm.max.i = static_cast<std::int32_t>(std::get<std::uint32_t>(op.OpData->Value2));
 							}
 							else {
-								prop.data.mm.min.f = std::any_cast<float>(op.OpData->Value1);
-								prop.data.mm.max.f = std::any_cast<float>(op.OpData->Value2);
+								prop.data.mm.min.f = std::get<float>(op.OpData->Value1);
+								prop.data.mm.max.f = std::get<float>(op.OpData->Value2);
 							}
 						}
-						else if (op.OpData->ValueType == "Bool") {
+						else if (op.OpData->ValType == ValueType::kBool) {
 							prop.type = RE::BGSMod::Property::TYPE::kBool;
 
-							if (op.OpData->FunctionType == "SET") {
+							if (op.OpData->FuncType == FunctionType::kSet) {
 								prop.op = RE::BGSMod::Property::OP::kSet;
-							} else if (op.OpData->FunctionType == "AND") {
+							} else if (op.OpData->FuncType == FunctionType::kAnd) {
 								prop.op = RE::BGSMod::Property::OP::kAnd;
-							} else { // op.OpData->FunctionType == "OR"
+							} else { // op.OpData->FuncType == FunctionType::kOr
 								prop.op = RE::BGSMod::Property::OP::kOr;
 							}
 
-							prop.data.mm.min.i = static_cast<std::int32_t>(std::any_cast<bool>(op.OpData->Value1));
-							prop.data.mm.max.i = static_cast<std::int32_t>(std::any_cast<bool>(op.OpData->Value2));
+							prop.data.mm.min.i = static_cast<std::int32_t>(std::get<bool>(op.OpData->Value1));
+							prop.data.mm.max.i = static_cast<std::int32_t>(std::get<bool>(op.OpData->Value2));
 						}
-						else if (op.OpData->ValueType == "Enum") {
+						else if (op.OpData->ValType == ValueType::kEnum) {
 							prop.type = RE::BGSMod::Property::TYPE::kEnum;
 
 							prop.op = RE::BGSMod::Property::OP::kSet;
 
-							prop.data.mm.min.i = static_cast<std::int32_t>(std::any_cast<std::uint32_t>(op.OpData->Value1));
+							prop.data.mm.min.i = static_cast<std::int32_t>(std::get<std::uint32_t>(op.OpData->Value1));
 						}
-						else if (op.OpData->ValueType == "FormIDInt" || op.OpData->ValueType == "FormIDFloat") {
-							std::string formSV = std::any_cast<std::string>(op.OpData->Value1);
+						else if (op.OpData->ValType == ValueType::kFormIDInt || op.OpData->ValType == ValueType::kFormIDFloat) {
+							const Utils::FormReference& formRef = std::get<Utils::FormReference>(op.OpData->Value1);
 
-							RE::TESForm* targetForm = Utils::GetFormFromString(formSV);
+							RE::TESForm* targetForm = formRef.Form;
 							if (!targetForm) {
-								logger::warn("Invalid FormID: '{}'.", formSV);
+								logger::warn("Invalid FormID: '{}'.", formRef);
 								patchData.Properties->AddProperties.pop_back();
 								continue;
 							}
 
-							if (op.OpData->ValueType == "FormIDInt") {
+							if (op.OpData->ValType == ValueType::kFormIDInt) {
 								prop.type = RE::BGSMod::Property::TYPE::kForm;
 							}
 							else {
 								prop.type = RE::BGSMod::Property::TYPE::kPair;
 							}
 
-							if (op.OpData->FunctionType == "SET") {
+							if (op.OpData->FuncType == FunctionType::kSet) {
 								prop.op = RE::BGSMod::Property::OP::kSet;
 							}
-							else if (op.OpData->FunctionType == "REM") {
+							else if (op.OpData->FuncType == FunctionType::kRem) {
 								prop.op = RE::BGSMod::Property::OP::kRem;
 							}
 							else {
 								prop.op = RE::BGSMod::Property::OP::kAdd;
 							}
 
-							if (op.OpData->ValueType == "FormIDInt") {
+							if (op.OpData->ValType == ValueType::kFormIDInt) {
 								prop.data.form = targetForm;
 							}
 							else {
 								prop.data.fv.formID = targetForm->formID;
-								prop.data.fv.value = std::any_cast<float>(op.OpData->Value2);
+								prop.data.fv.value = std::get<float>(op.OpData->Value2);
 							}
 						}
 					}
@@ -947,7 +908,7 @@ namespace ObjectModifications {
 	{
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
@@ -962,6 +923,7 @@ namespace ObjectModifications {
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
 	}
 }
@@ -1,7 +1,5 @@
 #include "Outfits.h"
 
-#include <regex>
-
 #include "ConfigUtils.h"
 #include "Parsers.h"
 #include "Utils.h"
@@ -49,31 +47,49 @@ namespace Outfits {
 	struct ConfigData {
 		struct Operation {
 			OperationType OpType;
-			std::optional<std::string> OpForm;
+			std::optional<Utils::FormReference> OpForm;
 		};
 
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
-		std::vector<Operation> Operations;
+		Arenas::Vector<Operation> Operations;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation& a_operation) {
+		a_ar(a_operation.OpType, a_operation.OpForm);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.Operations);
+	}
+
 	struct PatchData {
 		struct ItemsData {
 			bool Clear = false;
 			std::vector<RE::TESForm*> AddFormVec;
 			std::vector<RE::TESForm*> DeleteFormVec;
+
+			bool operator==(const ItemsData&) const = default;
 		};
 
 		std::optional<ItemsData> Items;
+
+		bool operator==(const PatchData&) const = default;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::BGSOutfit*, PatchData> g_patchMap;
+	std::unordered_map<RE::BGSOutfit*, PatchData> g_appliedPatchMap;
+	std::unordered_map<RE::BGSOutfit*, PatchData> g_originalDataMap;
 
 	class OutfitParser : public Parsers::Parser<ConfigData> {
 	public:
 		OutfitParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		OutfitParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -125,7 +141,7 @@ namespace Outfits {
 				}
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -136,7 +152,7 @@ namespace Outfits {
 				logger::info("{}{}({}).{}", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm, ElementTypeToString(a_configData.Element));
 				for (std::size_t ii = 0; ii < a_configData.Operations.size(); ii++) {
 					std::string opLog = fmt::format(".{}({})", OperationTypeToString(a_configData.Operations[ii].OpType),
-						a_configData.Operations[ii].OpForm.has_value() ? a_configData.Operations[ii].OpForm.value() : "");
+						a_configData.Operations[ii].OpForm.has_value() ? a_configData.Operations[ii].OpForm->Text : "");
 
 					if (ii == a_configData.Operations.size() - 1) {
 						opLog += ";";
@@ -150,7 +166,7 @@ namespace Outfits {
 
 		bool ParseFilter(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_configData.Filter = FilterType::kFormID;
 			}
 			else {
@@ -182,7 +198,7 @@ namespace Outfits {
 
 		bool ParseElement(ConfigData& a_configData) {
 			auto token = reader.GetToken();
-			if (token == "Items") {
+			if (reader.GetLastSymbol() == Symbol::kItems) {
 				a_configData.Element = ElementType::kItems;
 			}
 			else {
@@ -197,16 +213,20 @@ namespace Outfits {
 			OperationType opType;
 
 			auto token = reader.GetToken();
-			if (token == "Clear") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kClear:
 				opType = OperationType::kClear;
-			}
-			else if (token == "Add") {
+				break;
+
+			case Symbol::kAdd:
 				opType = OperationType::kAdd;
-			}
-			else if (token == "Delete") {
+				break;
+
+			case Symbol::kDelete:
 				opType = OperationType::kDelete;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid OperationName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -217,7 +237,7 @@ namespace Outfits {
 				return false;
 			}
 
-			std::optional<std::string> opData;
+			std::optional<Utils::FormReference> opData;
 			if (opType != OperationType::kClear) {
 				opData = ParseForm();
 				if (!opData.has_value()) {
@@ -238,12 +258,16 @@ namespace Outfits {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<OutfitParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<OutfitParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
+	}
+
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::BGSOutfit*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -255,7 +279,7 @@ namespace Outfits {
 				return;
 			}
 
-			PatchData& patchData = g_patchMap[outfit];
+			PatchData& patchData = a_patchMap[outfit];
 
 			if (a_configData.Element == ElementType::kItems) {
 				if (!patchData.Items.has_value()) {
@@ -267,7 +291,7 @@ namespace Outfits {
 						patchData.Items->Clear = true;
 					}
 					else if (op.OpType == OperationType::kAdd || op.OpType == OperationType::kDelete) {
-						RE::TESForm* opForm = Utils::GetFormFromString(op.OpForm.value());
+						RE::TESForm* opForm = op.OpForm->Form;
 						if (!opForm) {
 							logger::warn("Invalid Form: '{}'.", op.OpForm.value());
 							continue;
@@ -321,30 +345,58 @@ namespace Outfits {
 		}
 	}
 
+	// The items are captured as a Clear followed by an Add of every item, so applying the original puts them back in order
+	void Capture(RE::BGSOutfit* a_outfit, const PatchData& a_patchData, PatchData& a_originalData) {
+		if (a_patchData.Items.has_value() && !a_originalData.Items.has_value()) {
+			a_originalData.Items = PatchData::ItemsData{ true, std::vector<RE::TESForm*>(a_outfit->outfitItems.begin(), a_outfit->outfitItems.end()), {} };
+		}
+	}
+
 	void Patch(RE::BGSOutfit* a_outfit, const PatchData& a_patchData) {
 		if (a_patchData.Items.has_value()) {
 			PatchItems(a_outfit, a_patchData.Items.value());
 		}
 	}
 
+	void ApplyPatches() {
+		ConfigUtils::ApplyPatches(g_appliedPatchMap, g_originalDataMap, std::move(g_patchMap), Capture, [](RE::BGSOutfit* a_outfit, const PatchData& a_patchData) {
+			Patch(a_outfit, a_patchData);
+		});
+	}
+
 	void Patch() {
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
 
 		logger::info("======================== Start patching for {} ========================", TypeName);
 
-		for (const auto& patchData : g_patchMap) {
-			Patch(patchData.first, patchData.second);
-		}
+		ApplyPatches();
 
 		logger::info("======================== Finished patching for {} ========================", TypeName);
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
 	}
+
+	void Reload() {
+		logger::info("======================== Start reloading {} ========================", TypeName);
+
+		ReadConfigs();
+		ConfigUtils::ResolveForms(g_configVec);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
+		ApplyPatches();
+
+		g_configVec.clear();
+		g_arena.Release();
+		g_patchMap.clear();
+
+		logger::info("======================== Finished reloading {} ========================", TypeName);
+		logger::info("");
+	}
 }
@@ -4,6 +4,11 @@
 #include "F4SE/F4SE.h"
 #include "RE/Fallout.h"
 
+#include <mmio/mmio.hpp>
+
+#include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/sinks/sink.h>
+
 #ifdef NDEBUG
 #	include <spdlog/sinks/basic_file_sink.h>
 #else
@@ -1,110 +1,230 @@
 #include "Parsers.h"
 
+#include <shared_mutex>
+
 #include "Utils.h"
 
 namespace Parsers {
-	bool EvaluateCondition(const Condition& a_condition) {
-		if (a_condition.Name == PluginExistsConditionName) {
-			return Utils::IsPluginExists(a_condition.Params);
-		}
-		else if (a_condition.Name == FormExistsConditionName) {
-			return Utils::GetFormFromString(a_condition.Params) != nullptr;
-		}
-		return false;
-	}
-
-	bool EvaluateConditions(const std::vector<ConditionToken>& a_conditions) {
-		std::stack<ConditionToken> opStack;
-		std::queue<ConditionToken> outQueue;
+	namespace {
+		struct StringHash {
+			using is_transparent = void;
 
-		for (const auto& conditionToken : a_conditions) {
-			if (conditionToken.Type == ConditionToken::TokenType::kCondition) {
-				outQueue.push(conditionToken);
+			std::size_t operator()(std::string_view a_str) const {
+				return std::hash<std::string_view>{}(a_str);
 			}
-			else if (conditionToken.Type == ConditionToken::TokenType::kParenthesis) {
-				if (conditionToken.Operator == "(") {
-					opStack.push(conditionToken);
+		};
+
+		// Results of IsPluginExists and IsFormExists shared by every record type, keyed by the condition kind and its
+		// argument. Results are kept only once plugins are bound: NPCs can be prepared from their hook while plugins are
+		// still loading, and a form missing then may exist when the other record types are patched.
+		class ConditionCache {
+		public:
+			template <typename EvaluateF>
+			bool Evaluate(ConditionStep::OpCode a_op, std::string_view a_params, EvaluateF a_evaluate) {
+				if (!Utils::ArePluginsBound()) {
+					_misses.fetch_add(1, std::memory_order_relaxed);
+					return a_evaluate(a_params);
 				}
-				else {
-					while (true) {
-						if (opStack.top().Type == ConditionToken::TokenType::kParenthesis && opStack.top().Operator == "(") {
-							break;
-						}
 
-						outQueue.push(opStack.top());
-						opStack.pop();
-					}
+				auto& results = _results[static_cast<std::size_t>(a_op)];
+
+				{
+					std::shared_lock<std::shared_mutex> lock(_lock);
 
-					opStack.pop();
+					auto it = results.find(a_params);
+					if (it != results.end()) {
+						_hits.fetch_add(1, std::memory_order_relaxed);
+						return it->second;
+					}
 				}
+
+				bool result = a_evaluate(a_params);
+				_misses.fetch_add(1, std::memory_order_relaxed);
+
+				// Keys are copied, since the argument points into an arena released after each record type is patched
+				std::unique_lock<std::shared_mutex> lock(_lock);
+				results.emplace(std::string(a_params), result);
+
+				return result;
+			}
+
+			ConditionCacheStats GetStats() const {
+				return ConditionCacheStats{ _hits.load(std::memory_order_relaxed), _misses.load(std::memory_order_relaxed) };
 			}
-			else if (conditionToken.Type == ConditionToken::TokenType::kOperator) {
-				if (opStack.empty()) {
-					opStack.push(conditionToken);
-					continue;
-				}
 
-				if (opStack.top().Type == ConditionToken::TokenType::kCondition || 
-					opStack.top().Type == ConditionToken::TokenType::kParenthesis) {
-					opStack.push(conditionToken);
+		private:
+			using ResultMap = std::unordered_map<std::string, bool, StringHash, std::equal_to<>>;
+
+			std::shared_mutex _lock;
+			std::array<ResultMap, static_cast<std::size_t>(ConditionStep::OpCode::kIsFormExists) + 1> _results;
+			std::atomic<std::uint64_t> _hits = 0;
+			std::atomic<std::uint64_t> _misses = 0;
+		};
+
+		ConditionCache g_conditionCache;
+
+		// Recursive descent over the condition tokens: || binds loosest, then &&, then !
+		class ConditionCompiler {
+		public:
+			ConditionCompiler(const Arenas::Vector<ConditionToken>& a_tokens, Arenas::Vector<ConditionStep>& a_steps) :
+				_tokens(a_tokens), _steps(a_steps) {}
+
+			bool Compile() {
+				CompileOr();
+				return !_failed && _index == _tokens.size();
+			}
+
+		private:
+			bool IsOperator(std::string_view a_operator) const {
+				return _index < _tokens.size() && _tokens[_index].Type == ConditionToken::TokenType::kOperator && _tokens[_index].Operator == a_operator;
+			}
+
+			bool IsParenthesis(std::string_view a_parenthesis) const {
+				return _index < _tokens.size() && _tokens[_index].Type == ConditionToken::TokenType::kParenthesis && _tokens[_index].Operator == a_parenthesis;
+			}
+
+			void Emit(ConditionStep::OpCode a_op, std::string_view a_params = {}, Utils::FormKey a_formKey = {}) {
+				_steps.push_back(ConditionStep{ a_op, 0, a_params, a_formKey });
+			}
+
+			// Every jump of a chain of the same operator lands after its last operand, where the result is already decided
+			void CompileChain(std::string_view a_operator, ConditionStep::OpCode a_jump, void (ConditionCompiler::*a_compileOperand)()) {
+				(this->*a_compileOperand)();
+
+				std::vector<std::size_t> jumps;
+				while (!_failed && IsOperator(a_operator)) {
+					_index++;
+					jumps.push_back(_steps.size());
+					Emit(a_jump);
+					(this->*a_compileOperand)();
 				}
-				else if (opStack.top().Type == ConditionToken::TokenType::kOperator) {
-					if ((conditionToken.Operator == "&&" && opStack.top().Operator == "||") ||
-						(conditionToken.Operator == "!" && opStack.top().Operator == "&&") ||
-						(conditionToken.Operator == "!" && opStack.top().Operator == "||")) {
-						opStack.push(conditionToken);
-					}
-					else {
-						outQueue.push(opStack.top());
-						opStack.pop();
-						opStack.push(conditionToken);
-					}
+
+				for (std::size_t jump : jumps) {
+					_steps[jump].Target = static_cast<std::uint32_t>(_steps.size());
 				}
 			}
-		}
 
-		while (!opStack.empty()) {
-			outQueue.push(opStack.top());
-			opStack.pop();
-		}
+			void CompileOr() {
+				CompileChain("||", ConditionStep::OpCode::kJumpIfTrue, &ConditionCompiler::CompileAnd);
+			}
 
-		std::stack<bool> evalStack;
+			void CompileAnd() {
+				CompileChain("&&", ConditionStep::OpCode::kJumpIfFalse, &ConditionCompiler::CompileUnary);
+			}
 
-		while (!outQueue.empty()) {
-			auto token = outQueue.front();
-			outQueue.pop();
+			void CompileUnary() {
+				if (IsOperator("!")) {
+					_index++;
+					CompileUnary();
+					Emit(ConditionStep::OpCode::kNot);
+					return;
+				}
 
-			if (token.Type == ConditionToken::TokenType::kCondition) {
-				evalStack.push(EvaluateCondition(token.Condition.value()));
+				CompilePrimary();
 			}
-			else if (token.Type == ConditionToken::TokenType::kOperator) {
-				if (token.Operator == "&&" || token.Operator == "||") {
-					auto right = evalStack.top();
-					evalStack.pop();
-					auto left = evalStack.top();
-					evalStack.pop();
-
-					if (token.Operator == "&&") {
-						evalStack.push(left && right);
-					}
-					else if (token.Operator == "||") {
-						evalStack.push(left || right);
+
+			void CompilePrimary() {
+				if (_index >= _tokens.size()) {
+					_failed = true;
+					return;
+				}
+
+				if (IsParenthesis("(")) {
+					_index++;
+					CompileOr();
+
+					if (!IsParenthesis(")")) {
+						_failed = true;
+						return;
 					}
+
+					_index++;
+					return;
+				}
+
+				const auto& token = _tokens[_index];
+				if (token.Type != ConditionToken::TokenType::kCondition || !token.Condition.has_value()) {
+					_failed = true;
+					return;
 				}
-				else if (token.Operator == "!") {
-					auto right = evalStack.top();
-					evalStack.pop();
 
-					evalStack.push(!right);
+				if (token.Condition->Name == PluginExistsConditionName) {
+					Emit(ConditionStep::OpCode::kIsPluginExists, token.Condition->Params);
+				}
+				else if (token.Condition->Name == FormExistsConditionName) {
+					Emit(ConditionStep::OpCode::kIsFormExists, token.Condition->Params, token.Condition->FormKey);
 				}
+				else {
+					_failed = true;
+					return;
+				}
+
+				_index++;
 			}
+
+			const Arenas::Vector<ConditionToken>& _tokens;
+			Arenas::Vector<ConditionStep>& _steps;
+			std::size_t _index = 0;
+			bool _failed = false;
+		};
+	}
+
+	std::optional<Conditions> CompileConditions(Arenas::Vector<ConditionToken>&& a_tokens) {
+		Conditions retConditions;
+		retConditions.Tokens = std::move(a_tokens);
+
+		ConditionCompiler compiler(retConditions.Tokens, retConditions.Steps);
+		if (!compiler.Compile()) {
+			return std::nullopt;
 		}
 
-		if (evalStack.size() != 1) {
-			logger::critical("Failed to evaluate conditional statement's condition.");
-			return false;
+		return retConditions;
+	}
+
+	bool EvaluateConditions(const Conditions& a_conditions) {
+		const auto& steps = a_conditions.Steps;
+
+		bool result = false;
+
+		std::size_t ii = 0;
+		while (ii < steps.size()) {
+			const ConditionStep& step = steps[ii];
+
+			switch (step.Op) {
+			case ConditionStep::OpCode::kIsPluginExists:
+				result = g_conditionCache.Evaluate(step.Op, step.Params, [](std::string_view a_pluginName) {
+					return Utils::IsPluginExists(a_pluginName);
+				});
+				break;
+			case ConditionStep::OpCode::kIsFormExists:
+				result = g_conditionCache.Evaluate(step.Op, step.Params, [&step](std::string_view) {
+					return Utils::GetFormFromKey(step.FormKey) != nullptr;
+				});
+				break;
+			case ConditionStep::OpCode::kNot:
+				result = !result;
+				break;
+			case ConditionStep::OpCode::kJumpIfFalse:
+				if (!result) {
+					ii = step.Target;
+					continue;
+				}
+				break;
+			case ConditionStep::OpCode::kJumpIfTrue:
+				if (result) {
+					ii = step.Target;
+					continue;
+				}
+				break;
+			}
+
+			ii++;
 		}
 
-		return evalStack.top();
+		return result;
+	}
+
+	ConditionCacheStats GetConditionCacheStats() {
+		return g_conditionCache.GetStats();
 	}
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "Arenas.h"
 #include "Configs.h"
+#include "Logs.h"
 #include "Utils.h"
 
 namespace Parsers {
@@ -13,8 +15,9 @@ namespace Parsers {
 		};
 
 		ConditionType Type;
-		std::string Name;
-		std::string Params;
+		std::string_view Name;
+		std::string_view Params;
+		Utils::FormKey FormKey;
 	};
 
 	struct ConditionToken {
@@ -25,11 +28,65 @@ namespace Parsers {
 		};
 
 		TokenType Type;
-		std::optional<Condition> Condition = std::nullopt;
-		std::optional<std::string> Operator = std::nullopt;
+		std::optional<Parsers::Condition> Condition = std::nullopt;
+		std::optional<std::string_view> Operator = std::nullopt;
 	};
 
-	bool EvaluateConditions(const std::vector<ConditionToken>& a_conditions);
+	template <typename Archive>
+	void Serialize(Archive& a_ar, Condition& a_condition) {
+		a_ar(a_condition.Type, a_condition.Name, a_condition.Params, a_condition.FormKey);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConditionToken& a_conditionToken) {
+		a_ar(a_conditionToken.Type, a_conditionToken.Condition, a_conditionToken.Operator);
+	}
+
+	// One step of a compiled condition. Steps run in order on a single result; && and || jump over the operands that can
+	// no longer change it, so those conditions are never tested.
+	struct ConditionStep {
+		enum class OpCode : std::uint8_t {
+			kIsPluginExists,
+			kIsFormExists,
+			kNot,
+			kJumpIfFalse,
+			kJumpIfTrue
+		};
+
+		OpCode Op;
+		std::uint32_t Target = 0;
+		std::string_view Params;
+		Utils::FormKey FormKey;
+	};
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConditionStep& a_conditionStep) {
+		a_ar(a_conditionStep.Op, a_conditionStep.Target, a_conditionStep.Params, a_conditionStep.FormKey);
+	}
+
+	// The condition of an if or else if as written, for printing, and the steps compiled from it
+	struct Conditions {
+		Arenas::Vector<ConditionToken> Tokens;
+		Arenas::Vector<ConditionStep> Steps;
+	};
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, Conditions& a_conditions) {
+		a_ar(a_conditions.Tokens, a_conditions.Steps);
+	}
+
+	// Compiles tokens already checked by Parser::ParseConditions; returns std::nullopt if they do not form an expression
+	std::optional<Conditions> CompileConditions(Arenas::Vector<ConditionToken>&& a_tokens);
+
+	bool EvaluateConditions(const Conditions& a_conditions);
+
+	struct ConditionCacheStats {
+		std::uint64_t Hits = 0;
+		std::uint64_t Misses = 0;
+	};
+
+	// Counts of condition tests answered from the results shared by every record type, and of tests that were run
+	ConditionCacheStats GetConditionCacheStats();
 
 	enum class StatementType {
 		kConditional,
@@ -43,70 +100,114 @@ namespace Parsers {
 	template<typename T>
 	class Statement {
 	public:
-		static Statement<T> CreateConditionalStatement(const ConditionalStatement<T>& a_conditionalStatement) {
+		static Statement<T> CreateConditionalStatement(Parsers::ConditionalStatement<T>&& a_conditionalStatement) {
 			Statement<T> retStatement;
 			retStatement.Type = StatementType::kConditional;
-			retStatement.ConditionalStatement = a_conditionalStatement;
+			retStatement.ConditionalStatement = std::move(a_conditionalStatement);
 			return retStatement;
 		}
 
-		static Statement<T> CreateExpressionStatement(const T& a_expressionStatement) {
+		static Statement<T> CreateExpressionStatement(T&& a_expressionStatement) {
 			Statement<T> retStatement;
 			retStatement.Type = StatementType::kExpression;
-			retStatement.ExpressionStatement = a_expressionStatement;
+			retStatement.ExpressionStatement = std::move(a_expressionStatement);
 			return retStatement;
 		}
 
 		StatementType Type = StatementType::kNone;
-		std::optional<ConditionalStatement<T>> ConditionalStatement = std::nullopt;
+		std::optional<Parsers::ConditionalStatement<T>> ConditionalStatement = std::nullopt;
 		std::optional<T> ExpressionStatement = std::nullopt;
 	};
 
 	template<typename T>
 	class ConditionalStatement {
 	public:
-		std::pair<std::vector<ConditionToken>, std::vector<Statement<T>>> IfStatements;
-		std::vector<std::pair<std::vector<ConditionToken>, std::vector<Statement<T>>>> ElseIfStatements;
-		std::vector<Statement<T>> ElseStatements;
+		std::pair<Conditions, Arenas::Vector<Statement<T>>> IfStatements;
+		Arenas::Vector<std::pair<Conditions, Arenas::Vector<Statement<T>>>> ElseIfStatements;
+		Arenas::Vector<Statement<T>> ElseStatements;
+
+		const Arenas::Vector<Statement<T>>& Evaluates() const {
+			return SelectBranch(*this);
+		}
 
-		const std::vector<Statement<T>>& Evaluates() const {
-			if (EvaluateConditions(IfStatements.first)) {
-				return IfStatements.second;
+		// The taken branch, for passes that fill in the statements before they are prepared
+		Arenas::Vector<Statement<T>>& Evaluates() {
+			return SelectBranch(*this);
+		}
+
+	private:
+		template <typename SelfT>
+		static auto& SelectBranch(SelfT& a_self) {
+			if (EvaluateConditions(a_self.IfStatements.first)) {
+				return a_self.IfStatements.second;
 			}
 			
-			for (const auto& elseIfStatement : ElseIfStatements) {
+			for (auto& elseIfStatement : a_self.ElseIfStatements) {
 				if (EvaluateConditions(elseIfStatement.first)) {
 					return elseIfStatement.second;
 				}
 			}
 
-			return ElseStatements;
+			return a_self.ElseStatements;
 		}
 	};
 
+	template <typename Archive, typename T>
+	void Serialize(Archive& a_ar, Statement<T>& a_statement) {
+		a_ar(a_statement.Type, a_statement.ConditionalStatement, a_statement.ExpressionStatement);
+	}
+
+	template <typename Archive, typename T>
+	void Serialize(Archive& a_ar, ConditionalStatement<T>& a_conditionalStatement) {
+		a_ar(a_conditionalStatement.IfStatements, a_conditionalStatement.ElseIfStatements, a_conditionalStatement.ElseStatements);
+	}
+
 	template<typename T>
 	class Parser {
 	public:
 		Parser(std::string_view a_configPath) : reader(a_configPath) {}
+		Parser(const Configs::ConfigChunk& a_configChunk) : reader(a_configChunk) {}
 
+		// Parsed text points into the file buffer, which is handed to the current arena; parse inside an Arenas::ScopedArena
 		std::vector<Statement<T>> Parse() {
 			std::vector<Statement<T>> retVec;
 
+			if (auto arena = Arenas::ScopedArena::Current()) {
+				arena->Retain(reader.GetBuffer());
+			}
+
 			while (!reader.EndOfFile()) {
 				auto parsedStatement = ParseStatement();
 				if (!parsedStatement.has_value()) {
+					failed = true;
 					break;
 				}
 
-				PrintStatement(parsedStatement.value(), 0);
+				// No text is built at all when statements are not logged
+				if (Logs::GetStatementLog() != Logs::StatementLog::kNone) {
+					Logs::ScopedStatementLog statementLog;
+					PrintStatement(parsedStatement.value(), 0);
+				}
 
-				retVec.push_back(parsedStatement.value());
+				retVec.push_back(std::move(parsedStatement.value()));
 			}
 
 			return retVec;
 		}
 
+		// Whether Parse stopped at a statement it could not parse, leaving the rest of the input unread
+		bool Failed() const {
+			return failed;
+		}
+
+		// Cuts the input into chunks of whole statements that can be parsed by separate parsers
+		std::vector<Configs::ConfigChunk> Split(std::size_t a_chunkSize) const {
+			return reader.Split(a_chunkSize);
+		}
+
 	protected:
+		using Symbol = Symbols::Symbol;
+
 		virtual std::optional<Statement<T>> ParseExpressionStatement() = 0;
 
 		void PrintStatement(const Statement<T>& a_statement, int a_indent) {
@@ -120,10 +221,10 @@ namespace Parsers {
 
 		virtual void PrintExpressionStatement(const T& a_expressionStatement, int a_indent) = 0;
 
-		std::string ConditionsToString(const std::vector<ConditionToken>& a_conditions) {
+		std::string ConditionsToString(const Conditions& a_conditions) {
 			std::string retStr;
 
-			for (const ConditionToken& conditionToken : a_conditions) {
+			for (const ConditionToken& conditionToken : a_conditions.Tokens) {
 				if (conditionToken.Type == ConditionToken::TokenType::kParenthesis) {
 					retStr += conditionToken.Operator.value();
 				}
@@ -132,11 +233,11 @@ namespace Parsers {
 						retStr += conditionToken.Operator.value();
 					}
 					else {
-						retStr += " " + conditionToken.Operator.value() + " ";
+						retStr += fmt::format(" {} ", conditionToken.Operator.value());
 					}
 				}
 				else {
-					retStr += conditionToken.Condition->Name + "(" + conditionToken.Condition->Params + ")";
+					retStr += fmt::format("{}({})", conditionToken.Condition->Name, conditionToken.Condition->Params);
 				}
 			}
 
@@ -154,13 +255,13 @@ namespace Parsers {
 			logger::info("{}{}", indent, logmsg);
 			logger::info("{}{{", indent);
 
-			for (const Statement<T> statement : a_conditionalStatement.IfStatements.second) {
+			for (const Statement<T>& statement : a_conditionalStatement.IfStatements.second) {
 				PrintStatement(statement, a_indent + 1);
 			}
 
 			logger::info("{}}}", indent);
 
-			for (const std::pair<std::vector<ConditionToken>, std::vector<Statement<T>>>& elseIfStatement : a_conditionalStatement.ElseIfStatements) {
+			for (const auto& elseIfStatement : a_conditionalStatement.ElseIfStatements) {
 				logmsg = "else if (";
 				logmsg += ConditionsToString(elseIfStatement.first);
 				logmsg += ")";
@@ -168,7 +269,7 @@ namespace Parsers {
 				logger::info("{}{}", indent, logmsg);
 				logger::info("{}{{", indent);
 
-				for (const Statement<T> statement : elseIfStatement.second) {
+				for (const Statement<T>& statement : elseIfStatement.second) {
 					PrintStatement(statement, a_indent + 1);
 				}
 
@@ -181,7 +282,7 @@ namespace Parsers {
 				logger::info("{}{}", indent, logmsg);
 				logger::info("{}{{", indent);
 
-				for (const Statement<T> statement : a_conditionalStatement.ElseStatements) {
+				for (const Statement<T>& statement : a_conditionalStatement.ElseStatements) {
 					PrintStatement(statement, a_indent + 1);
 				}
 
@@ -190,8 +291,7 @@ namespace Parsers {
 		}
 
 		std::optional<Statement<T>> ParseStatement() {
-			auto token = reader.Peek();
-			if (token == "if") {
+			if (reader.PeekSymbol() == Symbol::kIf) {
 				return ParseConditionalStatement();
 			}
 			return ParseExpressionStatement();
@@ -205,7 +305,7 @@ namespace Parsers {
 			ConditionalStatement<T> conditionalStatement;
 
 			auto token = reader.GetToken();
-			if (token != "if") {
+			if (reader.GetLastSymbol() != Symbol::kIf) {
 				logger::warn("Line {}, Col {}: Syntax error. Expected 'if'.", reader.GetLastLine(), reader.GetLastLineIndex());
 				return std::nullopt;
 			}
@@ -216,8 +316,8 @@ namespace Parsers {
 				return std::nullopt;
 			}
 
-			std::vector<ConditionToken> ifConditions = ParseConditions();
-			if (ifConditions.empty()) {
+			std::optional<Conditions> ifConditions = ParseCompiledConditions();
+			if (!ifConditions.has_value()) {
 				return std::nullopt;
 			}
 
@@ -233,7 +333,7 @@ namespace Parsers {
 				return std::nullopt;
 			}
 
-			std::vector<Statement<T>> ifStatements;
+			Arenas::Vector<Statement<T>> ifStatements;
 
 			while (true) {
 				token = reader.Peek();
@@ -247,14 +347,13 @@ namespace Parsers {
 					return std::nullopt;
 				}
 
-				ifStatements.push_back(parsedStatement.value());
+				ifStatements.push_back(std::move(parsedStatement.value()));
 			}
 
-			conditionalStatement.IfStatements = std::make_pair(ifConditions, ifStatements);
+			conditionalStatement.IfStatements = std::make_pair(std::move(ifConditions.value()), std::move(ifStatements));
 
-			token = reader.Peek();
-			if (token != "else") {
-				return Statement<T>::CreateConditionalStatement(conditionalStatement);
+			if (reader.PeekSymbol() != Symbol::kElse) {
+				return Statement<T>::CreateConditionalStatement(std::move(conditionalStatement));
 			}
 
 			while (true) {
@@ -262,11 +361,10 @@ namespace Parsers {
 
 				bool isElseStatement = true;
 
-				std::vector<ConditionToken> elseIfConditions;
-				std::vector<Statement<T>> elseIfStatements;
+				Conditions elseIfConditions;
+				Arenas::Vector<Statement<T>> elseIfStatements;
 
-				token = reader.Peek();
-				if (token == "if") {
+				if (reader.PeekSymbol() == Symbol::kIf) {
 					isElseStatement = false;
 
 					reader.GetToken();
@@ -277,11 +375,13 @@ namespace Parsers {
 						return std::nullopt;
 					}
 
-					elseIfConditions = ParseConditions();
-					if (elseIfConditions.empty()) {
+					std::optional<Conditions> parsedConditions = ParseCompiledConditions();
+					if (!parsedConditions.has_value()) {
 						return std::nullopt;
 					}
 
+					elseIfConditions = std::move(parsedConditions.value());
+
 					token = reader.GetToken();
 					if (token != ")") {
 						logger::warn("Line {}, Col {}: Syntax error. Expected ')'.", reader.GetLastLine(), reader.GetLastLineIndex());
@@ -307,33 +407,47 @@ namespace Parsers {
 						return std::nullopt;
 					}
 
-					elseIfStatements.push_back(parsedStatement.value());
+					elseIfStatements.push_back(std::move(parsedStatement.value()));
 				}
 
 				if (!isElseStatement) {
-					conditionalStatement.ElseIfStatements.push_back(std::make_pair(elseIfConditions, elseIfStatements));
+					conditionalStatement.ElseIfStatements.emplace_back(std::move(elseIfConditions), std::move(elseIfStatements));
 				}
 				else {
-					conditionalStatement.ElseStatements = elseIfStatements;
+					conditionalStatement.ElseStatements = std::move(elseIfStatements);
 					break;
 				}
 
-				token = reader.Peek();
-				if (token != "else") {
+				if (reader.PeekSymbol() != Symbol::kElse) {
 					break;
 				}
 			}
 
-			return Statement<T>::CreateConditionalStatement(conditionalStatement);
+			return Statement<T>::CreateConditionalStatement(std::move(conditionalStatement));
 		}
 
-		std::vector<ConditionToken> ParseConditions() {
-			std::vector<ConditionToken> retVec;
+		std::optional<Conditions> ParseCompiledConditions() {
+			Arenas::Vector<ConditionToken> conditionTokens = ParseConditions();
+			if (conditionTokens.empty()) {
+				return std::nullopt;
+			}
+
+			auto conditions = CompileConditions(std::move(conditionTokens));
+			if (!conditions.has_value()) {
+				logger::warn("Line {}, Col {}: Syntax error. Invalid condition.", reader.GetLastLine(), reader.GetLastLineIndex());
+				return std::nullopt;
+			}
+
+			return conditions;
+		}
+
+		Arenas::Vector<ConditionToken> ParseConditions() {
+			Arenas::Vector<ConditionToken> retVec;
 
 			auto token = reader.Peek();
 			if (token == ")") {
 				logger::warn("Line {}, Col {}: Syntax error. Operand expected.", reader.GetLastLine(), reader.GetLastLineIndex());
-				return std::vector<ConditionToken>{};
+				return {};
 			}
 
 			while (true) {
@@ -344,124 +458,125 @@ namespace Parsers {
 
 				token = reader.GetToken();
 				if (token == "(") {
-					retVec.push_back(ConditionToken{ ConditionToken::TokenType::kParenthesis, std::nullopt, std::string(token) });
+					retVec.push_back(ConditionToken{ ConditionToken::TokenType::kParenthesis, std::nullopt, token });
 
 					auto subConditions = ParseConditions();
 					if (subConditions.empty()) {
-						return std::vector<ConditionToken>{};
+						return {};
 					}
 
-					retVec.insert(retVec.end(), subConditions.begin(), subConditions.end());
+					retVec.insert(retVec.end(), std::make_move_iterator(subConditions.begin()), std::make_move_iterator(subConditions.end()));
 
 					token = reader.GetToken();
 					if (token != ")") {
 						logger::warn("Line {}, Col {}: Syntax error. Expected ')'.", reader.GetLastLine(), reader.GetLastLineIndex());
-						return std::vector<ConditionToken>{};
+						return {};
 					}
 
-					retVec.push_back(ConditionToken{ ConditionToken::TokenType::kParenthesis, std::nullopt, std::string(token) });
+					retVec.push_back(ConditionToken{ ConditionToken::TokenType::kParenthesis, std::nullopt, token });
 				}
 				else {
-					if (token == PluginExistsConditionName || token == FormExistsConditionName) {
+					Symbol conditionSymbol = reader.GetLastSymbol();
+					if (conditionSymbol == Symbol::kIsPluginExists || conditionSymbol == Symbol::kIsFormExists) {
 						if (!retVec.empty() && retVec.back().Type != ConditionToken::TokenType::kOperator) {
 							logger::warn("Line {}, Col {}: Syntax error. Operator expected.", reader.GetLastLine(), reader.GetLastLineIndex());
-							return std::vector<ConditionToken>{};
+							return {};
 						}
 
-						std::string conditionName = std::string(token);
+						std::string_view conditionName = token;
 
 						token = reader.GetToken();
 						if (token != "(") {
 							logger::warn("Line {}, Col {}: Syntax error. Expected '('.", reader.GetLastLine(), reader.GetLastLineIndex());
-							return std::vector<ConditionToken>{};
+							return {};
 						}
 
-						if (conditionName == PluginExistsConditionName) {
+						if (conditionSymbol == Symbol::kIsPluginExists) {
 							token = reader.GetToken();
 							if (token.empty() || token == ")") {
 								logger::warn("Line {}, Col {}: Syntax error. Plugin name expected.", reader.GetLastLine(), reader.GetLastLineIndex());
-								return std::vector<ConditionToken>{};
+								return {};
 							}
 
 							if (!token.starts_with('\"')) {
 								logger::warn("Line {}, Col {}: PluginName must be a string.", reader.GetLastLine(), reader.GetLastLineIndex());
-								return std::vector<ConditionToken>{};
+								return {};
 							}
 							else if (!token.ends_with('\"')) {
 								logger::warn("Line {}, Col {}: String must end with '\"'.", reader.GetLastLine(), reader.GetLastLineIndex());
-								return std::vector<ConditionToken>{};
+								return {};
 							}
 
-							std::string pluginName(token.substr(1, token.length() - 2));
-							retVec.push_back(ConditionToken{ ConditionToken::TokenType::kCondition, Condition{ Condition::ConditionType::kFunction, conditionName, pluginName }, std::nullopt });
+							std::string_view pluginName = token.substr(1, token.length() - 2);
+							retVec.push_back(ConditionToken{ ConditionToken::TokenType::kCondition, Condition{ Condition::ConditionType::kFunction, conditionName, pluginName, {} }, std::nullopt });
 						}
-						else if (conditionName == FormExistsConditionName) {
+						else if (conditionSymbol == Symbol::kIsFormExists) {
 							auto parsedForm = ParseForm();
 							if (!parsedForm.has_value()) {
-								return std::vector<ConditionToken>{};
+								return {};
 							}
 
-							retVec.push_back(ConditionToken{ ConditionToken::TokenType::kCondition, Condition{ Condition::ConditionType::kFunction, conditionName, parsedForm.value() }, std::nullopt });
+							retVec.push_back(ConditionToken{ ConditionToken::TokenType::kCondition, Condition{ Condition::ConditionType::kFunction, conditionName, parsedForm->Text, parsedForm->Key.value() }, std::nullopt });
 						}
 
 						token = reader.GetToken();
 						if (token != ")") {
 							logger::warn("Line {}, Col {}: Syntax error. Expected ')'.", reader.GetLastLine(), reader.GetLastLineIndex());
-							return std::vector<ConditionToken>{};
+							return {};
 						}
 					}
 					else if (token == "&" || token == "|") {
-						std::string _operator(token);
+						std::string_view _operator = token;
 
 						if (token == "&") {
 							token = reader.GetToken();
 							if (token != "&") {
 								logger::warn("Line {}, Col {}: Syntax error. Expected '&&'.", reader.GetLastLine(), reader.GetLastLineIndex());
-								return std::vector<ConditionToken>{};
+								return {};
 							}
-							_operator = "&&";
+							_operator = "&&"sv;
 						}
 						else if (token == "|") {
 							token = reader.GetToken();
 							if (token != "|") {
 								logger::warn("Line {}, Col {}: Syntax error. Expected '||'.", reader.GetLastLine(), reader.GetLastLineIndex());
-								return std::vector<ConditionToken>{};
+								return {};
 							}
-							_operator = "||";
+							_operator = "||"sv;
 						}
 
 						if (retVec.empty() || retVec.back().Type == ConditionToken::TokenType::kOperator) {
 							logger::warn("Line {}, Col {}: Syntax error. Operand expected.", reader.GetLastLine(), reader.GetLastLineIndex());
-							return std::vector<ConditionToken>{};
+							return {};
 						}
 
 						retVec.push_back(ConditionToken{ ConditionToken::TokenType::kOperator, std::nullopt, _operator });
 					}
 					else if (token == "!") {
-						std::string _operator(token);
+						std::string_view _operator = token;
 
 						if (!retVec.empty() && retVec.back().Type == ConditionToken::TokenType::kOperator && retVec.back().Operator == "!") {
 							logger::warn("Line {}, Col {}: Syntax error. Operand expected.", reader.GetLastLine(), reader.GetLastLineIndex());
-							return std::vector<ConditionToken>{};
+							return {};
 						}
 						else if ((!retVec.empty() && retVec.back().Type == ConditionToken::TokenType::kParenthesis && retVec.back().Operator == ")")
 							|| (!retVec.empty() && retVec.back().Type == ConditionToken::TokenType::kCondition)) {
 							logger::warn("Line {}, Col {}: Syntax error. Operator or ')' expected.", reader.GetLastLine(), reader.GetLastLineIndex());
-							return std::vector<ConditionToken>{};
+							return {};
 						}
 
 						retVec.push_back(ConditionToken{ ConditionToken::TokenType::kOperator, std::nullopt, _operator });
 					}
 					else {
 						logger::warn("Line {}, Col {}: Syntax error. Unknown keyword '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
-						return std::vector<ConditionToken>{};
+						return {};
 					}
 				}
 			}
 
 			if (retVec.empty() || retVec.back().Type == ConditionToken::TokenType::kOperator) {
 				logger::warn("Line {}, Col {}: Syntax error. Operand expected.", reader.GetLastLine(), reader.GetLastLineIndex());
-				return std::vector<ConditionToken>{};
+				return {};
 			}
 
 			return retVec;
@@ -483,9 +598,9 @@ namespace Parsers {
 			});
 		}
 
-		std::optional<std::string> ParseForm() {
-			std::string form;
-
+		// Returns the text "PluginName|FormID" or "PluginName|@EditorID", stored in the current arena since the source text
+		// has quotes between the two, and the FormKey it stands for
+		std::optional<Utils::FormReference> ParseForm() {
 			auto token = reader.GetToken();
 			if (!token.starts_with('\"')) {
 				logger::warn("Line {}, Col {}: PluginName must be a string.", reader.GetLastLine(), reader.GetLastLineIndex());
@@ -495,23 +610,30 @@ namespace Parsers {
 				logger::warn("Line {}, Col {}: String must end with '\"'.", reader.GetLastLine(), reader.GetLastLineIndex());
 				return std::nullopt;
 			}
-			form += token.substr(1, token.length() - 2);
+			std::string_view pluginName = token.substr(1, token.length() - 2);
 
 			token = reader.GetToken();
 			if (token != "|") {
 				logger::warn("Line {}, Col {}: Syntax error. Expected '|'.", reader.GetLastLine(), reader.GetLastLineIndex());
 				return std::nullopt;
 			}
-			form += token;
 
 			token = reader.GetToken();
-			if (!IsHexString(token)) {
+			if (token.starts_with('@')) {
+				if (token.length() == 1) {
+					logger::warn("Line {}, Col {}: Expected EditorID after '@'.", reader.GetLastLine(), reader.GetLastLineIndex());
+					return std::nullopt;
+				}
+			}
+			else if (!IsHexString(token)) {
 				logger::warn("Line {}, Col {}: Expected FormID '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return std::nullopt;
 			}
-			form += token;
 
-			return form;
+			// Interned now, so that the plugin is mapped with the others when game data is ready
+			Utils::FormKey formKey = token.starts_with('@') ? Utils::MakeEditorIDKey(pluginName, token.substr(1)) : Utils::MakeFormKey(pluginName, Utils::ParseHex(token));
+
+			return Utils::FormReference{ Arenas::StoreString({ pluginName, "|"sv, token }), formKey };
 		}
 
 		std::optional<float> ParseNumber() {
@@ -594,5 +716,6 @@ namespace Parsers {
 		}
 
 		Configs::ConfigReader reader;
+		bool failed = false;
 	};
 }
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+
+namespace PerfectHash {
+	inline constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+	// Compile-time perfect hash over the Name of every element of a_entries (hash and displace): the first hash picks
+	// a bucket, whose seed then sends every name of that bucket to its own slot, so a lookup costs two hashes and a
+	// single string comparison
+	template <const auto& a_entries>
+	class Table {
+	public:
+		static constexpr std::size_t EntryCount = a_entries.size();
+		static constexpr std::size_t BucketCount = std::bit_ceil(EntryCount / 4 + 1);
+		static constexpr std::size_t SlotCount = std::bit_ceil(EntryCount * 2);
+		static constexpr std::size_t MaxNameLength = std::max_element(a_entries.begin(), a_entries.end(), [](const auto& a_lhs, const auto& a_rhs) {
+			return a_lhs.Name.length() < a_rhs.Name.length();
+		})->Name.length();
+
+		static_assert(EntryCount < 0xFF, "Slots store entry indices in a single byte");
+
+		static constexpr std::uint32_t Hash(std::string_view a_str, std::uint32_t a_seed) {
+			std::uint32_t hash = 2166136261u ^ (a_seed * 0x9E3779B9u);
+			for (char ch : a_str) {
+				hash ^= static_cast<std::uint8_t>(ch);
+				hash *= 16777619u;
+			}
+
+			hash ^= hash >> 16;
+			hash *= 0x85EBCA6Bu;
+			hash ^= hash >> 13;
+			return hash;
+		}
+
+		constexpr Table() {
+			std::array<std::size_t, BucketCount> bucketSizes{};
+			for (const auto& entry : a_entries) {
+				bucketSizes[Hash(entry.Name, 0) & (BucketCount - 1)]++;
+			}
+
+			// Crowded buckets are placed first, while most slots are still free
+			std::array<std::size_t, BucketCount> bucketOrder{};
+			for (std::size_t ii = 0; ii < BucketCount; ii++) {
+				bucketOrder[ii] = ii;
+			}
+
+			std::sort(bucketOrder.begin(), bucketOrder.end(), [&](std::size_t a_lhs, std::size_t a_rhs) {
+				return bucketSizes[a_lhs] > bucketSizes[a_rhs];
+			});
+
+			for (std::size_t bucket : bucketOrder) {
+				if (bucketSizes[bucket] == 0) {
+					break;
+				}
+
+				std::uint32_t seed = 1;
+				while (!TryPlaceBucket(bucket, seed)) {
+					seed++;
+					if (seed == 0x10000) {
+						throw "Cannot build the perfect hash table";
+					}
+				}
+
+				_seeds[bucket] = seed;
+			}
+		}
+
+		// Returns the index of the entry named a_name, or npos if there is none
+		constexpr std::size_t Find(std::string_view a_name) const {
+			if (a_name.empty() || a_name.length() > MaxNameLength) {
+				return npos;
+			}
+
+			std::uint32_t seed = _seeds[Hash(a_name, 0) & (BucketCount - 1)];
+			std::uint8_t slot = _slots[Hash(a_name, seed) & (SlotCount - 1)];
+			if (slot == 0 || a_entries[slot - 1].Name != a_name) {
+				return npos;
+			}
+
+			return slot - 1;
+		}
+
+	private:
+		constexpr bool TryPlaceBucket(std::size_t a_bucket, std::uint32_t a_seed) {
+			std::array<std::size_t, EntryCount> placedSlots{};
+			std::size_t placedCount = 0;
+
+			for (const auto& entry : a_entries) {
+				if ((Hash(entry.Name, 0) & (BucketCount - 1)) != a_bucket) {
+					continue;
+				}
+
+				std::size_t slot = Hash(entry.Name, a_seed) & (SlotCount - 1);
+				if (_slots[slot] != 0 || std::find(placedSlots.begin(), placedSlots.begin() + placedCount, slot) != placedSlots.begin() + placedCount) {
+					return false;
+				}
+
+				placedSlots[placedCount++] = slot;
+			}
+
+			placedCount = 0;
+			for (std::size_t ii = 0; ii < EntryCount; ii++) {
+				if ((Hash(a_entries[ii].Name, 0) & (BucketCount - 1)) == a_bucket) {
+					_slots[placedSlots[placedCount++]] = static_cast<std::uint8_t>(ii + 1);
+				}
+			}
+
+			return true;
+		}
+
+		std::array<std::uint32_t, BucketCount> _seeds{};
+		std::array<std::uint8_t, SlotCount> _slots{};
+	};
+
+	// True if every entry of a_entries can be found by its own name, which also rules out duplicate names
+	template <const auto& a_entries, const auto& a_table>
+	consteval bool IsTableValid() {
+		for (std::size_t ii = 0; ii < a_entries.size(); ii++) {
+			if (a_table.Find(a_entries[ii].Name) != ii) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
@@ -1,7 +1,6 @@
 #include "Races.h"
 
 #include <unordered_set>
-#include <regex>
 #include <any>
 
 #include "ConfigUtils.h"
@@ -67,7 +66,7 @@ namespace Races {
 	struct ConfigData {
 		struct Operation {
 			struct PropertyData {
-				std::string ActorValueForm;
+				Utils::FormReference ActorValueForm;
 				float Value;
 			};
 
@@ -76,12 +75,30 @@ namespace Races {
 		};
 
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
 		std::optional<std::any> AssignValue;
-		std::vector<Operation> Operations;
+		Arenas::Vector<Operation> Operations;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation::PropertyData& a_propertyData) {
+		a_ar(a_propertyData.ActorValueForm, a_propertyData.Value);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData::Operation& a_operation) {
+		a_ar(a_operation.OpType);
+		a_ar.template Any<Utils::FormReference, ConfigData::Operation::PropertyData>(a_operation.OpData);
+	}
+
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element);
+		a_ar.template Any<std::string_view, std::uint32_t, Utils::FormReference>(a_configData.AssignValue);
+		a_ar(a_configData.Operations);
+	}
+
 	struct PatchData {
 		struct PropertiesData {
 			struct Property {
@@ -110,12 +127,14 @@ namespace Races {
 		std::optional<PresetsData> FemalePresets;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::TESRace*, PatchData> g_patchMap;
 
 	class RaceParser : public Parsers::Parser<ConfigData> {
 	public:
 		RaceParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		RaceParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -181,7 +200,7 @@ namespace Races {
 				}
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -190,7 +209,7 @@ namespace Races {
 			switch (a_configData.Element) {
 			case ElementType::kBodyPartData:
 				logger::info("{}{}({}).{} = {};", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm,
-					ElementTypeToString(a_configData.Element), std::any_cast<std::string>(a_configData.AssignValue.value()));
+					ElementTypeToString(a_configData.Element), std::any_cast<Utils::FormReference>(a_configData.AssignValue.value()));
 				break;
 
 			case ElementType::kBipedObjectSlots:
@@ -244,7 +263,7 @@ namespace Races {
 					case OperationType::kAddIfNotExists:
 					case OperationType::kDelete:
 						opLog = fmt::format(".{}({})", OperationTypeToString(a_configData.Operations[ii].OpType),
-							std::any_cast<std::string>(a_configData.Operations[ii].OpData.value()));
+							std::any_cast<Utils::FormReference>(a_configData.Operations[ii].OpData.value()));
 						break;
 					}
 
@@ -259,14 +278,14 @@ namespace Races {
 			case ElementType::kMaleSkeletalModel:
 			case ElementType::kFemaleSkeletalModel:
 				logger::info("{}{}({}).{} = \"{}\";", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm,
-					ElementTypeToString(a_configData.Element), std::any_cast<std::string>(a_configData.AssignValue.value()));
+					ElementTypeToString(a_configData.Element), std::any_cast<std::string_view>(a_configData.AssignValue.value()));
 				break;
 			}
 		}
 
 		bool ParseFilter(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_config.Filter = FilterType::kFormID;
 			}
 			else {
@@ -298,28 +317,36 @@ namespace Races {
 
 		bool ParseElement(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "MaleSkeletalModel") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kMaleSkeletalModel:
 				a_config.Element = ElementType::kMaleSkeletalModel;
-			}
-			else if (token == "FemaleSkeletalModel") {
+				break;
+
+			case Symbol::kFemaleSkeletalModel:
 				a_config.Element = ElementType::kFemaleSkeletalModel;
-			}
-			else if (token == "BodyPartData") {
+				break;
+
+			case Symbol::kBodyPartData:
 				a_config.Element = ElementType::kBodyPartData;
-			}
-			else if (token == "BipedObjectSlots") {
+				break;
+
+			case Symbol::kBipedObjectSlots:
 				a_config.Element = ElementType::kBipedObjectSlots;
-			}
-			else if (token == "Properties") {
+				break;
+
+			case Symbol::kProperties:
 				a_config.Element = ElementType::kProperties;
-			}
-			else if (token == "MalePresets") {
+				break;
+
+			case Symbol::kMalePresets:
 				a_config.Element = ElementType::kMalePresets;
-			}
-			else if (token == "FemalePresets") {
+				break;
+
+			case Symbol::kFemalePresets:
 				a_config.Element = ElementType::kFemalePresets;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid ElementName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -345,7 +372,7 @@ namespace Races {
 					return false;
 				}
 
-				std::string value = std::string(token.substr(1, token.length() - 2));
+				std::string_view value = token.substr(1, token.length() - 2);
 				a_config.AssignValue = std::any(value);
 			}
 			else if (a_config.Element == ElementType::kBodyPartData) {
@@ -404,22 +431,28 @@ namespace Races {
 			ConfigData::Operation newOp;
 
 			auto token = reader.GetToken();
-			if (token == "Clear") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kClear:
 				newOp.OpType = OperationType::kClear;
-			}
-			else if (token == "Set") {
+				break;
+
+			case Symbol::kSet:
 				newOp.OpType = OperationType::kSet;
-			}
-			else if (token == "Add") {
+				break;
+
+			case Symbol::kAdd:
 				newOp.OpType = OperationType::kAdd;
-			}
-			else if (token == "AddIfNotExists") {
+				break;
+
+			case Symbol::kAddIfNotExists:
 				newOp.OpType = OperationType::kAddIfNotExists;
-			}
-			else if (token == "Delete") {
+				break;
+
+			case Symbol::kDelete:
 				newOp.OpType = OperationType::kDelete;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid OperationName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -459,7 +492,7 @@ namespace Races {
 				ConfigData::Operation::PropertyData newPropData = ConfigData::Operation::PropertyData{};
 
 				if (newOp.OpType != OperationType::kClear) {
-					std::optional<std::string> opForm = ParseForm();
+					std::optional<Utils::FormReference> opForm = ParseForm();
 					if (!opForm.has_value()) {
 						return false;
 					}
@@ -490,7 +523,7 @@ namespace Races {
 			case ElementType::kMalePresets:
 			case ElementType::kFemalePresets:
 				if (newOp.OpType != OperationType::kClear) {
-					std::optional<std::string> opForm = ParseForm();
+					std::optional<Utils::FormReference> opForm = ParseForm();
 					if (!opForm.has_value()) {
 						return false;
 					}
@@ -514,12 +547,16 @@ namespace Races {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<RaceParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<RaceParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+	}
+
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::TESRace*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -532,33 +569,33 @@ namespace Races {
 			}
 
 			if (a_configData.Element == ElementType::kMaleSkeletalModel) {
-				g_patchMap[race].MaleSkeletalModel = std::any_cast<std::string>(a_configData.AssignValue.value());
+				a_patchMap[race].MaleSkeletalModel = std::string(std::any_cast<std::string_view>(a_configData.AssignValue.value()));
 			}
 			else if (a_configData.Element == ElementType::kFemaleSkeletalModel) {
-				g_patchMap[race].FemaleSkeletalModel = std::any_cast<std::string>(a_configData.AssignValue.value());
+				a_patchMap[race].FemaleSkeletalModel = std::string(std::any_cast<std::string_view>(a_configData.AssignValue.value()));
 			}
 			else if (a_configData.Element == ElementType::kBodyPartData) {
-				std::string bodyPartDataFormStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+				const Utils::FormReference& bodyPartDataFormRef = std::any_cast<const Utils::FormReference&>(a_configData.AssignValue.value());
 
-				RE::TESForm* bodyPartDataForm = Utils::GetFormFromString(bodyPartDataFormStr);
+				RE::TESForm* bodyPartDataForm = bodyPartDataFormRef.Form;
 				if (!bodyPartDataForm) {
-					logger::warn("Invalid Form: '{}'.", bodyPartDataFormStr);
+					logger::warn("Invalid Form: '{}'.", bodyPartDataFormRef);
 					return;
 				}
 
 				RE::BGSBodyPartData* bodyPartData = bodyPartDataForm->As<RE::BGSBodyPartData>();
 				if (!bodyPartData) {
-					logger::warn("'{}' is not a BodyPartData.", bodyPartDataFormStr);
+					logger::warn("'{}' is not a BodyPartData.", bodyPartDataFormRef);
 					return;
 				}
 
-				g_patchMap[race].BodyPartData = bodyPartData;
+				a_patchMap[race].BodyPartData = bodyPartData;
 			}
 			else if (a_configData.Element == ElementType::kBipedObjectSlots) {
-				g_patchMap[race].BipedObjectSlots = std::any_cast<std::uint32_t>(a_configData.AssignValue.value());
+				a_patchMap[race].BipedObjectSlots = std::any_cast<std::uint32_t>(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kProperties) {
-				PatchData& patchData = g_patchMap[race];
+				PatchData& patchData = a_patchMap[race];
 
 				if (!patchData.Properties.has_value()) {
 					patchData.Properties = PatchData::PropertiesData{};
@@ -570,7 +607,7 @@ namespace Races {
 					}
 					else if (op.OpType == OperationType::kSet || op.OpType == OperationType::kDelete) {
 						ConfigData::Operation::PropertyData propData = std::any_cast<ConfigData::Operation::PropertyData>(op.OpData.value());
-						RE::TESForm* opForm = Utils::GetFormFromString(propData.ActorValueForm);
+						RE::TESForm* opForm = propData.ActorValueForm.Form;
 						if (!opForm) {
 							logger::warn("Invalid Form: '{}'.", propData.ActorValueForm);
 							continue;
@@ -592,7 +629,7 @@ namespace Races {
 				}
 			}
 			else if (a_configData.Element == ElementType::kMalePresets) {
-				PatchData& patchData = g_patchMap[race];
+				PatchData& patchData = a_patchMap[race];
 
 				if (!patchData.MalePresets.has_value()) {
 					patchData.MalePresets = PatchData::PresetsData{};
@@ -603,17 +640,17 @@ namespace Races {
 						patchData.MalePresets->Clear = true;
 					}
 					else if (op.OpType == OperationType::kAdd || op.OpType == OperationType::kAddIfNotExists || op.OpType == OperationType::kDelete) {
-						std::string opFormStr = std::any_cast<std::string>(op.OpData.value());
+						const Utils::FormReference& opFormRef = std::any_cast<const Utils::FormReference&>(op.OpData.value());
 
-						RE::TESForm* opForm = Utils::GetFormFromString(opFormStr);
+						RE::TESForm* opForm = opFormRef.Form;
 						if (!opForm) {
-							logger::warn("Invalid Form: '{}'.", opFormStr);
+							logger::warn("Invalid Form: '{}'.", opFormRef);
 							continue;
 						}
 
 						RE::TESNPC* presetNPC = opForm->As<RE::TESNPC>();
 						if (!presetNPC) {
-							logger::warn("'{}' is not a NPC.", opFormStr);
+							logger::warn("'{}' is not a NPC.", opFormRef);
 							continue;
 						}
 
@@ -630,7 +667,7 @@ namespace Races {
 				}
 			}
 			else if (a_configData.Element == ElementType::kFemalePresets) {
-				PatchData& patchData = g_patchMap[race];
+				PatchData& patchData = a_patchMap[race];
 
 				if (!patchData.FemalePresets.has_value()) {
 					patchData.FemalePresets = PatchData::PresetsData{};
@@ -641,17 +678,17 @@ namespace Races {
 						patchData.FemalePresets->Clear = true;
 					}
 					else if (op.OpType == OperationType::kAdd || op.OpType == OperationType::kAddIfNotExists || op.OpType == OperationType::kDelete) {
-						std::string opFormStr = std::any_cast<std::string>(op.OpData.value());
+						const Utils::FormReference& opFormRef = std::any_cast<const Utils::FormReference&>(op.OpData.value());
 
-						RE::TESForm* opForm = Utils::GetFormFromString(opFormStr);
+						RE::TESForm* opForm = opFormRef.Form;
 						if (!opForm) {
-							logger::warn("Invalid Form: '{}'.", opFormStr);
+							logger::warn("Invalid Form: '{}'.", opFormRef);
 							continue;
 						}
 
 						RE::TESNPC* presetNPC = opForm->As<RE::TESNPC>();
 						if (!presetNPC) {
-							logger::warn("'{}' is not a NPC.", opFormStr);
+							logger::warn("'{}' is not a NPC.", opFormRef);
 							continue;
 						}
 
@@ -773,7 +810,7 @@ namespace Races {
 	void Patch() {
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
@@ -814,6 +851,7 @@ namespace Races {
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
 	}
 }
@@ -0,0 +1,129 @@
+#include "Reloads.h"
+
+#include <thread>
+
+#include "ConfigUtils.h"
+
+namespace Reloads {
+	namespace {
+		struct FileState {
+			std::filesystem::path Path;
+			std::uintmax_t Size = 0;
+			std::filesystem::file_time_type WriteTime;
+
+			bool operator==(const FileState&) const = default;
+		};
+
+		// Only sizes and write times are compared; contents are hashed by the config cache once a type is reloaded
+		using Snapshot = std::unordered_map<std::string, std::vector<FileState>>;
+
+		Snapshot TakeSnapshot() {
+			Snapshot retSnapshot;
+
+			for (auto& [configType, configPaths] : ConfigUtils::ScanConfigPaths()) {
+				auto& fileStates = retSnapshot[configType];
+
+				for (auto& configPath : configPaths) {
+					std::error_code ec;
+
+					FileState fileState;
+					fileState.Size = std::filesystem::file_size(configPath, ec);
+					fileState.WriteTime = std::filesystem::last_write_time(configPath, ec);
+					fileState.Path = std::move(configPath);
+
+					fileStates.push_back(std::move(fileState));
+				}
+			}
+
+			return retSnapshot;
+		}
+
+		std::vector<std::string> GetChangedTypes(const Snapshot& a_oldSnapshot, const Snapshot& a_newSnapshot) {
+			std::vector<std::string> retVec;
+
+			for (const auto& [configType, fileStates] : a_newSnapshot) {
+				auto it = a_oldSnapshot.find(configType);
+				if (it == a_oldSnapshot.end() || it->second != fileStates) {
+					retVec.push_back(configType);
+				}
+			}
+
+			for (const auto& [configType, fileStates] : a_oldSnapshot) {
+				if (!a_newSnapshot.contains(configType)) {
+					retVec.push_back(configType);
+				}
+			}
+
+			std::sort(retVec.begin(), retVec.end());
+			return retVec;
+		}
+
+		bool EqualsIgnoreCase(std::string_view a_lhs, std::string_view a_rhs) {
+			return std::equal(a_lhs.begin(), a_lhs.end(), a_rhs.begin(), a_rhs.end(), [](unsigned char a_lch, unsigned char a_rch) {
+				return std::tolower(a_lch) == std::tolower(a_rch);
+			});
+		}
+
+		void Reload(const std::vector<Reloadable>& a_reloadables, const std::vector<std::string>& a_changedTypes) {
+			auto reloadStart = std::chrono::high_resolution_clock::now();
+
+			ConfigUtils::RescanConfigPaths();
+
+			for (const auto& changedType : a_changedTypes) {
+				auto it = std::find_if(a_reloadables.begin(), a_reloadables.end(), [&changedType](const Reloadable& a_reloadable) {
+					return EqualsIgnoreCase(a_reloadable.ConfigType, changedType);
+				});
+
+				if (it == a_reloadables.end()) {
+					logger::warn("Configs in '{}' changed. They cannot be reloaded and take effect after restarting the game.", changedType);
+					continue;
+				}
+
+				it->Reload();
+			}
+
+			auto reloadEnd = std::chrono::high_resolution_clock::now();
+			std::chrono::duration<double> reloadDuration = reloadEnd - reloadStart;
+
+			logger::info("Reload execution time: {} seconds", reloadDuration.count());
+			spdlog::default_logger()->flush();
+		}
+	}
+
+	void StartWatching(std::vector<Reloadable> a_reloadables, std::chrono::seconds a_interval) {
+		// kGameDataReady can be sent more than once, but one watcher is enough
+		static std::atomic<bool> started = false;
+		if (started.exchange(true)) {
+			return;
+		}
+
+		logger::info("Watching configs for changes every {} seconds", a_interval.count());
+
+		std::thread([reloadables = std::move(a_reloadables), a_interval]() {
+			Snapshot snapshot = TakeSnapshot();
+
+			while (true) {
+				std::this_thread::sleep_for(a_interval);
+
+				Snapshot newSnapshot = TakeSnapshot();
+				auto changedTypes = GetChangedTypes(snapshot, newSnapshot);
+				snapshot = std::move(newSnapshot);
+
+				if (changedTypes.empty()) {
+					continue;
+				}
+
+				// Forms are only patched on the game's main thread
+				const F4SE::TaskInterface* task = F4SE::GetTaskInterface();
+				if (!task) {
+					logger::error("Cannot reload configs: the F4SE task interface is unavailable.");
+					return;
+				}
+
+				task->AddTask([reloadables, changedTypes = std::move(changedTypes)]() {
+					Reload(reloadables, changedTypes);
+				});
+			}
+		}).detach();
+	}
+}
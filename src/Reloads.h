@@ -0,0 +1,12 @@
+#pragma once
+
+namespace Reloads {
+	struct Reloadable {
+		std::string_view ConfigType;
+		void (*Reload)();
+	};
+
+	// Polls Data\TullPatcherF4 every a_interval on a background thread. Record types whose config files were added, changed
+	// or removed are reloaded on the game's main thread; changes to types that cannot be reloaded are only reported.
+	void StartWatching(std::vector<Reloadable> a_reloadables, std::chrono::seconds a_interval);
+}
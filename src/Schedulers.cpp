@@ -0,0 +1,152 @@
+#include "Schedulers.h"
+
+#include <numeric>
+#include <queue>
+#include <thread>
+
+#include "Logs.h"
+
+namespace Schedulers {
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		struct TaskState {
+			std::vector<std::size_t> Predecessors;
+			std::vector<std::size_t> Successors;
+			std::size_t PendingCount = 0;
+			Logs::Buffer Log;
+			Clock::time_point Start;
+			Clock::time_point End;
+		};
+
+		bool IsCallingThreadOnly(const Task& a_task) {
+			return (a_task.Writes & kGameHeap) != 0;
+		}
+
+		bool IsConflicting(const Task& a_earlier, const Task& a_later) {
+			return (a_earlier.Writes & (a_later.Reads | a_later.Writes)) != 0 || (a_earlier.Reads & a_later.Writes) != 0;
+		}
+
+		// Walks back from the task that finished last through the predecessor each task waited on longest
+		void LogCriticalPath(std::span<const Task> a_tasks, const std::vector<TaskState>& a_states, Clock::time_point a_runStart) {
+			auto byEnd = [&a_states](std::size_t a_lhs, std::size_t a_rhs) {
+				return a_states[a_lhs].End < a_states[a_rhs].End;
+			};
+
+			std::vector<std::size_t> indices(a_states.size());
+			std::iota(indices.begin(), indices.end(), std::size_t{ 0 });
+
+			std::size_t index = *std::max_element(indices.begin(), indices.end(), byEnd);
+			std::vector<std::size_t> criticalPath{ index };
+			while (!a_states[index].Predecessors.empty()) {
+				index = *std::max_element(a_states[index].Predecessors.begin(), a_states[index].Predecessors.end(), byEnd);
+				criticalPath.push_back(index);
+			}
+
+			std::string pathStr;
+			for (auto it = criticalPath.rbegin(); it != criticalPath.rend(); ++it) {
+				std::chrono::duration<double> taskDuration = a_states[*it].End - a_states[*it].Start;
+				pathStr += fmt::format("{}{} ({} seconds)", pathStr.empty() ? "" : " -> ", a_tasks[*it].Name, taskDuration.count());
+			}
+
+			std::chrono::duration<double> runDuration = a_states[criticalPath.front()].End - a_runStart;
+			logger::info("Patch critical path: {}, finished after {} seconds", pathStr, runDuration.count());
+		}
+	}
+
+	void Run(std::span<const Task> a_tasks) {
+		if (a_tasks.empty()) {
+			return;
+		}
+
+		std::vector<TaskState> states(a_tasks.size());
+		for (std::size_t later = 0; later < a_tasks.size(); later++) {
+			for (std::size_t earlier = 0; earlier < later; earlier++) {
+				if (IsConflicting(a_tasks[earlier], a_tasks[later])) {
+					states[earlier].Successors.push_back(later);
+					states[later].Predecessors.push_back(earlier);
+					states[later].PendingCount++;
+				}
+			}
+		}
+
+		std::mutex lock;
+		std::condition_variable readied;
+
+		// Ready tasks of each queue start in task order. Tasks that write kGameHeap wait in their own queue, which only the
+		// calling thread takes from.
+		using ReadyQueue = std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<std::size_t>>;
+		ReadyQueue callingThreadQueue;
+		ReadyQueue anyThreadQueue;
+		std::size_t remainingCount = a_tasks.size();
+
+		auto pushReady = [&](std::size_t a_index) {
+			(IsCallingThreadOnly(a_tasks[a_index]) ? callingThreadQueue : anyThreadQueue).push(a_index);
+		};
+
+		for (std::size_t ii = 0; ii < a_tasks.size(); ii++) {
+			if (states[ii].PendingCount == 0) {
+				pushReady(ii);
+			}
+		}
+
+		auto runStart = Clock::now();
+
+		auto work = [&](bool a_isCallingThread) {
+			std::unique_lock<std::mutex> guard(lock);
+
+			while (true) {
+				readied.wait(guard, [&]() {
+					return !anyThreadQueue.empty() || (a_isCallingThread && !callingThreadQueue.empty()) || remainingCount == 0;
+				});
+				if (remainingCount == 0) {
+					return;
+				}
+
+				// The calling thread takes the tasks only it can run first, leaving the others to the workers
+				ReadyQueue* queue = a_isCallingThread && !callingThreadQueue.empty() ? &callingThreadQueue : &anyThreadQueue;
+
+				std::size_t index = queue->top();
+				queue->pop();
+
+				guard.unlock();
+
+				TaskState& state = states[index];
+				state.Start = Clock::now();
+				{
+					Logs::ScopedCapture capture(state.Log);
+					a_tasks[index].Run();
+				}
+				state.End = Clock::now();
+
+				guard.lock();
+
+				remainingCount--;
+				for (std::size_t successor : state.Successors) {
+					if (--states[successor].PendingCount == 0) {
+						pushReady(successor);
+					}
+				}
+
+				readied.notify_all();
+			}
+		};
+
+		auto anyThreadCount = std::count_if(a_tasks.begin(), a_tasks.end(), [](const Task& a_task) { return !IsCallingThreadOnly(a_task); });
+		std::size_t workerCount = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u) - 1, static_cast<std::size_t>(anyThreadCount));
+		{
+			std::vector<std::jthread> workers;
+			for (std::size_t ii = 0; ii < workerCount; ii++) {
+				workers.emplace_back(work, false);
+			}
+
+			work(true);
+		}
+
+		for (auto& state : states) {
+			Logs::Replay(state.Log);
+		}
+
+		LogCriticalPath(a_tasks, states, runStart);
+	}
+}
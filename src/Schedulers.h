@@ -0,0 +1,43 @@
+#pragma once
+
+#include <span>
+
+namespace Schedulers {
+	// Forms and game state a patch task touches. Record types are named by the forms they patch.
+	enum Resource : std::uint32_t {
+		kArmor = 1 << 0,
+		kArmorAddon = 1 << 1,
+		kCell = 1 << 2,
+		kConstructibleObject = 1 << 3,
+		kDefaultObject = 1 << 4,
+		kFormList = 1 << 5,
+		kIngestible = 1 << 6,
+		kKeyword = 1 << 7,
+		kLeveledList = 1 << 8,
+		kLocation = 1 << 9,
+		kMusicType = 1 << 10,
+		kObjectModification = 1 << 11,
+		kOutfit = 1 << 12,
+		kQuest = 1 << 13,
+		kRace = 1 << 14,
+		kWeapon = 1 << 15,
+		kWorldspace = 1 << 16,
+		// Held by every task that does more than store plain fields of its forms: growing, shrinking or replacing arrays the
+		// game owns, interning strings or calling engine setters. None of those are known to be safe off the thread that
+		// received kGameDataReady, so tasks that write it run there.
+		kGameHeap = 1 << 17
+	};
+
+	struct Task {
+		std::string_view Name;
+		void (*Run)();
+		std::uint32_t Reads = 0;
+		std::uint32_t Writes = 0;
+	};
+
+	// Runs a_tasks on the calling thread, handing tasks that do not write kGameHeap to worker threads while it is busy. A
+	// task waits for every earlier task that writes what it reads or writes, or reads what it writes, so the outcome is the
+	// same as running them in order. No worker is started unless some task can run on one.
+	// Messages logged by each task are written out in task order once all of them are done, followed by the critical path.
+	void Run(std::span<const Task> a_tasks);
+}
@@ -0,0 +1,108 @@
+#include "Settings.h"
+
+#include <fstream>
+
+namespace Settings {
+	namespace {
+		Logs::StatementLog g_statementLog = Logs::StatementLog::kLog;
+		std::chrono::seconds g_reloadPollInterval{ 0 };
+
+		std::string_view Trim(std::string_view a_str) {
+			auto first = a_str.find_first_not_of(" \t\r");
+			if (first == std::string_view::npos) {
+				return std::string_view{};
+			}
+
+			auto last = a_str.find_last_not_of(" \t\r");
+			return a_str.substr(first, last - first + 1);
+		}
+
+		bool EqualsIgnoreCase(std::string_view a_lhs, std::string_view a_rhs) {
+			return std::equal(a_lhs.begin(), a_lhs.end(), a_rhs.begin(), a_rhs.end(), [](unsigned char a_lch, unsigned char a_rch) {
+				return std::tolower(a_lch) == std::tolower(a_rch);
+			});
+		}
+
+		std::optional<Logs::StatementLog> StringToStatementLog(std::string_view a_value) {
+			if (EqualsIgnoreCase(a_value, "Log")) {
+				return Logs::StatementLog::kLog;
+			}
+			else if (EqualsIgnoreCase(a_value, "File")) {
+				return Logs::StatementLog::kFile;
+			}
+			else if (EqualsIgnoreCase(a_value, "None")) {
+				return Logs::StatementLog::kNone;
+			}
+
+			return std::nullopt;
+		}
+	}
+
+	void Load() {
+		const std::filesystem::path settingsPath{ fmt::format("Data\\F4SE\\Plugins\\{}.ini", Version::PROJECT) };
+
+		std::ifstream settingsFile(settingsPath);
+		if (!settingsFile.is_open()) {
+			return;
+		}
+
+		std::string section;
+		std::string line;
+		std::size_t lineNumber = 0;
+
+		while (std::getline(settingsFile, line)) {
+			lineNumber++;
+
+			std::string_view content = line;
+			content = Trim(content.substr(0, content.find_first_of(";#")));
+			if (content.empty()) {
+				continue;
+			}
+
+			if (content.starts_with('[') && content.ends_with(']')) {
+				section = Trim(content.substr(1, content.length() - 2));
+				continue;
+			}
+
+			auto separator = content.find('=');
+			if (separator == std::string_view::npos) {
+				logger::warn("{} line {}: Expected 'Key = Value'.", settingsPath.string(), lineNumber);
+				continue;
+			}
+
+			auto key = Trim(content.substr(0, separator));
+			auto value = Trim(content.substr(separator + 1));
+
+			if (EqualsIgnoreCase(section, "Log") && EqualsIgnoreCase(key, "Statements")) {
+				auto statementLog = StringToStatementLog(value);
+				if (!statementLog.has_value()) {
+					logger::warn("{} line {}: Invalid Statements '{}'. Expected Log, File or None.", settingsPath.string(), lineNumber, value);
+					continue;
+				}
+
+				g_statementLog = statementLog.value();
+			}
+			else if (EqualsIgnoreCase(section, "Reload") && EqualsIgnoreCase(key, "PollInterval")) {
+				std::uint32_t seconds = 0;
+				auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), seconds);
+				if (ec != std::errc() || ptr != value.data() + value.size()) {
+					logger::warn("{} line {}: Invalid PollInterval '{}'. Expected a number of seconds.", settingsPath.string(), lineNumber, value);
+					continue;
+				}
+
+				g_reloadPollInterval = std::chrono::seconds(seconds);
+			}
+			else {
+				logger::warn("{} line {}: Unknown setting '{}' in section '{}'.", settingsPath.string(), lineNumber, key, section);
+			}
+		}
+	}
+
+	Logs::StatementLog GetStatementLog() {
+		return g_statementLog;
+	}
+
+	std::chrono::seconds GetReloadPollInterval() {
+		return g_reloadPollInterval;
+	}
+}
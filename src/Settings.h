@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Logs.h"
+
+namespace Settings {
+	// Reads Data\F4SE\Plugins\TullPatcherF4.ini; settings that are missing keep their defaults
+	void Load();
+
+	Logs::StatementLog GetStatementLog();
+
+	// How often configs are checked for changes to reload; zero turns reloading off
+	std::chrono::seconds GetReloadPollInterval();
+}
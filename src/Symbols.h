@@ -0,0 +1,213 @@
+#pragma once
+
+#include "PerfectHash.h"
+
+namespace Symbols {
+	// Every keyword the config grammars recognize. Tokens that are not keywords (strings, numbers, punctuation) are kUnknown.
+	enum class Symbol : std::uint8_t {
+		kUnknown,
+		kIf,
+		kElse,
+		kNull,
+		kTrue,
+		kFalse,
+		kIsPluginExists,
+		kIsFormExists,
+		kAbruptTransition,
+		kADD,
+		kAdd,
+		kAddIfNotExists,
+		kAmmo,
+		kAND,
+		kArmorRating,
+		kAttackDelay,
+		kBipedObjectSlots,
+		kBodyPartData,
+		kBool,
+		kCategories,
+		kChanceNone,
+		kClass,
+		kClear,
+		kCombatStyle,
+		kComponents,
+		kCreatedObject,
+		kCreatedObjectCount,
+		kCycleTracks,
+		kDefaultOutfit,
+		kDelete,
+		kDeleteAll,
+		kDoesNotQueue,
+		kDucking,
+		kDucksCurrentTrack,
+		kEffects,
+		kEntries,
+		kEnum,
+		kFadeDuration,
+		kFemalePresets,
+		kFemaleSkeletalModel,
+		kFilterByCategoryKeyword,
+		kFilterByFormID,
+		kFlags,
+		kFloat,
+		kFormIDFloat,
+		kFormIDInt,
+		kFullName,
+		kHairColor,
+		kHeadParts,
+		kHeadTexture,
+		kHeightMax,
+		kHeightMin,
+		kInt,
+		kIsChargenFacePreset,
+		kItems,
+		kKeywords,
+		kList,
+		kMaintainTrackOrder,
+		kMalePresets,
+		kMaleSkeletalModel,
+		kMaxCount,
+		kMaxRange,
+		kMinRange,
+		kMorphs,
+		kMULADD,
+		kMusicTracks,
+		kNone,
+		kNPCAddAmmoList,
+		kObjectEffect,
+		kObjects,
+		kOR,
+		kPlaysOneSelection,
+		kPriority,
+		kProperties,
+		kRace,
+		kReach,
+		kReloadSpeed,
+		kREM,
+		kResistances,
+		kSET,
+		kSet,
+		kSex,
+		kSkin,
+		kSpeed,
+		kTints,
+		kWeightFat,
+		kWeightMuscular,
+		kWeightThin,
+		kWorkbenchKeyword,
+	};
+
+	struct Keyword {
+		std::string_view Name;
+		Symbols::Symbol Symbol;
+	};
+
+	inline constexpr std::array Keywords{
+		Keyword{ "if"sv, Symbol::kIf },
+		Keyword{ "else"sv, Symbol::kElse },
+		Keyword{ "null"sv, Symbol::kNull },
+		Keyword{ "true"sv, Symbol::kTrue },
+		Keyword{ "false"sv, Symbol::kFalse },
+		Keyword{ "IsPluginExists"sv, Symbol::kIsPluginExists },
+		Keyword{ "IsFormExists"sv, Symbol::kIsFormExists },
+		Keyword{ "AbruptTransition"sv, Symbol::kAbruptTransition },
+		Keyword{ "ADD"sv, Symbol::kADD },
+		Keyword{ "Add"sv, Symbol::kAdd },
+		Keyword{ "AddIfNotExists"sv, Symbol::kAddIfNotExists },
+		Keyword{ "Ammo"sv, Symbol::kAmmo },
+		Keyword{ "AND"sv, Symbol::kAND },
+		Keyword{ "ArmorRating"sv, Symbol::kArmorRating },
+		Keyword{ "AttackDelay"sv, Symbol::kAttackDelay },
+		Keyword{ "BipedObjectSlots"sv, Symbol::kBipedObjectSlots },
+		Keyword{ "BodyPartData"sv, Symbol::kBodyPartData },
+		Keyword{ "Bool"sv, Symbol::kBool },
+		Keyword{ "Categories"sv, Symbol::kCategories },
+		Keyword{ "ChanceNone"sv, Symbol::kChanceNone },
+		Keyword{ "Class"sv, Symbol::kClass },
+		Keyword{ "Clear"sv, Symbol::kClear },
+		Keyword{ "CombatStyle"sv, Symbol::kCombatStyle },
+		Keyword{ "Components"sv, Symbol::kComponents },
+		Keyword{ "CreatedObject"sv, Symbol::kCreatedObject },
+		Keyword{ "CreatedObjectCount"sv, Symbol::kCreatedObjectCount },
+		Keyword{ "CycleTracks"sv, Symbol::kCycleTracks },
+		Keyword{ "DefaultOutfit"sv, Symbol::kDefaultOutfit },
+		Keyword{ "Delete"sv, Symbol::kDelete },
+		Keyword{ "DeleteAll"sv, Symbol::kDeleteAll },
+		Keyword{ "DoesNotQueue"sv, Symbol::kDoesNotQueue },
+		Keyword{ "Ducking"sv, Symbol::kDucking },
+		Keyword{ "DucksCurrentTrack"sv, Symbol::kDucksCurrentTrack },
+		Keyword{ "Effects"sv, Symbol::kEffects },
+		Keyword{ "Entries"sv, Symbol::kEntries },
+		Keyword{ "Enum"sv, Symbol::kEnum },
+		Keyword{ "FadeDuration"sv, Symbol::kFadeDuration },
+		Keyword{ "FemalePresets"sv, Symbol::kFemalePresets },
+		Keyword{ "FemaleSkeletalModel"sv, Symbol::kFemaleSkeletalModel },
+		Keyword{ "FilterByCategoryKeyword"sv, Symbol::kFilterByCategoryKeyword },
+		Keyword{ "FilterByFormID"sv, Symbol::kFilterByFormID },
+		Keyword{ "Flags"sv, Symbol::kFlags },
+		Keyword{ "Float"sv, Symbol::kFloat },
+		Keyword{ "FormIDFloat"sv, Symbol::kFormIDFloat },
+		Keyword{ "FormIDInt"sv, Symbol::kFormIDInt },
+		Keyword{ "FullName"sv, Symbol::kFullName },
+		Keyword{ "HairColor"sv, Symbol::kHairColor },
+		Keyword{ "HeadParts"sv, Symbol::kHeadParts },
+		Keyword{ "HeadTexture"sv, Symbol::kHeadTexture },
+		Keyword{ "HeightMax"sv, Symbol::kHeightMax },
+		Keyword{ "HeightMin"sv, Symbol::kHeightMin },
+		Keyword{ "Int"sv, Symbol::kInt },
+		Keyword{ "IsChargenFacePreset"sv, Symbol::kIsChargenFacePreset },
+		Keyword{ "Items"sv, Symbol::kItems },
+		Keyword{ "Keywords"sv, Symbol::kKeywords },
+		Keyword{ "List"sv, Symbol::kList },
+		Keyword{ "MaintainTrackOrder"sv, Symbol::kMaintainTrackOrder },
+		Keyword{ "MalePresets"sv, Symbol::kMalePresets },
+		Keyword{ "MaleSkeletalModel"sv, Symbol::kMaleSkeletalModel },
+		Keyword{ "MaxCount"sv, Symbol::kMaxCount },
+		Keyword{ "MaxRange"sv, Symbol::kMaxRange },
+		Keyword{ "MinRange"sv, Symbol::kMinRange },
+		Keyword{ "Morphs"sv, Symbol::kMorphs },
+		Keyword{ "MULADD"sv, Symbol::kMULADD },
+		Keyword{ "MusicTracks"sv, Symbol::kMusicTracks },
+		Keyword{ "None"sv, Symbol::kNone },
+		Keyword{ "NPCAddAmmoList"sv, Symbol::kNPCAddAmmoList },
+		Keyword{ "ObjectEffect"sv, Symbol::kObjectEffect },
+		Keyword{ "Objects"sv, Symbol::kObjects },
+		Keyword{ "OR"sv, Symbol::kOR },
+		Keyword{ "PlaysOneSelection"sv, Symbol::kPlaysOneSelection },
+		Keyword{ "Priority"sv, Symbol::kPriority },
+		Keyword{ "Properties"sv, Symbol::kProperties },
+		Keyword{ "Race"sv, Symbol::kRace },
+		Keyword{ "Reach"sv, Symbol::kReach },
+		Keyword{ "ReloadSpeed"sv, Symbol::kReloadSpeed },
+		Keyword{ "REM"sv, Symbol::kREM },
+		Keyword{ "Resistances"sv, Symbol::kResistances },
+		Keyword{ "SET"sv, Symbol::kSET },
+		Keyword{ "Set"sv, Symbol::kSet },
+		Keyword{ "Sex"sv, Symbol::kSex },
+		Keyword{ "Skin"sv, Symbol::kSkin },
+		Keyword{ "Speed"sv, Symbol::kSpeed },
+		Keyword{ "Tints"sv, Symbol::kTints },
+		Keyword{ "WeightFat"sv, Symbol::kWeightFat },
+		Keyword{ "WeightMuscular"sv, Symbol::kWeightMuscular },
+		Keyword{ "WeightThin"sv, Symbol::kWeightThin },
+		Keyword{ "WorkbenchKeyword"sv, Symbol::kWorkbenchKeyword },
+	};
+
+	inline constexpr PerfectHash::Table<Keywords> g_keywordTable;
+
+	constexpr Symbol Intern(std::string_view a_token) {
+		std::size_t index = g_keywordTable.Find(a_token);
+		return index != PerfectHash::npos ? Keywords[index].Symbol : Symbol::kUnknown;
+	}
+
+	consteval bool IsKeywordTableValid() {
+		for (std::size_t ii = 0; ii < Keywords.size(); ii++) {
+			if (static_cast<std::size_t>(Keywords[ii].Symbol) != ii + 1) {
+				return false;
+			}
+		}
+
+		return PerfectHash::IsTableValid<Keywords, g_keywordTable>();
+	}
+
+	static_assert(IsKeywordTableValid(), "Keywords must list every Symbol once, in declaration order");
+}
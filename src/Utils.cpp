@@ -1,6 +1,378 @@
 #include "Utils.h"
 
+#include <shared_mutex>
+
 namespace Utils {
+	namespace {
+		struct CaseInsensitiveHash {
+			using is_transparent = void;
+
+			std::size_t operator()(std::string_view a_str) const {
+				std::uint64_t hash = 0xCBF29CE484222325;
+				for (unsigned char ch : a_str) {
+					hash ^= static_cast<unsigned char>(std::tolower(ch));
+					hash *= 0x100000001B3;
+				}
+
+				return static_cast<std::size_t>(hash);
+			}
+		};
+
+		struct CaseInsensitiveEqual {
+			using is_transparent = void;
+
+			bool operator()(std::string_view a_lhs, std::string_view a_rhs) const {
+				return std::equal(a_lhs.begin(), a_lhs.end(), a_rhs.begin(), a_rhs.end(), [](unsigned char a_lch, unsigned char a_rch) {
+					return std::tolower(a_lch) == std::tolower(a_rch);
+				});
+			}
+		};
+
+		// Loaded plugins by name, built once when game data is ready and only read afterwards
+		class PluginIndex {
+		public:
+			void Build() {
+				auto start = std::chrono::steady_clock::now();
+
+				RE::TESDataHandler* g_dataHandler = RE::TESDataHandler::GetSingleton();
+				if (g_dataHandler) {
+					for (RE::TESFile* file : g_dataHandler->compiledFileCollection.files) {
+						Add(file, false);
+					}
+
+					for (RE::TESFile* file : g_dataHandler->compiledFileCollection.smallFiles) {
+						Add(file, true);
+					}
+				}
+
+				_buildDuration = std::chrono::steady_clock::now() - start;
+				_built.store(true, std::memory_order_release);
+			}
+
+			bool IsBuilt() const {
+				return _built.load(std::memory_order_acquire);
+			}
+
+			const PluginInfo* Find(std::string_view a_pluginName) const {
+				_lookups.fetch_add(1, std::memory_order_relaxed);
+
+				auto it = _plugins.find(a_pluginName);
+				return it != _plugins.end() ? &it->second : nullptr;
+			}
+
+			PluginIndexStats GetStats() const {
+				return PluginIndexStats{ _plugins.size(), _buildDuration, _lookups.load(std::memory_order_relaxed) };
+			}
+
+		private:
+			void Add(RE::TESFile* a_file, bool a_light) {
+				if (!a_file) {
+					return;
+				}
+
+				PluginInfo info;
+				info.File = a_file;
+				info.Active = a_file->IsActive();
+				info.Light = a_light;
+				info.CompileIndex = a_light ? a_file->smallFileCompileIndex : a_file->compileIndex;
+
+				_plugins.try_emplace(std::string(a_file->filename), info);
+			}
+
+			std::unordered_map<std::string, PluginInfo, CaseInsensitiveHash, CaseInsensitiveEqual> _plugins;
+			std::chrono::duration<double> _buildDuration{};
+			std::atomic<bool> _built = false;
+			mutable std::atomic<std::uint64_t> _lookups = 0;
+		};
+
+		PluginIndex g_pluginIndex;
+
+		// Forms by EditorID, compared case-insensitively. Built on first use in one pass over the data handler's form
+		// arrays, so configs without EditorID references never pay for it. Keys point at the EditorIDs the forms own.
+		class EditorIDIndex {
+		public:
+			RE::TESForm* Find(std::string_view a_editorID) {
+				std::call_once(_built, [this]() { Build(); });
+
+				auto it = _forms.find(a_editorID);
+				return it != _forms.end() ? it->second : nullptr;
+			}
+
+		private:
+			void Build() {
+				auto start = std::chrono::steady_clock::now();
+
+				RE::TESDataHandler* g_dataHandler = RE::TESDataHandler::GetSingleton();
+				if (!g_dataHandler) {
+					return;
+				}
+
+				for (const auto& formArray : g_dataHandler->formArrays) {
+					for (RE::TESForm* form : formArray) {
+						if (!form) {
+							continue;
+						}
+
+						const char* editorID = form->GetFormEditorID();
+						if (!editorID || editorID[0] == '\0') {
+							continue;
+						}
+
+						_forms.try_emplace(std::string_view(editorID), form);
+					}
+				}
+
+				std::chrono::duration<double> buildDuration = std::chrono::steady_clock::now() - start;
+				logger::info("EditorID index: {} forms indexed in {} seconds", _forms.size(), buildDuration.count());
+			}
+
+			std::once_flag _built;
+			std::unordered_map<std::string_view, RE::TESForm*, CaseInsensitiveHash, CaseInsensitiveEqual> _forms;
+		};
+
+		EditorIDIndex g_editorIDIndex;
+
+		// Plugin names met in form references, numbered in the order they were first seen. Configs are parsed before the
+		// load order is known, so Bind maps every number to the runtime index of its plugin once game data is ready.
+		class PluginTable {
+		public:
+			std::uint32_t Intern(std::string_view a_pluginName) {
+				{
+					std::shared_lock<std::shared_mutex> lock(_lock);
+
+					auto it = _ordinals.find(a_pluginName);
+					if (it != _ordinals.end()) {
+						return it->second;
+					}
+				}
+
+				std::unique_lock<std::shared_mutex> lock(_lock);
+
+				auto [it, inserted] = _ordinals.try_emplace(std::string(a_pluginName), static_cast<std::uint32_t>(_bindings.size()));
+				if (inserted) {
+					_bindings.push_back(_bound ? MakeBinding(it->first) : Binding{});
+					_names.push_back(&it->first);
+				}
+
+				return it->second;
+			}
+
+			void Bind() {
+				std::unique_lock<std::shared_mutex> lock(_lock);
+
+				for (std::size_t ii = 0; ii < _bindings.size(); ii++) {
+					_bindings[ii] = MakeBinding(*_names[ii]);
+				}
+
+				_bound = true;
+			}
+
+			bool IsBound() {
+				std::shared_lock<std::shared_mutex> lock(_lock);
+				return _bound;
+			}
+
+			std::string_view GetName(std::uint32_t a_pluginOrdinal) {
+				std::shared_lock<std::shared_mutex> lock(_lock);
+				return *_names[a_pluginOrdinal];
+			}
+
+			// Returns the runtime FormID of a_formKey, or nullopt when its plugin is not loaded
+			std::optional<std::uint32_t> GetFormID(FormKey a_formKey) {
+				std::shared_lock<std::shared_mutex> lock(_lock);
+
+				const Binding& binding = _bindings[a_formKey.GetPluginOrdinal()];
+				if (binding.Mask == 0) {
+					return std::nullopt;
+				}
+
+				return binding.Base | (a_formKey.GetLocalID() & binding.Mask);
+			}
+
+		private:
+			// A FormID is Base with the local ID masked in; a Mask of 0 marks a plugin that is not loaded
+			struct Binding {
+				std::uint32_t Base = 0;
+				std::uint32_t Mask = 0;
+			};
+
+			static Binding MakeBinding(std::string_view a_pluginName) {
+				const PluginInfo* plugin = g_pluginIndex.Find(a_pluginName);
+				if (!plugin || !plugin->Active) {
+					return Binding{};
+				}
+
+				if (plugin->Light) {
+					return Binding{ 0xFE000000 | (plugin->CompileIndex << 12), 0xFFF };
+				}
+
+				return Binding{ plugin->CompileIndex << 24, 0xFFFFFF };
+			}
+
+			std::shared_mutex _lock;
+			std::unordered_map<std::string, std::uint32_t, CaseInsensitiveHash, CaseInsensitiveEqual> _ordinals;
+			std::vector<const std::string*> _names;
+			std::vector<Binding> _bindings;
+			bool _bound = false;
+		};
+
+		// EditorIDs met in form references, numbered in the order they were first seen
+		class EditorIDTable {
+		public:
+			std::uint32_t Intern(std::string_view a_editorID) {
+				{
+					std::shared_lock<std::shared_mutex> lock(_lock);
+
+					auto it = _ordinals.find(a_editorID);
+					if (it != _ordinals.end()) {
+						return it->second;
+					}
+				}
+
+				std::unique_lock<std::shared_mutex> lock(_lock);
+
+				auto [it, inserted] = _ordinals.try_emplace(std::string(a_editorID), static_cast<std::uint32_t>(_names.size()));
+				if (inserted) {
+					_names.push_back(&it->first);
+				}
+
+				return it->second;
+			}
+
+			std::string_view GetName(std::uint32_t a_editorIDOrdinal) {
+				std::shared_lock<std::shared_mutex> lock(_lock);
+				return *_names[a_editorIDOrdinal];
+			}
+
+		private:
+			std::shared_mutex _lock;
+			std::unordered_map<std::string, std::uint32_t, CaseInsensitiveHash, CaseInsensitiveEqual> _ordinals;
+			std::vector<const std::string*> _names;
+		};
+
+		// Forms resolved from FormKeys, shared by every record type. The table is open addressed on the packed key value.
+		// Unresolved forms are cached too; the load order does not change once plugins are bound.
+		class FormCache {
+		public:
+			std::optional<RE::TESForm*> Find(FormKey a_formKey) {
+				std::shared_lock<std::shared_mutex> lock(_lock);
+
+				const Slot* slot = FindSlot(a_formKey.Value);
+				if (!slot || slot->Key == EmptyKey) {
+					return std::nullopt;
+				}
+
+				return slot->Form;
+			}
+
+			void Insert(FormKey a_formKey, RE::TESForm* a_form) {
+				std::unique_lock<std::shared_mutex> lock(_lock);
+
+				Reserve(1);
+				InsertUnlocked(a_formKey, a_form);
+			}
+
+			void Insert(const std::vector<std::pair<FormKey, RE::TESForm*>>& a_forms) {
+				std::unique_lock<std::shared_mutex> lock(_lock);
+
+				Reserve(a_forms.size());
+				for (const auto& [formKey, form] : a_forms) {
+					InsertUnlocked(formKey, form);
+				}
+			}
+
+		private:
+			static constexpr std::uint64_t EmptyKey = ~std::uint64_t{ 0 };
+
+			struct Slot {
+				std::uint64_t Key = EmptyKey;
+				RE::TESForm* Form = nullptr;
+			};
+
+			// Returns the slot holding a_key or the empty slot where it belongs, or nullptr while the table is empty
+			Slot* FindSlot(std::uint64_t a_key) {
+				if (_slots.empty()) {
+					return nullptr;
+				}
+
+				std::size_t mask = _slots.size() - 1;
+
+				// Fibonacci hashing spreads the sequential FormIDs of one plugin over the table
+				std::size_t index = static_cast<std::size_t>((a_key * 0x9E3779B97F4A7C15) >> 32) & mask;
+				while (_slots[index].Key != EmptyKey && _slots[index].Key != a_key) {
+					index = (index + 1) & mask;
+				}
+
+				return &_slots[index];
+			}
+
+			// Kept at most half full, so probe sequences stay short
+			void Reserve(std::size_t a_count) {
+				while ((_size + a_count) * 2 > _slots.size()) {
+					Grow();
+				}
+			}
+
+			void InsertUnlocked(FormKey a_formKey, RE::TESForm* a_form) {
+				Slot* slot = FindSlot(a_formKey.Value);
+				if (slot->Key == EmptyKey) {
+					slot->Key = a_formKey.Value;
+					_size++;
+				}
+
+				slot->Form = a_form;
+			}
+
+			void Grow() {
+				std::vector<Slot> oldSlots(std::max<std::size_t>(_slots.size() * 2, 1024));
+				oldSlots.swap(_slots);
+
+				for (const Slot& oldSlot : oldSlots) {
+					if (oldSlot.Key != EmptyKey) {
+						*FindSlot(oldSlot.Key) = oldSlot;
+					}
+				}
+			}
+
+			std::shared_mutex _lock;
+			std::vector<Slot> _slots;
+			std::size_t _size = 0;
+		};
+
+		PluginTable g_pluginTable;
+		EditorIDTable g_editorIDTable;
+		FormCache g_formCache;
+		std::atomic<std::uint64_t> g_formCacheHits = 0;
+		std::atomic<std::uint64_t> g_formCacheMisses = 0;
+		std::atomic<bool> g_editorIDMissWarned = false;
+
+		// Looks a form up by plugin name, as every lookup did before FormKeys; used until plugins are bound
+		RE::TESForm* LookupForm(std::string_view a_pluginName, std::uint32_t a_formID) {
+			RE::TESDataHandler* g_dataHandler = RE::TESDataHandler::GetSingleton();
+			if (!g_dataHandler) {
+				return nullptr;
+			}
+
+			return g_dataHandler->LookupForm(a_formID, a_pluginName);
+		}
+
+		// Finds the form of a_formKey without the form cache
+		RE::TESForm* Resolve(FormKey a_formKey) {
+			std::string_view pluginName = g_pluginTable.GetName(a_formKey.GetPluginOrdinal());
+
+			if (a_formKey.IsEditorID()) {
+				return GetFormFromEditorID(pluginName, g_editorIDTable.GetName(a_formKey.GetEditorIDOrdinal()));
+			}
+
+			if (!g_pluginTable.IsBound()) {
+				return LookupForm(pluginName, a_formKey.GetLocalID());
+			}
+
+			auto formID = g_pluginTable.GetFormID(a_formKey);
+			return formID.has_value() ? RE::TESForm::GetFormByID(formID.value()) : nullptr;
+		}
+	}
+
 	std::string_view Trim(std::string_view a_str) {
 		std::size_t sIdx, eIdx;
 
@@ -33,20 +405,26 @@ namespace Utils {
 	}
 
 	std::uint32_t ParseHex(std::string_view a_hexStr) {
+		if (a_hexStr.length() >= 2 && a_hexStr[0] == '0' && (a_hexStr[1] == 'x' || a_hexStr[1] == 'X')) {
+			a_hexStr.remove_prefix(2);
+		}
+
+		// Out of range values give 0, as std::stoul throwing did
 		std::uint32_t retID = 0;
-		try {
-			retID = std::stoul(std::string(a_hexStr), nullptr, 16);
+		auto [ptr, ec] = std::from_chars(a_hexStr.data(), a_hexStr.data() + a_hexStr.size(), retID, 16);
+		if (ec != std::errc()) {
+			return 0;
 		}
-		catch (...) {}
-		return retID;
-	}
 
-	std::uint32_t ParseFormID(std::string_view a_formIdStr) {
-		std::uint32_t retID = ParseHex(a_formIdStr) & 0xFFFFFF;
 		return retID;
 	}
 
 	bool IsPluginExists(std::string_view a_pluginName) {
+		if (g_pluginIndex.IsBuilt()) {
+			const PluginInfo* plugin = g_pluginIndex.Find(a_pluginName);
+			return plugin && plugin->Active;
+		}
+
 		RE::TESDataHandler* g_dataHandler = RE::TESDataHandler::GetSingleton();
 		if (!g_dataHandler) {
 			return false;
@@ -60,30 +438,164 @@ namespace Utils {
 		return mod->IsActive();
 	}
 
-	RE::TESForm* GetFormFromIdentifier(std::string_view a_pluginName, std::uint32_t a_formID) {
-		RE::TESDataHandler* g_dataHandler = RE::TESDataHandler::GetSingleton();
-		if (!g_dataHandler) {
-			return nullptr;
-		}
+	std::uint32_t InternPlugin(std::string_view a_pluginName) {
+		return g_pluginTable.Intern(a_pluginName);
+	}
 
-		return g_dataHandler->LookupForm(a_formID, a_pluginName);
+	std::string_view GetPluginName(std::uint32_t a_pluginOrdinal) {
+		return g_pluginTable.GetName(a_pluginOrdinal);
 	}
 
-	RE::TESForm* GetFormFromIdentifier(std::string_view pluginName, std::string_view formIdStr) {
-		std::uint32_t formID = ParseFormID(formIdStr);
-		return GetFormFromIdentifier(pluginName, formID);
+	std::uint32_t InternEditorID(std::string_view a_editorID) {
+		return g_editorIDTable.Intern(a_editorID);
 	}
 
-	RE::TESForm* GetFormFromString(std::string_view a_formStr) {
+	std::string_view GetEditorID(std::uint32_t a_editorIDOrdinal) {
+		return g_editorIDTable.GetName(a_editorIDOrdinal);
+	}
+
+	FormKey MakeFormKey(std::string_view a_pluginName, std::uint32_t a_formID) {
+		return FormKey::Pack(InternPlugin(a_pluginName), a_formID & 0xFFFFFF);
+	}
+
+	FormKey MakeEditorIDKey(std::string_view a_pluginName, std::string_view a_editorID) {
+		return FormKey::PackEditorID(InternPlugin(a_pluginName), InternEditorID(a_editorID));
+	}
+
+	std::optional<FormKey> ParseFormKey(std::string_view a_formStr) {
 		auto delimiter = a_formStr.find('|');
 		if (delimiter == std::string_view::npos) {
-			return nullptr;
+			return std::nullopt;
 		}
 
 		std::string_view pluginName = Trim(a_formStr.substr(0, delimiter));
 		std::string_view formID = Trim(a_formStr.substr(delimiter + 1));
+		if (formID.starts_with('@')) {
+			return MakeEditorIDKey(pluginName, formID.substr(1));
+		}
+
+		return MakeFormKey(pluginName, ParseHex(formID));
+	}
+
+	void BindPlugins() {
+		g_pluginIndex.Build();
+		g_pluginTable.Bind();
+	}
+
+	bool ArePluginsBound() {
+		return g_pluginTable.IsBound();
+	}
+
+	const PluginInfo* FindPlugin(std::string_view a_pluginName) {
+		return g_pluginIndex.IsBuilt() ? g_pluginIndex.Find(a_pluginName) : nullptr;
+	}
+
+	PluginIndexStats GetPluginIndexStats() {
+		return g_pluginIndex.GetStats();
+	}
+
+	RE::TESForm* GetFormFromKey(FormKey a_formKey) {
+		if (auto cachedForm = g_formCache.Find(a_formKey)) {
+			g_formCacheHits.fetch_add(1, std::memory_order_relaxed);
+			return cachedForm.value();
+		}
+
+		// NPCs can be prepared from their hook before the load order is known. Those lookups go by plugin name and are not
+		// cached, since forms of plugins still loading would be cached as missing.
+		if (!g_pluginTable.IsBound()) {
+			return Resolve(a_formKey);
+		}
+
+		RE::TESForm* form = Resolve(a_formKey);
+
+		g_formCacheMisses.fetch_add(1, std::memory_order_relaxed);
+		g_formCache.Insert(a_formKey, form);
+
+		return form;
+	}
+
+	std::size_t ResolveForms(std::vector<FormReference*>& a_formReferences) {
+		// Sorting by the packed value groups the keys by plugin, in local FormID order, with the references to one form
+		// next to each other
+		std::sort(a_formReferences.begin(), a_formReferences.end(), [](const FormReference* a_lhs, const FormReference* a_rhs) {
+			return a_lhs->Key->Value < a_rhs->Key->Value;
+		});
+
+		// Forms resolved before the load order is known are not cached, as in GetFormFromKey
+		bool bound = g_pluginTable.IsBound();
+
+		std::vector<std::pair<FormKey, RE::TESForm*>> resolvedForms;
+		std::size_t formCount = 0;
+
+		for (auto it = a_formReferences.begin(); it != a_formReferences.end(); formCount++) {
+			FormKey formKey = (*it)->Key.value();
+
+			RE::TESForm* form = nullptr;
+			if (auto cachedForm = g_formCache.Find(formKey)) {
+				form = cachedForm.value();
+			}
+			else {
+				form = Resolve(formKey);
+				if (bound) {
+					resolvedForms.emplace_back(formKey, form);
+				}
+			}
+
+			for (; it != a_formReferences.end() && (*it)->Key.value() == formKey; ++it) {
+				(*it)->Form = form;
+			}
+		}
+
+		g_formCacheMisses.fetch_add(resolvedForms.size(), std::memory_order_relaxed);
+		g_formCache.Insert(resolvedForms);
+
+		return formCount;
+	}
+
+	FormCacheStats GetFormCacheStats() {
+		return FormCacheStats{ g_formCacheHits.load(std::memory_order_relaxed), g_formCacheMisses.load(std::memory_order_relaxed) };
+	}
+
+	RE::TESForm* GetFormFromIdentifier(std::string_view a_pluginName, std::uint32_t a_formID) {
+		return GetFormFromKey(MakeFormKey(a_pluginName, a_formID));
+	}
+
+	RE::TESForm* GetFormFromIdentifier(std::string_view pluginName, std::string_view formIdStr) {
+		return GetFormFromKey(MakeFormKey(pluginName, ParseHex(formIdStr)));
+	}
+
+	RE::TESForm* GetFormFromEditorID(std::string_view a_pluginName, std::string_view a_editorID) {
+		// The index is built from the loaded forms, which are not all there before the load order is known. Until then the
+		// game's own EditorID map is asked, and nothing is indexed.
+		RE::TESForm* form = g_pluginTable.IsBound() ? g_editorIDIndex.Find(a_editorID) : RE::TESForm::GetFormByEditorID(a_editorID);
+		if (!form) {
+			// Most misses come from form types the game drops EditorIDs of, which is worth saying once rather than per reference
+			if (!g_editorIDMissWarned.exchange(true)) {
+				logger::warn("EditorID '{}' was not found. The game keeps EditorIDs only for some form types; other forms must be referenced by FormID.", a_editorID);
+			}
+			return nullptr;
+		}
+
+		if (!g_pluginTable.IsBound()) {
+			return LookupForm(a_pluginName, form->formID) == form ? form : nullptr;
+		}
+
+		// The form must come from a_pluginName, which holds when its FormID is what the plugin would map it to
+		auto formID = g_pluginTable.GetFormID(MakeFormKey(a_pluginName, form->formID));
+		if (formID != form->formID) {
+			return nullptr;
+		}
+
+		return form;
+	}
+
+	RE::TESForm* GetFormFromString(std::string_view a_formStr) {
+		auto formKey = ParseFormKey(a_formStr);
+		if (!formKey.has_value()) {
+			return nullptr;
+		}
 
-		return Utils::GetFormFromIdentifier(pluginName, formID);
+		return GetFormFromKey(formKey.value());
 	}
 
 	bool GetPluginNameFormID(RE::TESForm* a_form, std::string_view& a_pluginName, std::uint32_t& a_formID) {
@@ -7,4 +7,112 @@ namespace Utils {
 	RE::TESForm* GetFormFromIdentifier(std::string_view pluginName, std::uint32_t formId);
     RE::TESForm* GetFormFromIdentifier(std::string_view pluginName, std::string_view formIdStr);
 	RE::TESForm* GetFormFromString(std::string_view formStr);
+
+	// A form reference with its plugin name interned to an ordinal, packed above the local FormID. References by EditorID
+	// have EditorIDFlag set in the plugin half and the interned EditorID in place of the local FormID.
+	struct FormKey {
+		static constexpr std::uint32_t EditorIDFlag = 0x80000000;
+
+		static constexpr FormKey Pack(std::uint32_t a_pluginOrdinal, std::uint32_t a_localID) {
+			return FormKey{ (static_cast<std::uint64_t>(a_pluginOrdinal) << 32) | a_localID };
+		}
+
+		static constexpr FormKey PackEditorID(std::uint32_t a_pluginOrdinal, std::uint32_t a_editorIDOrdinal) {
+			return Pack(a_pluginOrdinal | EditorIDFlag, a_editorIDOrdinal);
+		}
+
+		constexpr bool IsEditorID() const { return (static_cast<std::uint32_t>(Value >> 32) & EditorIDFlag) != 0; }
+		constexpr std::uint32_t GetPluginOrdinal() const { return static_cast<std::uint32_t>(Value >> 32) & ~EditorIDFlag; }
+		constexpr std::uint32_t GetLocalID() const { return static_cast<std::uint32_t>(Value); }
+		constexpr std::uint32_t GetEditorIDOrdinal() const { return static_cast<std::uint32_t>(Value); }
+
+		constexpr bool operator==(const FormKey&) const = default;
+
+		std::uint64_t Value = 0;
+	};
+
+	// Returns the ordinal of a_pluginName, numbering it if it is new. Names are compared case-insensitively.
+	std::uint32_t InternPlugin(std::string_view a_pluginName);
+
+	std::string_view GetPluginName(std::uint32_t a_pluginOrdinal);
+
+	// Returns the ordinal of a_editorID, numbering it if it is new. EditorIDs are compared case-insensitively.
+	std::uint32_t InternEditorID(std::string_view a_editorID);
+
+	std::string_view GetEditorID(std::uint32_t a_editorIDOrdinal);
+
+	FormKey MakeFormKey(std::string_view a_pluginName, std::uint32_t a_formID);
+
+	FormKey MakeEditorIDKey(std::string_view a_pluginName, std::string_view a_editorID);
+
+	// Parses "PluginName|FormID" or "PluginName|@EditorID"
+	std::optional<FormKey> ParseFormKey(std::string_view a_formStr);
+
+	// A form as a config references it: the text as written, for messages, and the key parsed from it. The text "null"
+	// stands for no form and has no key. Form is filled in by ResolveForms before the config is prepared.
+	struct FormReference {
+		std::string_view Text;
+		std::optional<FormKey> Key = std::nullopt;
+		RE::TESForm* Form = nullptr;
+
+		bool IsNull() const { return !Key.has_value(); }
+	};
+
+	// The key is written by plugin name and local FormID or EditorID, since ordinals are numbered anew on every launch.
+	// Form is not written; it is resolved again after every read.
+	template <typename Archive>
+	void Serialize(Archive& a_ar, FormReference& a_formReference) {
+		a_ar(a_formReference.Text, a_formReference.Key);
+	}
+
+	struct PluginInfo {
+		const RE::TESFile* File = nullptr;
+		bool Active = false;
+		bool Light = false;
+		std::uint32_t CompileIndex = 0;
+	};
+
+	// Indexes the loaded plugins by name and maps every interned plugin to its load order index. Called once game data is
+	// ready; plugins interned later are mapped as they are added.
+	void BindPlugins();
+
+	bool ArePluginsBound();
+
+	// Looks a_pluginName up in the plugin index, case-insensitively. Returns nullptr for plugins that are not loaded.
+	const PluginInfo* FindPlugin(std::string_view a_pluginName);
+
+	struct PluginIndexStats {
+		std::size_t Plugins = 0;
+		std::chrono::duration<double> BuildDuration{};
+		std::uint64_t Lookups = 0;
+	};
+
+	PluginIndexStats GetPluginIndexStats();
+
+	// One arithmetic step and a single TESForm::GetFormByID, once per distinct key
+	RE::TESForm* GetFormFromKey(FormKey a_formKey);
+
+	// Looks a_editorID up in an index of every loaded form, built the first time it is needed. Returns nullptr unless
+	// the form comes from a_pluginName.
+	RE::TESForm* GetFormFromEditorID(std::string_view a_pluginName, std::string_view a_editorID);
+
+	// Sorts a_formReferences by key and looks every distinct key up once, then sets Form on every reference to it. Keys
+	// that are not cached yet are added to the shared cache once plugins are bound. Returns the number of distinct keys.
+	std::size_t ResolveForms(std::vector<FormReference*>& a_formReferences);
+
+	struct FormCacheStats {
+		std::uint64_t Hits = 0;
+		std::uint64_t Misses = 0;
+	};
+
+	// Counts of form lookups answered from the resolved forms shared by every record type, and of lookups that were run
+	FormCacheStats GetFormCacheStats();
 }
+
+template <>
+struct fmt::formatter<Utils::FormReference> : fmt::formatter<std::string_view> {
+	template <typename FormatContext>
+	auto format(const Utils::FormReference& a_formReference, FormatContext& a_ctx) const {
+		return fmt::formatter<std::string_view>::format(a_formReference.Text, a_ctx);
+	}
+};
@@ -1,7 +1,6 @@
 #include "Weapons.h"
 
 #include <any>
-#include <regex>
 
 #include "ConfigUtils.h"
 #include "Parsers.h"
@@ -50,11 +49,17 @@ namespace Weapons {
 
 	struct ConfigData {
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
 		std::optional<std::any> AssignValue;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element);
+		a_ar.template Any<Utils::FormReference, float>(a_configData.AssignValue);
+	}
+
 	struct PatchData {
 		std::optional<RE::TESAmmo*> Ammo;
 		std::optional<float> AttackDelay;
@@ -65,14 +70,20 @@ namespace Weapons {
 		std::optional<float> Reach;
 		std::optional<float> ReloadSpeed;
 		std::optional<float> Speed;
+
+		bool operator==(const PatchData&) const = default;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::TESObjectWEAP*, PatchData> g_patchMap;
+	std::unordered_map<RE::TESObjectWEAP*, PatchData> g_appliedPatchMap;
+	std::unordered_map<RE::TESObjectWEAP*, PatchData> g_originalDataMap;
 
 	class WeaponParser : public Parsers::Parser<ConfigData> {
 	public:
 		WeaponParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		WeaponParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -106,7 +117,7 @@ namespace Weapons {
 				return std::nullopt;
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -117,7 +128,7 @@ namespace Weapons {
 			case ElementType::kNPCAddAmmoList:
 			case ElementType::kObjectEffect:
 				logger::info("{}{}({}).{} = {};", indent, FilterTypeToString(a_configData.Filter), a_configData.FilterForm,
-					ElementTypeToString(a_configData.Element), std::any_cast<std::string>(a_configData.AssignValue.value()));
+					ElementTypeToString(a_configData.Element), std::any_cast<Utils::FormReference>(a_configData.AssignValue.value()));
 				break;
 			case ElementType::kAttackDelay:
 			case ElementType::kMaxRange:
@@ -133,7 +144,7 @@ namespace Weapons {
 
 		bool ParseFilter(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_config.Filter = FilterType::kFormID;
 			}
 			else {
@@ -165,34 +176,44 @@ namespace Weapons {
 
 		bool ParseElement(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "Ammo") {
+			switch (reader.GetLastSymbol()) {
+			case Symbol::kAmmo:
 				a_config.Element = ElementType::kAmmo;
-			}
-			else if (token == "AttackDelay") {
+				break;
+
+			case Symbol::kAttackDelay:
 				a_config.Element = ElementType::kAttackDelay;
-			}
-			else if (token == "MaxRange") {
+				break;
+
+			case Symbol::kMaxRange:
 				a_config.Element = ElementType::kMaxRange;
-			}
-			else if (token == "MinRange") {
+				break;
+
+			case Symbol::kMinRange:
 				a_config.Element = ElementType::kMinRange;
-			}
-			else if (token == "NPCAddAmmoList") {
+				break;
+
+			case Symbol::kNPCAddAmmoList:
 				a_config.Element = ElementType::kNPCAddAmmoList;
-			}
-			else if (token == "ObjectEffect") {
+				break;
+
+			case Symbol::kObjectEffect:
 				a_config.Element = ElementType::kObjectEffect;
-			}
-			else if (token == "Reach") {
+				break;
+
+			case Symbol::kReach:
 				a_config.Element = ElementType::kReach;
-			}
-			else if (token == "ReloadSpeed") {
+				break;
+
+			case Symbol::kReloadSpeed:
 				a_config.Element = ElementType::kReloadSpeed;
-			}
-			else if (token == "Speed") {
+				break;
+
+			case Symbol::kSpeed:
 				a_config.Element = ElementType::kSpeed;
-			}
-			else {
+				break;
+
+			default:
 				logger::warn("Line {}, Col {}: Invalid ElementName '{}'.", reader.GetLastLine(), reader.GetLastLineIndex(), token);
 				return false;
 			}
@@ -208,9 +229,8 @@ namespace Weapons {
 			}
 
 			if (a_config.Element == ElementType::kAmmo || a_config.Element == ElementType::kNPCAddAmmoList || a_config.Element == ElementType::kObjectEffect) {
-				token = reader.Peek();
-				if (token == "null") {
-					a_config.AssignValue = std::any(std::string(reader.GetToken()));
+				if (reader.PeekSymbol() == Symbol::kNull) {
+					a_config.AssignValue = std::any(Utils::FormReference{ reader.GetToken() });
 				}
 				else {
 					auto effectForm = ParseForm();
@@ -240,12 +260,16 @@ namespace Weapons {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<WeaponParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<WeaponParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
+	}
+
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::TESObjectWEAP*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -258,136 +282,191 @@ namespace Weapons {
 			}
 
 			if (a_configData.Element == ElementType::kAmmo) {
-				std::string formStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+				const Utils::FormReference& formRef = std::any_cast<const Utils::FormReference&>(a_configData.AssignValue.value());
 
-				if (formStr == "null") {
-					g_patchMap[weap].Ammo = nullptr;
+				if (formRef.IsNull()) {
+					a_patchMap[weap].Ammo = nullptr;
 				}
 				else {
-					RE::TESForm* ammoForm = Utils::GetFormFromString(formStr);
+					RE::TESForm* ammoForm = formRef.Form;
 					if (!ammoForm) {
-						logger::warn("Invalid Form: '{}'.", formStr);
+						logger::warn("Invalid Form: '{}'.", formRef);
 						return;
 					}
 
 					RE::TESAmmo* ammo = ammoForm->As<RE::TESAmmo>();
 					if (!ammo) {
-						logger::warn("'{}' is not an Ammo.", formStr);
+						logger::warn("'{}' is not an Ammo.", formRef);
 						return;
 					}
 
-					g_patchMap[weap].Ammo = ammo;
+					a_patchMap[weap].Ammo = ammo;
 				}
 			}
 			else if (a_configData.Element == ElementType::kAttackDelay) {
-				g_patchMap[weap].AttackDelay = std::any_cast<float>(a_configData.AssignValue.value());
+				a_patchMap[weap].AttackDelay = std::any_cast<float>(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kMaxRange) {
-				g_patchMap[weap].MaxRange = std::any_cast<float>(a_configData.AssignValue.value());
+				a_patchMap[weap].MaxRange = std::any_cast<float>(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kMinRange) {
-				g_patchMap[weap].MinRange = std::any_cast<float>(a_configData.AssignValue.value());
+				a_patchMap[weap].MinRange = std::any_cast<float>(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kNPCAddAmmoList) {
-				std::string formStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+				const Utils::FormReference& formRef = std::any_cast<const Utils::FormReference&>(a_configData.AssignValue.value());
 
-				if (formStr == "null") {
-					g_patchMap[weap].NPCAddAmmoList = nullptr;
+				if (formRef.IsNull()) {
+					a_patchMap[weap].NPCAddAmmoList = nullptr;
 				}
 				else {
-					RE::TESForm* levItemForm = Utils::GetFormFromString(formStr);
+					RE::TESForm* levItemForm = formRef.Form;
 					if (!levItemForm) {
-						logger::warn("Invalid Form: '{}'.", formStr);
+						logger::warn("Invalid Form: '{}'.", formRef);
 						return;
 					}
 
 					RE::TESLevItem* levItem = levItemForm->As<RE::TESLevItem>();
 					if (!levItem) {
-						logger::warn("'{}' is not a Leveled Item.", formStr);
+						logger::warn("'{}' is not a Leveled Item.", formRef);
 						return;
 					}
 
-					g_patchMap[weap].NPCAddAmmoList = levItem;
+					a_patchMap[weap].NPCAddAmmoList = levItem;
 				}
 			}
 			else if (a_configData.Element == ElementType::kObjectEffect) {
-				std::string formStr = std::any_cast<std::string>(a_configData.AssignValue.value());
+				const Utils::FormReference& formRef = std::any_cast<const Utils::FormReference&>(a_configData.AssignValue.value());
 
-				if (formStr == "null") {
-					g_patchMap[weap].ObjectEffect = nullptr;
+				if (formRef.IsNull()) {
+					a_patchMap[weap].ObjectEffect = nullptr;
 				}
 				else {
-					RE::TESForm* effectForm = Utils::GetFormFromString(formStr);
+					RE::TESForm* effectForm = formRef.Form;
 					if (!effectForm) {
-						logger::warn("Invalid Form: '{}'.", formStr);
+						logger::warn("Invalid Form: '{}'.", formRef);
 						return;
 					}
 
 					RE::EnchantmentItem* objectEffect = effectForm->As<RE::EnchantmentItem>();
 					if (!objectEffect) {
-						logger::warn("'{}' is not an Object Effect.", formStr);
+						logger::warn("'{}' is not an Object Effect.", formRef);
 						return;
 					}
 
-					g_patchMap[weap].ObjectEffect = objectEffect;
+					a_patchMap[weap].ObjectEffect = objectEffect;
 				}
 			}
 			else if (a_configData.Element == ElementType::kReach) {
-				g_patchMap[weap].Reach = std::any_cast<float>(a_configData.AssignValue.value());
+				a_patchMap[weap].Reach = std::any_cast<float>(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kReloadSpeed) {
-				g_patchMap[weap].ReloadSpeed = std::any_cast<float>(a_configData.AssignValue.value());
+				a_patchMap[weap].ReloadSpeed = std::any_cast<float>(a_configData.AssignValue.value());
 			}
 			else if (a_configData.Element == ElementType::kSpeed) {
-				g_patchMap[weap].Speed = std::any_cast<float>(a_configData.AssignValue.value());
+				a_patchMap[weap].Speed = std::any_cast<float>(a_configData.AssignValue.value());
 			}
 		}
 	}
 
+	void Capture(RE::TESObjectWEAP* a_weap, const PatchData& a_patchData, PatchData& a_originalData) {
+		if (a_patchData.Ammo.has_value() && !a_originalData.Ammo.has_value()) {
+			a_originalData.Ammo = a_weap->weaponData.ammo;
+		}
+		if (a_patchData.AttackDelay.has_value() && !a_originalData.AttackDelay.has_value()) {
+			a_originalData.AttackDelay = a_weap->weaponData.attackDelaySec;
+		}
+		if (a_patchData.MaxRange.has_value() && !a_originalData.MaxRange.has_value()) {
+			a_originalData.MaxRange = a_weap->weaponData.maxRange;
+		}
+		if (a_patchData.MinRange.has_value() && !a_originalData.MinRange.has_value()) {
+			a_originalData.MinRange = a_weap->weaponData.minRange;
+		}
+		if (a_patchData.NPCAddAmmoList.has_value() && !a_originalData.NPCAddAmmoList.has_value()) {
+			a_originalData.NPCAddAmmoList = a_weap->weaponData.npcAddAmmoList;
+		}
+		if (a_patchData.ObjectEffect.has_value() && !a_originalData.ObjectEffect.has_value()) {
+			a_originalData.ObjectEffect = a_weap->formEnchanting;
+		}
+		if (a_patchData.Reach.has_value() && !a_originalData.Reach.has_value()) {
+			a_originalData.Reach = a_weap->weaponData.reach;
+		}
+		if (a_patchData.ReloadSpeed.has_value() && !a_originalData.ReloadSpeed.has_value()) {
+			a_originalData.ReloadSpeed = a_weap->weaponData.reloadSpeed;
+		}
+		if (a_patchData.Speed.has_value() && !a_originalData.Speed.has_value()) {
+			a_originalData.Speed = a_weap->weaponData.speed;
+		}
+	}
+
+	void Patch(RE::TESObjectWEAP* a_weap, const PatchData& a_patchData) {
+		if (a_patchData.Ammo.has_value()) {
+			a_weap->weaponData.ammo = a_patchData.Ammo.value();
+		}
+		if (a_patchData.AttackDelay.has_value()) {
+			a_weap->weaponData.attackDelaySec = a_patchData.AttackDelay.value();
+		}
+		if (a_patchData.MaxRange.has_value()) {
+			a_weap->weaponData.maxRange = a_patchData.MaxRange.value();
+		}
+		if (a_patchData.MinRange.has_value()) {
+			a_weap->weaponData.minRange = a_patchData.MinRange.value();
+		}
+		if (a_patchData.NPCAddAmmoList.has_value()) {
+			a_weap->weaponData.npcAddAmmoList = a_patchData.NPCAddAmmoList.value();
+		}
+		if (a_patchData.ObjectEffect.has_value()) {
+			a_weap->formEnchanting = a_patchData.ObjectEffect.value();
+		}
+		if (a_patchData.Reach.has_value()) {
+			a_weap->weaponData.reach = a_patchData.Reach.value();
+		}
+		if (a_patchData.ReloadSpeed.has_value()) {
+			a_weap->weaponData.reloadSpeed = a_patchData.ReloadSpeed.value();
+		}
+		if (a_patchData.Speed.has_value()) {
+			a_weap->weaponData.speed = a_patchData.Speed.value();
+		}
+	}
+
+	void ApplyPatches() {
+		ConfigUtils::ApplyPatches(g_appliedPatchMap, g_originalDataMap, std::move(g_patchMap), Capture, [](RE::TESObjectWEAP* a_weap, const PatchData& a_patchData) {
+			Patch(a_weap, a_patchData);
+		});
+	}
+
 	void Patch() {
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
 
 		logger::info("======================== Start patching for {} ========================", TypeName);
 
-		for (const auto& patchData : g_patchMap) {
-			if (patchData.second.Ammo.has_value()) {
-				patchData.first->weaponData.ammo = patchData.second.Ammo.value();
-			}
-			if (patchData.second.AttackDelay.has_value()) {
-				patchData.first->weaponData.attackDelaySec = patchData.second.AttackDelay.value();
-			}
-			if (patchData.second.MaxRange.has_value()) {
-				patchData.first->weaponData.maxRange = patchData.second.MaxRange.value();
-			}
-			if (patchData.second.MinRange.has_value()) {
-				patchData.first->weaponData.minRange = patchData.second.MinRange.value();
-			}
-			if (patchData.second.NPCAddAmmoList.has_value()) {
-				patchData.first->weaponData.npcAddAmmoList = patchData.second.NPCAddAmmoList.value();
-			}
-			if (patchData.second.ObjectEffect.has_value()) {
-				patchData.first->formEnchanting = patchData.second.ObjectEffect.value();
-			}
-			if (patchData.second.Reach.has_value()) {
-				patchData.first->weaponData.reach = patchData.second.Reach.value();
-			}
-			if (patchData.second.ReloadSpeed.has_value()) {
-				patchData.first->weaponData.reloadSpeed = patchData.second.ReloadSpeed.value();
-			}
-			if (patchData.second.Speed.has_value()) {
-				patchData.first->weaponData.speed = patchData.second.Speed.value();
-			}
-		}
+		ApplyPatches();
 
 		logger::info("======================== Finished patching for {} ========================", TypeName);
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
 	}
+
+	void Reload() {
+		logger::info("======================== Start reloading {} ========================", TypeName);
+
+		ReadConfigs();
+		ConfigUtils::ResolveForms(g_configVec);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
+		ApplyPatches();
+
+		g_configVec.clear();
+		g_arena.Release();
+		g_patchMap.clear();
+
+		logger::info("======================== Finished reloading {} ========================", TypeName);
+		logger::info("");
+	}
 }
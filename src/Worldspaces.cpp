@@ -1,7 +1,5 @@
 #include "WorldSpaces.h"
 
-#include <regex>
-
 #include "ConfigUtils.h"
 #include "Parsers.h"
 #include "Utils.h"
@@ -33,21 +31,32 @@ namespace WorldSpaces {
 
 	struct ConfigData {
 		FilterType Filter;
-		std::string FilterForm;
+		Utils::FormReference FilterForm;
 		ElementType Element;
-		std::optional<std::string> AssignValue;
+		std::optional<std::string_view> AssignValue;
 	};
 
+	template <typename Archive>
+	void Serialize(Archive& a_ar, ConfigData& a_configData) {
+		a_ar(a_configData.Filter, a_configData.FilterForm, a_configData.Element, a_configData.AssignValue);
+	}
+
 	struct PatchData {
 		std::optional<std::string> FullName;
+
+		bool operator==(const PatchData&) const = default;
 	};
 
+	Arenas::Arena g_arena;
 	std::vector<Parsers::Statement<ConfigData>> g_configVec;
 	std::unordered_map<RE::TESWorldSpace*, PatchData> g_patchMap;
+	std::unordered_map<RE::TESWorldSpace*, PatchData> g_appliedPatchMap;
+	std::unordered_map<RE::TESWorldSpace*, PatchData> g_originalDataMap;
 
 	class WorldspaceParser : public Parsers::Parser<ConfigData> {
 	public:
 		WorldspaceParser(std::string_view a_configPath) : Parsers::Parser<ConfigData>(a_configPath) {}
+		WorldspaceParser(const Configs::ConfigChunk& a_configChunk) : Parsers::Parser<ConfigData>(a_configChunk) {}
 
 	protected:
 		std::optional<Parsers::Statement<ConfigData>> ParseExpressionStatement() override {
@@ -81,7 +90,7 @@ namespace WorldSpaces {
 				return std::nullopt;
 			}
 
-			return Parsers::Statement<ConfigData>::CreateExpressionStatement(configData);
+			return Parsers::Statement<ConfigData>::CreateExpressionStatement(std::move(configData));
 		}
 
 		void PrintExpressionStatement(const ConfigData& a_configData, int a_indent) override {
@@ -97,7 +106,7 @@ namespace WorldSpaces {
 
 		bool ParseFilter(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "FilterByFormID") {
+			if (reader.GetLastSymbol() == Symbol::kFilterByFormID) {
 				a_config.Filter = FilterType::kFormID;
 			}
 			else {
@@ -129,7 +138,7 @@ namespace WorldSpaces {
 
 		bool ParseElement(ConfigData& a_config) {
 			auto token = reader.GetToken();
-			if (token == "FullName") {
+			if (reader.GetLastSymbol() == Symbol::kFullName) {
 				a_config.Element = ElementType::kFullName;
 			}
 			else {
@@ -158,7 +167,7 @@ namespace WorldSpaces {
 					return false;
 				}
 
-				a_config.AssignValue = std::string(token.substr(1, token.length() - 2));
+				a_config.AssignValue = token.substr(1, token.length() - 2);
 			}
 			else {
 				logger::warn("Line {}, Col {}: Invalid Assignment to {}.", reader.GetLastLine(), reader.GetLastLineIndex(), ElementTypeToString(a_config.Element));
@@ -170,12 +179,16 @@ namespace WorldSpaces {
 	};
 
 	void ReadConfigs() {
-		g_configVec = ConfigUtils::ReadConfigs<WorldspaceParser, Parsers::Statement<ConfigData>>(TypeName);
+		g_configVec = ConfigUtils::ReadConfigs<WorldspaceParser, Parsers::Statement<ConfigData>>(TypeName, g_arena);
+	}
+
+	void CollectForms(std::vector<Utils::FormReference*>& a_formReferences) {
+		ConfigUtils::CollectForms(g_configVec, a_formReferences);
 	}
 
-	void Prepare(const ConfigData& a_configData) {
+	void Prepare(const ConfigData& a_configData, std::unordered_map<RE::TESWorldSpace*, PatchData>& a_patchMap) {
 		if (a_configData.Filter == FilterType::kFormID) {
-			RE::TESForm* filterForm = Utils::GetFormFromString(a_configData.FilterForm);
+			RE::TESForm* filterForm = a_configData.FilterForm.Form;
 			if (!filterForm) {
 				logger::warn("Invalid FilterForm: '{}'.", a_configData.FilterForm);
 				return;
@@ -188,31 +201,62 @@ namespace WorldSpaces {
 			}
 
 			if (a_configData.Element == ElementType::kFullName) {
-				g_patchMap[worldspace].FullName = a_configData.AssignValue.value();
+				a_patchMap[worldspace].FullName = std::string(a_configData.AssignValue.value());
 			}
 		}
 	}
 
+	void Capture(RE::TESWorldSpace* a_worldspace, const PatchData& a_patchData, PatchData& a_originalData) {
+		if (a_patchData.FullName.has_value() && !a_originalData.FullName.has_value()) {
+			a_originalData.FullName = std::string(a_worldspace->fullName.c_str());
+		}
+	}
+
+	void Patch(RE::TESWorldSpace* a_worldspace, const PatchData& a_patchData) {
+		if (a_patchData.FullName.has_value()) {
+			a_worldspace->fullName = a_patchData.FullName.value();
+		}
+	}
+
+	void ApplyPatches() {
+		ConfigUtils::ApplyPatches(g_appliedPatchMap, g_originalDataMap, std::move(g_patchMap), Capture, [](RE::TESWorldSpace* a_worldspace, const PatchData& a_patchData) {
+			Patch(a_worldspace, a_patchData);
+		});
+	}
+
 	void Patch() {
 		logger::info("======================== Start preparing patch for {} ========================", TypeName);
 
-		ConfigUtils::Prepare(g_configVec, Prepare);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
 
 		logger::info("======================== Finished preparing patch for {} ========================", TypeName);
 		logger::info("");
 
 		logger::info("======================== Start patching for {} ========================", TypeName);
 
-		for (const auto& patchData : g_patchMap) {
-			if (patchData.second.FullName.has_value()) {
-				patchData.first->fullName = patchData.second.FullName.value();
-			}
-		}
+		ApplyPatches();
 
 		logger::info("======================== Finished patching for {} ========================", TypeName);
 		logger::info("");
 
 		g_configVec.clear();
+		g_arena.Release();
+		g_patchMap.clear();
+	}
+
+	void Reload() {
+		logger::info("======================== Start reloading {} ========================", TypeName);
+
+		ReadConfigs();
+		ConfigUtils::ResolveForms(g_configVec);
+		ConfigUtils::Prepare(g_configVec, g_patchMap, Prepare);
+		ApplyPatches();
+
+		g_configVec.clear();
+		g_arena.Release();
 		g_patchMap.clear();
+
+		logger::info("======================== Finished reloading {} ========================", TypeName);
+		logger::info("");
 	}
 }
@@ -1,3 +1,6 @@
+#include <latch>
+#include <thread>
+
 #include "ArmorAddons.h"
 #include "Armors.h"
 #include "Cells.h"
@@ -8,48 +11,207 @@
 #include "Keywords.h"
 #include "LeveledLists.h"
 #include "Locations.h"
+#include "Logs.h"
 #include "MusicTypes.h"
 #include "NPCs.h"
 #include "ObjectModifications.h"
 #include "Outfits.h"
+#include "Parsers.h"
 #include "Quests.h"
 #include "Races.h"
+#include "Reloads.h"
+#include "Schedulers.h"
+#include "Settings.h"
 #include "Weapons.h"
 #include "Worldspaces.h"
 
+// Every record type reads its configs on its own background thread, so parsing overlaps the game's data loading
+constexpr std::array g_readConfigsFuncs{
+	&ArmorAddons::ReadConfigs,
+	&Armors::ReadConfigs,
+	&Cells::ReadConfigs,
+	&CObjs::ReadConfigs,
+	&DefaultObjectManagers::ReadConfigs,
+	&FormLists::ReadConfigs,
+	&Ingestibles::ReadConfigs,
+	&Keywords::ReadConfigs,
+	&LeveledLists::ReadConfigs,
+	&Locations::ReadConfigs,
+	&MusicTypes::ReadConfigs,
+	&NPCs::ReadConfigs,
+	&ObjectModifications::ReadConfigs,
+	&Outfits::ReadConfigs,
+	&Quests::ReadConfigs,
+	&Races::ReadConfigs,
+	&Weapons::ReadConfigs,
+	&WorldSpaces::ReadConfigs
+};
+
+// Record types patched at kGameDataReady. NPCs prepare their patches on first use and resolve their forms then.
+constexpr std::array g_collectFormsFuncs{
+	&ArmorAddons::CollectForms,
+	&Armors::CollectForms,
+	&Cells::CollectForms,
+	&CObjs::CollectForms,
+	&DefaultObjectManagers::CollectForms,
+	&FormLists::CollectForms,
+	&Ingestibles::CollectForms,
+	&Keywords::CollectForms,
+	&LeveledLists::CollectForms,
+	&Locations::CollectForms,
+	&MusicTypes::CollectForms,
+	&ObjectModifications::CollectForms,
+	&Outfits::CollectForms,
+	&Quests::CollectForms,
+	&Races::CollectForms,
+	&Weapons::CollectForms,
+	&WorldSpaces::CollectForms
+};
+
+// Every record type patches its own forms. Reads name the patched forms a record type references, so it stays ordered
+// against the record types that patch those as it was when they ran one after another. Only ArmorAddons,
+// DefaultObjectManagers and Weapons store nothing but plain fields; every other type edits game-owned arrays, sets full
+// names or calls engine setters and holds kGameHeap, which keeps it on the thread that received kGameDataReady. Only the
+// plain-field types can overlap with the others on a worker. NPCs patch from their hook.
+constexpr std::array g_patchTasks{
+	Schedulers::Task{ "ArmorAddons"sv, &ArmorAddons::Patch, 0, Schedulers::kArmorAddon },
+	Schedulers::Task{ "Armors"sv, &Armors::Patch, Schedulers::kKeyword, Schedulers::kArmor | Schedulers::kGameHeap },
+	Schedulers::Task{ "Cells"sv, &Cells::Patch, 0, Schedulers::kCell | Schedulers::kGameHeap },
+	Schedulers::Task{ "CObjs"sv, &CObjs::Patch, Schedulers::kKeyword, Schedulers::kConstructibleObject | Schedulers::kGameHeap },
+	Schedulers::Task{ "DefaultObjectManagers"sv, &DefaultObjectManagers::Patch, 0, Schedulers::kDefaultObject },
+	Schedulers::Task{ "FormLists"sv, &FormLists::Patch, 0, Schedulers::kFormList | Schedulers::kGameHeap },
+	Schedulers::Task{ "Ingestibles"sv, &Ingestibles::Patch, 0, Schedulers::kIngestible | Schedulers::kGameHeap },
+	Schedulers::Task{ "Keywords"sv, &Keywords::Patch, 0, Schedulers::kKeyword | Schedulers::kGameHeap },
+	Schedulers::Task{ "LeveledLists"sv, &LeveledLists::Patch, Schedulers::kArmor | Schedulers::kIngestible | Schedulers::kWeapon, Schedulers::kLeveledList | Schedulers::kGameHeap },
+	Schedulers::Task{ "Locations"sv, &Locations::Patch, Schedulers::kKeyword, Schedulers::kLocation | Schedulers::kGameHeap },
+	Schedulers::Task{ "MusicTypes"sv, &MusicTypes::Patch, 0, Schedulers::kMusicType | Schedulers::kGameHeap },
+	Schedulers::Task{ "ObjectModifications"sv, &ObjectModifications::Patch, Schedulers::kKeyword, Schedulers::kObjectModification | Schedulers::kGameHeap },
+	Schedulers::Task{ "Outfits"sv, &Outfits::Patch, Schedulers::kArmor | Schedulers::kLeveledList, Schedulers::kOutfit | Schedulers::kGameHeap },
+	Schedulers::Task{ "Quests"sv, &Quests::Patch, 0, Schedulers::kQuest | Schedulers::kGameHeap },
+	Schedulers::Task{ "Races"sv, &Races::Patch, 0, Schedulers::kRace | Schedulers::kGameHeap },
+	Schedulers::Task{ "Weapons"sv, &Weapons::Patch, Schedulers::kLeveledList, Schedulers::kWeapon },
+	Schedulers::Task{ "Worldspaces"sv, &WorldSpaces::Patch, 0, Schedulers::kWorldspace | Schedulers::kGameHeap }
+};
+
+// Record types that can apply config changes while the game is running. NPCs are patched from their hook as they load,
+// so theirs take effect after a restart, as do those of the record types whose patches cannot be read back and undone.
+constexpr std::array g_reloadables{
+	Reloads::Reloadable{ "Armor"sv, &Armors::Reload },
+	Reloads::Reloadable{ "ArmorAddon"sv, &ArmorAddons::Reload },
+	Reloads::Reloadable{ "Cell"sv, &Cells::Reload },
+	Reloads::Reloadable{ "FormList"sv, &FormLists::Reload },
+	Reloads::Reloadable{ "LeveledList"sv, &LeveledLists::Reload },
+	Reloads::Reloadable{ "Location"sv, &Locations::Reload },
+	Reloads::Reloadable{ "Outfit"sv, &Outfits::Reload },
+	Reloads::Reloadable{ "Quest"sv, &Quests::Reload },
+	Reloads::Reloadable{ "Weapon"sv, &Weapons::Reload },
+	Reloads::Reloadable{ "Worldspace"sv, &WorldSpaces::Reload }
+};
+
+std::latch g_readConfigsLatch{ static_cast<std::ptrdiff_t>(g_readConfigsFuncs.size()) };
+std::array<Logs::Buffer, g_readConfigsFuncs.size()> g_readConfigsLogs;
+std::chrono::high_resolution_clock::time_point g_readConfigStart;
+std::atomic<std::chrono::high_resolution_clock::rep> g_readConfigEnd{ 0 };
+
+void StartReadConfigs() {
+	g_readConfigStart = std::chrono::high_resolution_clock::now();
+
+	for (std::size_t ii = 0; ii < g_readConfigsFuncs.size(); ii++) {
+		std::thread([ii]() {
+			{
+				Logs::ScopedCapture capture(g_readConfigsLogs[ii]);
+				g_readConfigsFuncs[ii]();
+			}
+
+			auto readConfigEnd = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+			auto lastReadConfigEnd = g_readConfigEnd.load();
+			while (lastReadConfigEnd < readConfigEnd && !g_readConfigEnd.compare_exchange_weak(lastReadConfigEnd, readConfigEnd)) {}
+
+			g_readConfigsLatch.count_down();
+		}).detach();
+	}
+}
+
+void WaitForReadConfigs() {
+	auto waitStart = std::chrono::high_resolution_clock::now();
+	g_readConfigsLatch.wait();
+	auto waitEnd = std::chrono::high_resolution_clock::now();
+
+	// Logs are written in the fixed record type order, regardless of which thread finished first
+	for (auto& log : g_readConfigsLogs) {
+		Logs::Replay(log);
+		log.clear();
+	}
+
+	std::chrono::high_resolution_clock::time_point readConfigEnd{ std::chrono::high_resolution_clock::duration(g_readConfigEnd.load()) };
+	std::chrono::duration<double> readConfigDuration = readConfigEnd - g_readConfigStart;
+	std::chrono::duration<double> blockedDuration = waitEnd - waitStart;
+	std::chrono::duration<double> hiddenDuration = std::max(readConfigDuration - blockedDuration, std::chrono::duration<double>::zero());
+
+	logger::info("ReadConfig execution time: {} seconds (wall clock), {} seconds hidden behind game data loading", readConfigDuration.count(), hiddenDuration.count());
+}
+
+// The same forms are referenced by many record types, so every reference is gathered first and each distinct form is
+// looked up once. Prepare then reads the resolved form from the reference itself.
+void ResolveForms() {
+	auto resolveStart = std::chrono::high_resolution_clock::now();
+
+	std::vector<Utils::FormReference*> formReferences;
+	for (auto collectForms : g_collectFormsFuncs) {
+		collectForms(formReferences);
+	}
+
+	std::size_t formCount = Utils::ResolveForms(formReferences);
+
+	auto resolveEnd = std::chrono::high_resolution_clock::now();
+	std::chrono::duration<double> resolveDuration = resolveEnd - resolveStart;
+
+	logger::info("ResolveForms execution time: {} seconds, {} references to {} forms", resolveDuration.count(), formReferences.size(), formCount);
+}
+
 void Patch() {
+	WaitForReadConfigs();
+	ResolveForms();
+
 	auto patchStart = std::chrono::high_resolution_clock::now();
 
-	ArmorAddons::Patch();
-	Armors::Patch();
-	Cells::Patch();
-	CObjs::Patch();
-	DefaultObjectManagers::Patch();
-	FormLists::Patch();
-	Ingestibles::Patch();
-	Keywords::Patch();
-	LeveledLists::Patch();
-	Locations::Patch();
-	MusicTypes::Patch();
-	ObjectModifications::Patch();
-	Outfits::Patch();
-	Quests::Patch();
-	Races::Patch();
-	Weapons::Patch();
-	WorldSpaces::Patch();
+	Schedulers::Run(g_patchTasks);
 
 	auto patchEnd = std::chrono::high_resolution_clock::now();
 	std::chrono::duration<double> patchDuration = patchEnd - patchStart;
 
 	logger::info("Patch execution time: {} seconds", patchDuration.count());
+
+	auto conditionCacheStats = Parsers::GetConditionCacheStats();
+	logger::info("Condition results: {} tested, {} reused", conditionCacheStats.Misses, conditionCacheStats.Hits);
+
+	auto formCacheStats = Utils::GetFormCacheStats();
+	logger::info("Form lookups: {} resolved, {} reused", formCacheStats.Misses, formCacheStats.Hits);
+
+	auto pluginIndexStats = Utils::GetPluginIndexStats();
+	logger::info("Plugin index: {} plugins indexed in {} seconds, {} lookups", pluginIndexStats.Plugins, pluginIndexStats.BuildDuration.count(), pluginIndexStats.Lookups);
 }
 
 void OnF4SEMessage(F4SE::MessagingInterface::Message* msg) {
 	switch (msg->type) {
-	case F4SE::MessagingInterface::kGameDataReady:
+	case F4SE::MessagingInterface::kGameDataReady: {
+		// The message can be sent more than once. The configs were released by the first patch, so patching again would
+		// find no patches and restore the original values of every reloadable form.
+		static std::atomic<bool> patched = false;
+		if (patched.exchange(true)) {
+			break;
+		}
+
+		Utils::BindPlugins();
 		Patch();
+		spdlog::default_logger()->flush();
+
+		if (auto pollInterval = Settings::GetReloadPollInterval(); pollInterval.count() > 0) {
+			Reloads::StartWatching(std::vector<Reloads::Reloadable>(g_reloadables.begin(), g_reloadables.end()), pollInterval);
+		}
 		break;
 	}
+	}
 }
 
 extern "C" DLLEXPORT bool F4SEAPI F4SEPlugin_Query(const F4SE::QueryInterface * a_f4se, F4SE::PluginInfo * a_info) {
@@ -65,13 +227,14 @@ extern "C" DLLEXPORT bool F4SEAPI F4SEPlugin_Query(const F4SE::QueryInterface *
 	auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(path->string(), true);
 #endif
 
-	auto log = std::make_shared<spdlog::logger>("Global Log"s, std::move(sink));
+	// Lines are written and flushed in batches on a background thread; everything is flushed once patching is done
+	auto asyncSink = std::make_shared<Logs::AsyncSink>(std::move(sink), 8192);
+	auto log = std::make_shared<spdlog::logger>("Global Log"s, std::make_shared<Logs::CaptureSink>(std::move(asyncSink)));
 
 #ifndef NDEBUG
 	log->set_level(spdlog::level::trace);
 #else
 	log->set_level(spdlog::level::info);
-	log->flush_on(spdlog::level::trace);
 #endif
 
 	spdlog::set_default_logger(std::move(log));
@@ -79,6 +242,15 @@ extern "C" DLLEXPORT bool F4SEAPI F4SEPlugin_Query(const F4SE::QueryInterface *
 
 	logger::info("{} v{}", Version::PROJECT, Version::NAME);
 
+	Settings::Load();
+
+	std::filesystem::path statementLogPath;
+	if (auto logDirectory = logger::log_directory()) {
+		statementLogPath = *logDirectory / fmt::format("{}_Statements.log", Version::PROJECT);
+	}
+
+	Logs::SetStatementLog(Settings::GetStatementLog(), statementLogPath);
+
 	a_info->infoVersion = F4SE::PluginInfo::kVersion;
 	a_info->name = Version::PROJECT.data();
 	a_info->version = Version::MAJOR;
@@ -100,31 +272,7 @@ extern "C" DLLEXPORT bool F4SEAPI F4SEPlugin_Query(const F4SE::QueryInterface *
 extern "C" DLLEXPORT bool F4SEAPI F4SEPlugin_Load(const F4SE::LoadInterface * a_f4se) {
 	F4SE::Init(a_f4se);
 
-	auto readConfigStart = std::chrono::high_resolution_clock::now();
-
-	ArmorAddons::ReadConfigs();
-	Armors::ReadConfigs();
-	Cells::ReadConfigs();
-	CObjs::ReadConfigs();
-	DefaultObjectManagers::ReadConfigs();
-	FormLists::ReadConfigs();
-	Ingestibles::ReadConfigs();
-	Keywords::ReadConfigs();
-	LeveledLists::ReadConfigs();
-	Locations::ReadConfigs();
-	MusicTypes::ReadConfigs();
-	NPCs::ReadConfigs();
-	ObjectModifications::ReadConfigs();
-	Outfits::ReadConfigs();
-	Quests::ReadConfigs();
-	Races::ReadConfigs();
-	Weapons::ReadConfigs();
-	WorldSpaces::ReadConfigs();
-
-	auto readConfigEnd = std::chrono::high_resolution_clock::now();
-	std::chrono::duration<double> readConfigDuration = readConfigEnd - readConfigStart;
-
-	logger::info("ReadConfig execution time: {} seconds", readConfigDuration.count());
+	StartReadConfigs();
 
 	NPCs::Install();
 